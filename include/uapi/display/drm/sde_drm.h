@@ -649,6 +649,17 @@ struct drm_msm_display_hint {
 	__u32 hint_flags;
 };
 
+/**
+ * struct drm_msm_vsync_predict: Payload of DRM_EVENT_VSYNC_PREDICT, sent on
+ *                               every vblank while vblank is enabled
+ * @next_vsync_ns: CLOCK_MONOTONIC time of the next predicted vsync
+ * @period_ns: predicted vsync period
+ */
+struct drm_msm_vsync_predict {
+	__u64 next_vsync_ns;
+	__u64 period_ns;
+};
+
 #define DRM_SDE_WB_CONFIG              0x40
 #define DRM_MSM_REGISTER_EVENT         0x41
 #define DRM_MSM_DEREGISTER_EVENT       0x42
@@ -668,6 +679,7 @@ struct drm_msm_display_hint {
 #define DRM_EVENT_LTM_HIST 0X80000008
 #define DRM_EVENT_LTM_WB_PB 0X80000009
 #define DRM_EVENT_LTM_OFF 0X8000000A
+#define DRM_EVENT_VSYNC_PREDICT 0X8000000B
 
 /* display hint flags*/
 #define DRM_MSM_DISPLAY_EARLY_WAKEUP_HINT         0x01
@@ -127,6 +127,19 @@ static ssize_t debugfs_state_info_read(struct file *file,
 			dsi_ctrl->clk_freq.pix_clk_rate,
 			dsi_ctrl->clk_freq.esc_clk_rate);
 
+	/* Dump command buffer usage */
+	len += snprintf((buf + len), (SZ_4K - len), "\nCmd Buffer Info:\n");
+	len += snprintf((buf + len), (SZ_4K - len),
+			"\tSIZE = %u, ALLOCS = %u, BYTES_USED = %llu\n",
+			dsi_ctrl->cmd_pad_buf_size,
+			dsi_ctrl->cmd_pad_buf_allocs,
+			dsi_ctrl->cmd_pad_bytes);
+	len += snprintf((buf + len), (SZ_4K - len),
+			"\tTX = %u, BUILD_NS = %llu, KICKOFF_NS = %llu\n",
+			dsi_ctrl->cmd_tx_count,
+			dsi_ctrl->cmd_build_ns,
+			dsi_ctrl->cmd_kickoff_ns);
+
 	if (len > count)
 		len = count;
 
@@ -1095,39 +1108,50 @@ error:
 	return rc;
 }
 
-static int dsi_ctrl_copy_and_pad_cmd(struct dsi_ctrl *dsi_ctrl,
-				     const struct mipi_dsi_packet *packet,
-				     u8 **buffer,
-				     u32 *size)
+static int _dsi_ctrl_reserve_cmd_buf_locked(struct dsi_ctrl *dsi_ctrl,
+		u32 size)
 {
-	int rc = 0;
-	u8 *buf = NULL;
-	u32 len, i;
-	u8 cmd_type = 0;
+	u8 *buf;
 
-	len = packet->size;
-	len += 0x3; len &= ~0x03; /* Align to 32 bits */
+	size = ALIGN(size, 4);
+	if (size <= dsi_ctrl->cmd_pad_buf_size)
+		return 0;
 
-	buf = devm_kzalloc(&dsi_ctrl->pdev->dev, len * sizeof(u8), GFP_KERNEL);
+	buf = devm_kzalloc(&dsi_ctrl->pdev->dev, size, GFP_KERNEL);
 	if (!buf)
 		return -ENOMEM;
 
-	for (i = 0; i < len; i++) {
-		if (i >= packet->size)
-			buf[i] = 0xFF;
-		else if (i < sizeof(packet->header))
-			buf[i] = packet->header[i];
-		else
-			buf[i] = packet->payload[i - sizeof(packet->header)];
-	}
+	if (dsi_ctrl->cmd_pad_buf)
+		devm_kfree(&dsi_ctrl->pdev->dev, dsi_ctrl->cmd_pad_buf);
 
-	if (packet->payload_length > 0)
-		buf[3] |= BIT(6);
+	dsi_ctrl->cmd_pad_buf = buf;
+	dsi_ctrl->cmd_pad_buf_size = size;
+	dsi_ctrl->cmd_pad_buf_allocs++;
+
+	return 0;
+}
+
+u32 dsi_ctrl_pack_cmd_packet(const struct mipi_dsi_packet *packet, u8 *buf)
+{
+	u32 len;
+	u8 cmd_type = 0;
+
+	len = packet->size;
+	len += 0x3; len &= ~0x03; /* Align to 32 bits */
 
 	/* Swap BYTE order in the command buffer for MSM */
 	buf[0] = packet->header[1];
 	buf[1] = packet->header[2];
 	buf[2] = packet->header[0];
+	buf[3] = packet->header[3];
+
+	if (packet->payload_length > 0) {
+		memcpy(buf + sizeof(packet->header), packet->payload,
+				packet->payload_length);
+		buf[3] |= BIT(6);
+	}
+
+	memset(buf + packet->size, 0xFF, len - packet->size);
 
 	/* send embedded BTA for read commands */
 	cmd_type = buf[2] & 0x3f;
@@ -1137,12 +1161,70 @@ static int dsi_ctrl_copy_and_pad_cmd(struct dsi_ctrl *dsi_ctrl,
 			(cmd_type == MIPI_DSI_GENERIC_READ_REQUEST_2_PARAM))
 		buf[3] |= BIT(5);
 
-	*buffer = buf;
+	return len;
+}
+
+/*
+ * Set the last cmd bit on the final packet of a run serialized by
+ * dsi_ctrl_pack_cmd_packet, for runs the controller has to kick off
+ * although the panel did not end them with a last command.
+ */
+static void dsi_ctrl_mark_packed_last_cmd(u8 *buf, u32 len)
+{
+	u32 off = 0, next;
+
+	while (off + 4 <= len) {
+		next = off + 4;
+		if (buf[off + 3] & BIT(6))
+			next += ALIGN(buf[off] | (buf[off + 1] << 8), 4);
+		if (next >= len)
+			break;
+		off = next;
+	}
+
+	if (off + 4 <= len)
+		buf[off + 3] |= BIT(7);
+}
+
+static int dsi_ctrl_copy_and_pad_cmd(struct dsi_ctrl *dsi_ctrl,
+				     const struct mipi_dsi_packet *packet,
+				     u8 **buffer,
+				     u32 *size)
+{
+	int rc = 0;
+	u32 len;
+
+	rc = _dsi_ctrl_reserve_cmd_buf_locked(dsi_ctrl, packet->size);
+	if (rc)
+		return rc;
+
+	len = dsi_ctrl_pack_cmd_packet(packet, dsi_ctrl->cmd_pad_buf);
+
+	dsi_ctrl->cmd_pad_bytes += len;
+
+	*buffer = dsi_ctrl->cmd_pad_buf;
 	*size = len;
 
 	return rc;
 }
 
+int dsi_ctrl_reserve_cmd_buf(struct dsi_ctrl *dsi_ctrl, u32 size)
+{
+	int rc;
+
+	if (!dsi_ctrl) {
+		DSI_CTRL_ERR(dsi_ctrl, "Invalid params\n");
+		return -EINVAL;
+	}
+
+	mutex_lock(&dsi_ctrl->ctrl_lock);
+	/* account for the packet header in front of the payload */
+	rc = _dsi_ctrl_reserve_cmd_buf_locked(dsi_ctrl, size + 4);
+	mutex_unlock(&dsi_ctrl->ctrl_lock);
+
+	return rc;
+}
+
 int dsi_ctrl_wait_for_cmd_mode_mdp_idle(struct dsi_ctrl *dsi_ctrl)
 {
 	int rc = 0;
@@ -1540,8 +1622,18 @@ static int dsi_message_tx(struct dsi_ctrl *dsi_ctrl,
 	struct dsi_ctrl_cmd_dma_info cmd_mem;
 	u32 length = 0;
 	u8 *buffer = NULL;
-	u32 cnt = 0;
 	u8 *cmdbuf;
+	ktime_t start, kickoff;
+
+	start = ktime_get();
+
+	/* pre-packed runs of commands can only be fetched from memory */
+	if ((msg->flags & MIPI_DSI_MSG_PACKED) && dsi_ctrl->secure_mode) {
+		DSI_CTRL_ERR(dsi_ctrl,
+			"packed cmds not supported during secure session\n");
+		rc = -ENOTSUPP;
+		goto error;
+	}
 
 	/* Select the tx mode to transfer the command */
 	dsi_message_setup_tx_mode(dsi_ctrl, msg->tx_len, flags);
@@ -1586,6 +1678,13 @@ static int dsi_message_tx(struct dsi_ctrl *dsi_ctrl,
 		goto kickoff;
 	}
 
+	if (msg->flags & MIPI_DSI_MSG_PACKED) {
+		/* already padded and swapped, last cmd bits set by the panel */
+		buffer = (u8 *)msg->tx_buf;
+		length = msg->tx_len;
+		goto packed;
+	}
+
 	rc = mipi_dsi_create_packet(&packet, msg);
 	if (rc) {
 		DSI_CTRL_ERR(dsi_ctrl, "Failed to create message packet, rc=%d\n",
@@ -1602,6 +1701,8 @@ static int dsi_message_tx(struct dsi_ctrl *dsi_ctrl,
 		goto error;
 	}
 
+packed:
+
 	/*
 	 * In case of broadcast CMD length cannot be greater than 512 bytes
 	 * as specified by HW limitations. Need to overwrite the flags to
@@ -1617,8 +1718,9 @@ static int dsi_message_tx(struct dsi_ctrl *dsi_ctrl,
 		}
 	}
 
-	if ((msg->flags & MIPI_DSI_MSG_LASTCOMMAND) ||
-			(*flags & DSI_CTRL_CMD_LAST_COMMAND))
+	if (!(msg->flags & MIPI_DSI_MSG_PACKED) &&
+			((msg->flags & MIPI_DSI_MSG_LASTCOMMAND) ||
+			(*flags & DSI_CTRL_CMD_LAST_COMMAND)))
 		buffer[3] |= BIT(7);//set the last cmd bit in header.
 
 	if (*flags & DSI_CTRL_CMD_FETCH_MEMORY) {
@@ -1634,8 +1736,7 @@ static int dsi_message_tx(struct dsi_ctrl *dsi_ctrl,
 		cmdbuf = (u8 *)(dsi_ctrl->vaddr);
 
 		msm_gem_sync(dsi_ctrl->tx_cmd_buf);
-		for (cnt = 0; cnt < length; cnt++)
-			cmdbuf[dsi_ctrl->cmd_len + cnt] = buffer[cnt];
+		memcpy(cmdbuf + dsi_ctrl->cmd_len, buffer, length);
 
 		dsi_ctrl->cmd_len += length;
 
@@ -1643,6 +1744,10 @@ static int dsi_message_tx(struct dsi_ctrl *dsi_ctrl,
 				!(*flags & DSI_CTRL_CMD_LAST_COMMAND)) {
 			goto error;
 		} else {
+			if (msg->flags & MIPI_DSI_MSG_PACKED)
+				dsi_ctrl_mark_packed_last_cmd(cmdbuf +
+						dsi_ctrl->cmd_len - length,
+						length);
 			cmd_mem.length = dsi_ctrl->cmd_len;
 			dsi_ctrl->cmd_len = 0;
 		}
@@ -1659,10 +1764,18 @@ static int dsi_message_tx(struct dsi_ctrl *dsi_ctrl,
 	}
 
 kickoff:
+	kickoff = ktime_get();
 	dsi_kickoff_msg_tx(dsi_ctrl, msg, &cmd, &cmd_mem, *flags);
+	dsi_ctrl->cmd_tx_count++;
+	dsi_ctrl->cmd_build_ns += ktime_to_ns(ktime_sub(kickoff, start));
+	dsi_ctrl->cmd_kickoff_ns += ktime_to_ns(ktime_sub(ktime_get(),
+			kickoff));
+	return rc;
 error:
-	if (buffer)
-		devm_kfree(&dsi_ctrl->pdev->dev, buffer);
+	/* packet staged in the cmd buffer for a later kickoff */
+	if (!rc)
+		dsi_ctrl->cmd_build_ns += ktime_to_ns(ktime_sub(ktime_get(),
+				start));
 	return rc;
 }
 
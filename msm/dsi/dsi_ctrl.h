@@ -245,6 +245,15 @@ struct dsi_ctrl_interrupts {
  *				which command transfer is successful.
  * @cmd_success_frame:		unsigned integer that indicates the frame at
  *				which command transfer is successful.
+ * @cmd_pad_buf:		Reusable buffer for the padded and byte swapped
+ *				packet of the command being transmitted.
+ * @cmd_pad_buf_size:		Size of cmd_pad_buf in bytes.
+ * @cmd_pad_buf_allocs:		Number of times cmd_pad_buf was (re)allocated.
+ * @cmd_pad_bytes:		Total bytes of packets built in cmd_pad_buf.
+ * @cmd_tx_count:		Number of command DMA kickoffs.
+ * @cmd_build_ns:		Total time spent building and staging packets.
+ * @cmd_kickoff_ns:		Total time spent in kickoff, including the wait
+ *				for DMA done on non deferred transfers.
  */
 struct dsi_ctrl {
 	struct platform_device *pdev;
@@ -311,6 +320,14 @@ struct dsi_ctrl {
 	u32 cmd_trigger_frame;
 	u32 cmd_success_line;
 	u32 cmd_success_frame;
+
+	u8 *cmd_pad_buf;
+	u32 cmd_pad_buf_size;
+	u32 cmd_pad_buf_allocs;
+	u64 cmd_pad_bytes;
+	u32 cmd_tx_count;
+	u64 cmd_build_ns;
+	u64 cmd_kickoff_ns;
 };
 
 /**
@@ -579,6 +596,32 @@ int dsi_ctrl_cmd_transfer(struct dsi_ctrl *dsi_ctrl,
 			  const struct mipi_dsi_msg *msg,
 			  u32 *flags);
 
+/**
+ * dsi_ctrl_reserve_cmd_buf() - Pre-size the command packet buffer
+ * @dsi_ctrl:             DSI controller handle.
+ * @size:                 Largest command payload expected on the link.
+ *
+ * Command packets are padded and byte swapped in a buffer owned by the
+ * controller which grows on demand. Reserving the largest payload up front,
+ * e.g. after the panel command sets have been parsed, keeps the command
+ * transfer path free of allocations.
+ *
+ * Return: error code.
+ */
+int dsi_ctrl_reserve_cmd_buf(struct dsi_ctrl *dsi_ctrl, u32 size);
+
+/**
+ * dsi_ctrl_pack_cmd_packet() - Serialize a packet in DMA buffer format
+ * @packet:               Packet created by mipi_dsi_create_packet().
+ * @buf:                  Destination, at least ALIGN(packet->size, 4) bytes.
+ *
+ * Writes the byte swapped header followed by the payload and pads the
+ * packet to 32 bits, which is the layout fetched by the command DMA.
+ *
+ * Return: number of bytes written.
+ */
+u32 dsi_ctrl_pack_cmd_packet(const struct mipi_dsi_packet *packet, u8 *buf);
+
 /**
  * dsi_ctrl_cmd_tx_trigger() - Trigger a deferred command.
  * @dsi_ctrl:              DSI controller handle.
@@ -363,6 +363,20 @@ struct dsi_cmd_desc {
 	u32  post_wait_ms;
 };
 
+/**
+ * struct dsi_cmd_batch - run of commands sent with a single kickoff
+ * @first:     index of the first cmd of the run in the cmd set
+ * @count:     number of cmds in the run, 0 if the cmd is sent unpacked
+ * @offset:    offset of the run in the packed buffer of the cmd set
+ * @len:       length of the run in the packed buffer in bytes
+ */
+struct dsi_cmd_batch {
+	u32 first;
+	u32 count;
+	u32 offset;
+	u32 len;
+};
+
 /**
  * struct dsi_panel_cmd_set - command set of the panel
  * @type:      type of the command
@@ -370,6 +384,9 @@ struct dsi_cmd_desc {
  * @count:     number of cmds
  * @ctrl_idx:  index of the dsi control
  * @cmds:      arry of cmds
+ * @packed_buf:  cmds serialized as padded and byte swapped DMA packets
+ * @batches:     runs of cmds covering the whole cmd set in order
+ * @batch_count: number of runs in @batches, 0 if the set is not packed
  */
 struct dsi_panel_cmd_set {
 	enum dsi_cmd_set_type type;
@@ -377,6 +394,9 @@ struct dsi_panel_cmd_set {
 	u32 count;
 	u32 ctrl_idx;
 	struct dsi_cmd_desc *cmds;
+	u8 *packed_buf;
+	struct dsi_cmd_batch *batches;
+	u32 batch_count;
 };
 
 /**
@@ -404,6 +404,9 @@ static void dsi_display_aspace_cb_locked(void *cb_data, bool is_detach)
 		display_ctrl->ctrl->secure_mode = is_detach;
 	}
 
+	/* secure sessions fall back to FIFO, which cannot take packed runs */
+	display->panel->packed_cmds_disabled = is_detach;
+
 end:
 	/* release panel_lock */
 	dsi_panel_release_panel_lock(display->panel);
@@ -1844,6 +1847,60 @@ error:
 
 }
 
+static ssize_t debugfs_read_cmd_set_timing(struct file *file,
+				 char __user *user_buf,
+				 size_t user_len,
+				 loff_t *ppos)
+{
+	struct dsi_display *display = file->private_data;
+	char *buf;
+	int len;
+
+	if (!display || !display->panel)
+		return -ENODEV;
+
+	if (*ppos)
+		return 0;
+
+	buf = kzalloc(SZ_4K, GFP_KERNEL);
+	if (!buf)
+		return -ENOMEM;
+
+	len = dsi_panel_print_cmd_stats(display->panel, buf, SZ_4K);
+	if (len < 0)
+		goto error;
+
+	if (len > user_len)
+		len = user_len;
+
+	if (copy_to_user(user_buf, buf, len)) {
+		len = -EFAULT;
+		goto error;
+	}
+
+	*ppos += len;
+
+error:
+	kfree(buf);
+	return len;
+}
+
+static ssize_t debugfs_reset_cmd_set_timing(struct file *file,
+				  const char __user *user_buf,
+				  size_t user_len,
+				  loff_t *ppos)
+{
+	struct dsi_display *display = file->private_data;
+
+	if (!display || !display->panel)
+		return -ENODEV;
+
+	/* any write clears the collected timings */
+	dsi_panel_reset_cmd_stats(display->panel);
+
+	return user_len;
+}
+
 static const struct file_operations dump_info_fops = {
 	.open = simple_open,
 	.read = debugfs_dump_info_read,
@@ -1872,6 +1929,12 @@ static const struct file_operations dsi_command_scheduling_fops = {
 	.read = debugfs_read_cmd_scheduling_params,
 };
 
+static const struct file_operations cmd_set_timing_fops = {
+	.open = simple_open,
+	.write = debugfs_reset_cmd_set_timing,
+	.read = debugfs_read_cmd_set_timing,
+};
+
 static int dsi_display_debugfs_init(struct dsi_display *display)
 {
 	int rc = 0;
@@ -1941,6 +2004,18 @@ static int dsi_display_debugfs_init(struct dsi_display *display)
 		goto error_remove_dir;
 	}
 
+	dump_file = debugfs_create_file("cmd_set_timing",
+					0600,
+					dir,
+					display,
+					&cmd_set_timing_fops);
+	if (IS_ERR_OR_NULL(dump_file)) {
+		rc = PTR_ERR(dump_file);
+		DSI_ERR("[%s] debugfs for cmd set timing file failed, rc=%d\n",
+		       display->name, rc);
+		goto error_remove_dir;
+	}
+
 	misr_data = debugfs_create_file("misr_data",
 					0600,
 					dir,
@@ -7142,6 +7217,19 @@ int dsi_display_get_modes(struct dsi_display *display,
 		}
 	}
 
+	/* size the command packet buffers for the largest panel command */
+	display_for_each_ctrl(i, display) {
+		ctrl = &display->ctrl[i];
+		if (!ctrl->ctrl)
+			continue;
+
+		if (dsi_ctrl_reserve_cmd_buf(ctrl->ctrl,
+				display->panel->max_cmd_len))
+			DSI_WARN("[%s] failed to reserve cmd buffer of %u\n",
+					display->name,
+					display->panel->max_cmd_len);
+	}
+
 exit:
 	*out_modes = display->modes;
 	rc = 0;
@@ -12,6 +12,7 @@
 #include <video/mipi_display.h>
 
 #include "dsi_panel.h"
+#include "dsi_ctrl.h"
 #include "dsi_ctrl_hw.h"
 #include "dsi_parser.h"
 #include "sde_dbg.h"
@@ -37,6 +38,9 @@
 #define HIGH_REFRESH_RATE_THRESHOLD_TIME_US	500
 #define MIN_PREFILL_LINES      40
 
+/* largest run of packed cmds, bounded by the broadcast DMA limit */
+#define DSI_PANEL_PACKED_BATCH_MAX	240
+
 static void dsi_dce_prepare_pps_header(char *buf, u32 pps_delay_ms)
 {
 	char *bp;
@@ -413,26 +417,106 @@ static int dsi_panel_power_off(struct dsi_panel *panel)
 
 	return rc;
 }
+static int dsi_panel_tx_cmd_msg(struct dsi_panel *panel,
+				enum dsi_cmd_set_type type,
+				enum dsi_cmd_set_state state,
+				struct mipi_dsi_msg *msg,
+				bool last_command,
+				u32 post_wait_ms)
+{
+	const struct mipi_dsi_host_ops *ops = panel->host->ops;
+	struct dsi_panel_cmd_stats *stats = &panel->cmd_stats[type];
+	ktime_t start, end;
+	ssize_t len;
+
+	if (state == DSI_CMD_SET_STATE_LP)
+		msg->flags |= MIPI_DSI_MSG_USE_LPM;
+
+	if (last_command)
+		msg->flags |= MIPI_DSI_MSG_LASTCOMMAND;
+
+	if (type == DSI_CMD_SET_VID_TO_CMD_SWITCH)
+		msg->flags |= MIPI_DSI_MSG_ASYNC_OVERRIDE;
+
+	start = ktime_get();
+	len = ops->transfer(panel->host, msg);
+	if (len < 0) {
+		DSI_ERR("failed to set cmds(%d), rc=%zd\n", type, len);
+		return len;
+	}
+
+	end = ktime_get();
+	stats->xfer_ns += ktime_to_ns(ktime_sub(end, start));
+
+	if (post_wait_ms) {
+		usleep_range(post_wait_ms*1000, ((post_wait_ms*1000)+10));
+		stats->wait_ns += ktime_to_ns(ktime_sub(ktime_get(), end));
+	}
+
+	return 0;
+}
+
+static void dsi_panel_update_cmd_stats(struct dsi_panel *panel,
+				       enum dsi_cmd_set_type type,
+				       ktime_t start)
+{
+	struct dsi_panel_cmd_stats *stats = &panel->cmd_stats[type];
+	u64 ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+	u32 idx = 0;
+
+	if (ns >= 500 * NSEC_PER_USEC)
+		idx = min_t(u32, ilog2(div_u64(ns, 500 * NSEC_PER_USEC)) + 1,
+				DSI_PANEL_CMD_HIST_BUCKETS - 1);
+
+	stats->count++;
+	stats->max_ns = max(stats->max_ns, ns);
+	stats->hist[idx]++;
+}
+
+static int dsi_panel_tx_cmd_batch(struct dsi_panel *panel,
+				  struct dsi_panel_cmd_set *set,
+				  struct dsi_cmd_batch *batch)
+{
+	struct dsi_cmd_desc *first = &set->cmds[batch->first];
+	struct dsi_cmd_desc *last = &set->cmds[batch->first + batch->count - 1];
+	struct mipi_dsi_msg msg = {
+		.channel = last->msg.channel,
+		.type = last->msg.type,
+		.flags = first->msg.flags | MIPI_DSI_MSG_PACKED,
+		.ctrl = first->msg.ctrl,
+		.wait_ms = last->msg.wait_ms,
+		.tx_len = batch->len,
+		.tx_buf = set->packed_buf + batch->offset,
+	};
+
+	/* the run is kicked off if it ends at a DT last command */
+	return dsi_panel_tx_cmd_msg(panel, set->type, set->state, &msg,
+			last->last_command, last->post_wait_ms);
+}
+
 static int dsi_panel_tx_cmd_set(struct dsi_panel *panel,
 				enum dsi_cmd_set_type type)
 {
 	int rc = 0, i = 0;
-	ssize_t len;
+	struct dsi_panel_cmd_set *set;
 	struct dsi_cmd_desc *cmds;
+	struct dsi_cmd_batch *batch;
 	u32 count;
 	enum dsi_cmd_set_state state;
 	struct dsi_display_mode *mode;
-	const struct mipi_dsi_host_ops *ops = panel->host->ops;
+	ktime_t start;
 
 	if (!panel || !panel->cur_mode)
 		return -EINVAL;
 
 	mode = panel->cur_mode;
+	start = ktime_get();
 
-	cmds = mode->priv_info->cmd_sets[type].cmds;
-	count = mode->priv_info->cmd_sets[type].count;
-	state = mode->priv_info->cmd_sets[type].state;
-	SDE_EVT32(type, state, count);
+	set = &mode->priv_info->cmd_sets[type];
+	cmds = set->cmds;
+	count = set->count;
+	state = set->state;
+	SDE_EVT32(type, state, count, set->batch_count);
 
 	if (count == 0) {
 		DSI_DEBUG("[%s] No commands to be sent for state(%d)\n",
@@ -440,27 +524,32 @@ static int dsi_panel_tx_cmd_set(struct dsi_panel *panel,
 		goto error;
 	}
 
-	for (i = 0; i < count; i++) {
-		if (state == DSI_CMD_SET_STATE_LP)
-			cmds->msg.flags |= MIPI_DSI_MSG_USE_LPM;
-
-		if (cmds->last_command)
-			cmds->msg.flags |= MIPI_DSI_MSG_LASTCOMMAND;
-
-		if (type == DSI_CMD_SET_VID_TO_CMD_SWITCH)
-			cmds->msg.flags |= MIPI_DSI_MSG_ASYNC_OVERRIDE;
+	if (set->batch_count && !panel->packed_cmds_disabled) {
+		for (i = 0; i < set->batch_count; i++) {
+			batch = &set->batches[i];
+			if (batch->count) {
+				rc = dsi_panel_tx_cmd_batch(panel, set, batch);
+			} else {
+				cmds = &set->cmds[batch->first];
+				rc = dsi_panel_tx_cmd_msg(panel, type, state,
+						&cmds->msg, cmds->last_command,
+						cmds->post_wait_ms);
+			}
+			if (rc)
+				goto error;
+		}
+		goto done;
+	}
 
-		len = ops->transfer(panel->host, &cmds->msg);
-		if (len < 0) {
-			rc = len;
-			DSI_ERR("failed to set cmds(%d), rc=%d\n", type, rc);
+	for (i = 0; i < count; i++) {
+		rc = dsi_panel_tx_cmd_msg(panel, type, state, &cmds->msg,
+				cmds->last_command, cmds->post_wait_ms);
+		if (rc)
 			goto error;
-		}
-		if (cmds->post_wait_ms)
-			usleep_range(cmds->post_wait_ms*1000,
-					((cmds->post_wait_ms*1000)+10));
 		cmds++;
 	}
+done:
+	dsi_panel_update_cmd_stats(panel, type, start);
 error:
 	return rc;
 }
@@ -1785,6 +1874,60 @@ const char *cmd_set_state_map[DSI_CMD_SET_MAX] = {
 	"qcom,mdss-dsi-qsync-off-commands-state",
 };
 
+int dsi_panel_print_cmd_stats(struct dsi_panel *panel, char *buf, u32 size)
+{
+	struct dsi_panel_cmd_stats *stats;
+	const char *name;
+	int len = 0;
+	u32 i, j;
+
+	if (!panel || !buf)
+		return -EINVAL;
+
+	len += scnprintf(buf + len, size - len,
+			"%-40s %8s %10s %10s %10s  %s\n", "cmd set", "count",
+			"xfer_us", "wait_us", "max_us",
+			"<0.5 <1 <2 <4 <8 <16 <32 >=32 ms");
+
+	mutex_lock(&panel->panel_lock);
+	for (i = 0; i < DSI_CMD_SET_MAX; i++) {
+		stats = &panel->cmd_stats[i];
+		if (!stats->count)
+			continue;
+
+		name = cmd_set_prop_map[i];
+		if (strstarts(name, "qcom,"))
+			name += strlen("qcom,");
+		else if (i == DSI_CMD_SET_PPS)
+			name = "pps";
+		else if (i == DSI_CMD_SET_ROI)
+			name = "roi";
+
+		len += scnprintf(buf + len, size - len,
+				"%-40s %8u %10llu %10llu %10llu ", name,
+				stats->count, div_u64(stats->xfer_ns, 1000),
+				div_u64(stats->wait_ns, 1000),
+				div_u64(stats->max_ns, 1000));
+		for (j = 0; j < DSI_PANEL_CMD_HIST_BUCKETS; j++)
+			len += scnprintf(buf + len, size - len, " %u",
+					stats->hist[j]);
+		len += scnprintf(buf + len, size - len, "\n");
+	}
+	mutex_unlock(&panel->panel_lock);
+
+	return len;
+}
+
+void dsi_panel_reset_cmd_stats(struct dsi_panel *panel)
+{
+	if (!panel)
+		return;
+
+	mutex_lock(&panel->panel_lock);
+	memset(panel->cmd_stats, 0, sizeof(panel->cmd_stats));
+	mutex_unlock(&panel->panel_lock);
+}
+
 int dsi_panel_get_cmd_pkt_count(const char *data, u32 length, u32 *cnt)
 {
 	const u32 cmd_set_min_size = 7;
@@ -1854,6 +1997,104 @@ error_free_payloads:
 	return rc;
 }
 
+static bool dsi_panel_cmd_packable(const struct dsi_cmd_desc *cmd)
+{
+	switch (cmd->msg.type) {
+	case MIPI_DSI_DCS_READ:
+	case MIPI_DSI_GENERIC_READ_REQUEST_0_PARAM:
+	case MIPI_DSI_GENERIC_READ_REQUEST_1_PARAM:
+	case MIPI_DSI_GENERIC_READ_REQUEST_2_PARAM:
+		return false;
+	default:
+		break;
+	}
+
+	return ALIGN(cmd->msg.tx_len + 4, 4) <= DSI_PANEL_PACKED_BATCH_MAX;
+}
+
+/*
+ * Serialize the commands of a static cmd set into the layout fetched by the
+ * command DMA so that each run of commands is handed to the host at once.
+ * A run ends at every command the DT marks as last command, which keeps the
+ * kickoff points of the panel DT, and only those commands get the last cmd
+ * bit. Runs also end before a wait, a flag change or the DMA size limit;
+ * such runs are queued by the host until the next last command. Read
+ * commands are kept as unpacked entries and sent one by one.
+ */
+static int dsi_panel_pack_cmd_set(struct dsi_panel_cmd_set *set)
+{
+	struct dsi_cmd_batch *batches, *batch = NULL;
+	struct mipi_dsi_packet packet;
+	struct dsi_cmd_desc *cmd;
+	u32 i, len, size = 0, offset = 0, count = 0;
+	u8 *buf, *tail;
+	int rc = 0;
+
+	if (!set->count || !set->cmds)
+		return 0;
+
+	for (i = 0; i < set->count; i++) {
+		if (dsi_panel_cmd_packable(&set->cmds[i]))
+			size += ALIGN(set->cmds[i].msg.tx_len + 4, 4);
+	}
+
+	if (!size)
+		return 0;
+
+	buf = kzalloc(size, GFP_KERNEL);
+	batches = kcalloc(set->count, sizeof(*batches), GFP_KERNEL);
+	if (!buf || !batches) {
+		rc = -ENOMEM;
+		goto error;
+	}
+
+	for (i = 0; i < set->count; i++) {
+		cmd = &set->cmds[i];
+
+		if (!dsi_panel_cmd_packable(cmd)) {
+			batch = NULL;
+			batches[count++].first = i;
+			continue;
+		}
+
+		rc = mipi_dsi_create_packet(&packet, &cmd->msg);
+		if (rc)
+			goto error;
+
+		len = ALIGN(packet.size, 4);
+		if (batch && ((batch->len + len > DSI_PANEL_PACKED_BATCH_MAX) ||
+			(cmd->msg.flags != set->cmds[batch->first].msg.flags)))
+			batch = NULL;
+
+		if (!batch) {
+			batch = &batches[count++];
+			batch->first = i;
+			batch->offset = offset;
+		}
+
+		tail = buf + offset;
+		offset += dsi_ctrl_pack_cmd_packet(&packet, tail);
+		batch->len += len;
+		batch->count++;
+
+		if (cmd->last_command)
+			tail[3] |= BIT(7);
+
+		if (cmd->last_command || cmd->post_wait_ms)
+			batch = NULL;
+	}
+
+	set->packed_buf = buf;
+	set->batches = batches;
+	set->batch_count = count;
+
+	return 0;
+error:
+	kfree(batches);
+	kfree(buf);
+	return rc;
+}
+
 void dsi_panel_destroy_cmd_packets(struct dsi_panel_cmd_set *set)
 {
 	u32 i = 0;
@@ -1868,6 +2109,11 @@ void dsi_panel_destroy_cmd_packets(struct dsi_panel_cmd_set *set)
 void dsi_panel_dealloc_cmd_packets(struct dsi_panel_cmd_set *set)
 {
 	kfree(set->cmds);
+	kfree(set->packed_buf);
+	kfree(set->batches);
+	set->packed_buf = NULL;
+	set->batches = NULL;
+	set->batch_count = 0;
 }
 
 int dsi_panel_alloc_cmd_packets(struct dsi_panel_cmd_set *cmd,
@@ -1975,8 +2221,15 @@ static int dsi_panel_parse_cmd_sets(
 			set->state = DSI_CMD_SET_STATE_LP;
 		} else {
 			rc = dsi_panel_parse_cmd_sets_sub(set, i, utils);
-			if (rc)
+			if (rc) {
 				DSI_DEBUG("failed to parse set %d\n", i);
+				continue;
+			}
+
+			rc = dsi_panel_pack_cmd_set(set);
+			if (rc)
+				DSI_DEBUG("failed to pack set %d, rc=%d\n",
+						i, rc);
 		}
 	}
 
@@ -1984,6 +2237,21 @@ static int dsi_panel_parse_cmd_sets(
 	return rc;
 }
 
+static u32 dsi_panel_get_cmd_sets_max_len(
+		struct dsi_display_mode_priv_info *priv_info)
+{
+	struct dsi_panel_cmd_set *set;
+	u32 i, j, max_len = 0;
+
+	for (i = DSI_CMD_SET_PRE_ON; i < DSI_CMD_SET_MAX; i++) {
+		set = &priv_info->cmd_sets[i];
+		for (j = 0; j < set->count && set->cmds; j++)
+			max_len = max_t(u32, max_len, set->cmds[j].msg.tx_len);
+	}
+
+	return max_len;
+}
+
 static int dsi_panel_parse_reset_sequence(struct dsi_panel *panel)
 {
 	int rc = 0;
@@ -4102,6 +4370,9 @@ int dsi_panel_get_mode(struct dsi_panel *panel,
 			goto parse_fail;
 		}
 
+		panel->max_cmd_len = max_t(u32, panel->max_cmd_len,
+				dsi_panel_get_cmd_sets_max_len(prv_info));
+
 		rc = dsi_panel_parse_jitter_config(mode, utils);
 		if (rc)
 			DSI_ERR(
@@ -36,6 +36,8 @@
  */
 #define MIPI_DSI_MSG_ASYNC_OVERRIDE BIT(4)
 #define MIPI_DSI_MSG_CMD_DMA_SCHED BIT(5)
+/* tx_buf holds packets already padded and swapped for the DMA buffer */
+#define MIPI_DSI_MSG_PACKED BIT(6)
 
 enum dsi_panel_rotation {
 	DSI_PANEL_ROTATE_NONE = 0,
@@ -189,6 +191,25 @@ struct dsi_tlmm_gpio {
 	const char *name;
 };
 
+#define DSI_PANEL_CMD_HIST_BUCKETS 8
+
+/**
+ * struct dsi_panel_cmd_stats - transmission timing of a command set
+ * @count:     number of times the set was sent
+ * @xfer_ns:   time spent in host transfers, packet build and DMA included
+ * @wait_ns:   time spent sleeping for post command waits
+ * @max_ns:    longest transmission of the set
+ * @hist:      transmissions by duration, first bucket below 500us and
+ *             doubling from there, last bucket open ended
+ */
+struct dsi_panel_cmd_stats {
+	u32 count;
+	u64 xfer_ns;
+	u64 wait_ns;
+	u64 max_ns;
+	u32 hist[DSI_PANEL_CMD_HIST_BUCKETS];
+};
+
 struct dsi_panel;
 
 struct dsi_panel_ops {
@@ -266,6 +287,12 @@ struct dsi_panel {
 	struct dsi_tlmm_gpio *tlmm_gpio;
 	u32 tlmm_gpio_count;
 
+	/* largest command payload across the parsed command sets */
+	u32 max_cmd_len;
+	/* packed cmd sets cannot be sent while the DMA path is unavailable */
+	bool packed_cmds_disabled;
+	struct dsi_panel_cmd_stats cmd_stats[DSI_CMD_SET_MAX];
+
 	struct dsi_panel_ops panel_ops;
 };
 
@@ -402,4 +429,8 @@ int dsi_panel_create_cmd_packets(const char *data, u32 length, u32 count,
 void dsi_panel_destroy_cmd_packets(struct dsi_panel_cmd_set *set);
 
 void dsi_panel_dealloc_cmd_packets(struct dsi_panel_cmd_set *set);
+
+int dsi_panel_print_cmd_stats(struct dsi_panel *panel, char *buf, u32 size);
+
+void dsi_panel_reset_cmd_stats(struct dsi_panel *panel);
 #endif /* _DSI_PANEL_H_ */
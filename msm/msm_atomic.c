@@ -15,6 +15,9 @@
  * You should have received a copy of the GNU General Public License along with
  * this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <linux/completion.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
 #include <drm/drm_panel.h>
 
 #include "msm_drv.h"
@@ -25,13 +28,39 @@
 
 #define MULTIPLE_CONN_DETECTED(x) (x > 1)
 
+struct msm_commit;
+
+/**
+ * struct msm_commit_wait - done wait of one crtc of a split commit
+ * @work: work queued on the display thread of @crtc
+ * @commit: commit the wait belongs to
+ * @crtc: crtc to wait on
+ */
+struct msm_commit_wait {
+	struct kthread_work work;
+	struct msm_commit *commit;
+	struct drm_crtc *crtc;
+};
+
 struct msm_commit {
 	struct drm_device *dev;
 	struct drm_atomic_state *state;
 	uint32_t crtc_mask;
 	uint32_t plane_mask;
 	bool nonblock;
+	bool split;
+	bool queued;
+	bool overlapped;
+	bool serialized;
+	ktime_t start;
+	struct msm_drm_thread *lead_thread;
+	struct msm_drm_thread *retire_thread;
+	atomic_t pending_waits;
+	struct completion waits_done;
+	struct msm_commit_wait waits[MAX_CRTCS];
+	struct kthread_work fence_work;
 	struct kthread_work commit_work;
+	struct kthread_work retire_work;
 };
 
 static inline bool _msm_seamless_for_crtc(struct drm_device *dev,
@@ -150,6 +179,155 @@ static void msm_atomic_wait_for_commit_done(
 	}
 }
 
+static struct msm_drm_thread *_msm_atomic_get_disp_thread(
+		struct msm_drm_private *priv, struct drm_crtc *crtc)
+{
+	int i;
+
+	for (i = 0; i < priv->num_crtcs; i++)
+		if (priv->disp_thread[i].crtc_id == crtc->base.id)
+			return &priv->disp_thread[i];
+
+	return NULL;
+}
+
+/* the commit runs on the display thread of the first crtc of its state */
+static struct msm_drm_thread *_msm_atomic_get_lead_thread(
+		struct msm_drm_private *priv, struct drm_atomic_state *state)
+{
+	struct drm_crtc *crtc;
+	struct drm_crtc_state *crtc_state;
+	struct msm_drm_thread *thread;
+	int i;
+
+	for_each_new_crtc_in_state(state, crtc, crtc_state, i) {
+		thread = _msm_atomic_get_disp_thread(priv, crtc);
+		if (thread)
+			return thread->thread ? thread : NULL;
+	}
+
+	return NULL;
+}
+
+/* done waits of a pipelined commit stay off the display threads */
+static struct msm_drm_thread *_msm_atomic_get_wait_thread(
+		struct msm_commit *c, struct drm_crtc *crtc)
+{
+	struct msm_drm_private *priv = c->dev->dev_private;
+	struct msm_drm_thread *thread;
+
+	thread = _msm_atomic_get_disp_thread(priv, crtc);
+	if (thread && c->retire_thread)
+		thread = &priv->retire_thread[thread - priv->disp_thread];
+
+	return thread;
+}
+
+static void _msm_atomic_wait_for_crtc_done(struct msm_commit *c,
+		struct drm_crtc *crtc, bool split)
+{
+	struct msm_drm_private *priv = c->dev->dev_private;
+	struct msm_kms *kms = priv->kms;
+	struct msm_commit_stats *stats;
+	u64 lat_us;
+	int bucket;
+
+	kms->funcs->wait_for_crtc_commit_done(kms, crtc);
+
+	/* each crtc is only ever completed by one commit at a time */
+	stats = &priv->commit_stats[drm_crtc_index(crtc)];
+	lat_us = ktime_us_delta(ktime_get(), c->start);
+	bucket = min_t(int, fls64(lat_us / USEC_PER_MSEC),
+			MSM_COMMIT_LAT_BUCKETS - 1);
+
+	stats->count++;
+	stats->hist[bucket]++;
+	stats->max_us = max(stats->max_us, lat_us);
+	if (split)
+		stats->split_count++;
+}
+
+/*
+ * The done wait of a crtc tearing down concurrent writeback resets the
+ * writeback encoder of another crtc, so such commits are not split.
+ */
+static bool _msm_atomic_commit_has_wb(struct drm_atomic_state *state)
+{
+	struct drm_connector *connector;
+	struct drm_connector_state *old_conn_state, *new_conn_state;
+	int i;
+
+	for_each_oldnew_connector_in_state(state, connector, old_conn_state,
+			new_conn_state, i)
+		if (connector->connector_type == DRM_MODE_CONNECTOR_VIRTUAL)
+			return true;
+
+	return false;
+}
+
+static void _msm_atomic_commit_wait_work_cb(struct kthread_work *work)
+{
+	struct msm_commit_wait *wait = container_of(work,
+			struct msm_commit_wait, work);
+	struct msm_commit *c = wait->commit;
+
+	SDE_ATRACE_BEGIN("split_commit_wait");
+	_msm_atomic_wait_for_crtc_done(c, wait->crtc, true);
+	SDE_ATRACE_END("split_commit_wait");
+
+	if (atomic_dec_and_test(&c->pending_waits))
+		complete(&c->waits_done);
+}
+
+/*
+ * Wait for the commit to be done on every active crtc. Split commits hand
+ * the wait of each crtc to that crtc's display thread, so displays with
+ * different timings finish independently, and only join here.
+ */
+static void msm_atomic_commit_wait_for_done(struct msm_commit *c)
+{
+	struct drm_atomic_state *state = c->state;
+	struct msm_drm_private *priv = c->dev->dev_private;
+	struct drm_crtc *crtc;
+	struct drm_crtc_state *new_crtc_state;
+	struct msm_drm_thread *thread, *self;
+	unsigned long inline_mask = 0;
+	int i;
+
+	self = c->retire_thread ? c->retire_thread : c->lead_thread;
+
+	/* hold a reference so the barrier can't trip while queueing */
+	atomic_set(&c->pending_waits, 1);
+	reinit_completion(&c->waits_done);
+
+	for_each_new_crtc_in_state(state, crtc, new_crtc_state, i) {
+		struct msm_commit_wait *wait;
+
+		if (!new_crtc_state->active)
+			continue;
+
+		thread = c->split ? _msm_atomic_get_wait_thread(c, crtc) : NULL;
+		if (!thread || !thread->thread || thread == self) {
+			inline_mask |= BIT(i);
+			continue;
+		}
+
+		wait = &c->waits[drm_crtc_index(crtc)];
+		wait->commit = c;
+		wait->crtc = crtc;
+		kthread_init_work(&wait->work, _msm_atomic_commit_wait_work_cb);
+		atomic_inc(&c->pending_waits);
+		kthread_queue_work(&thread->worker, &wait->work);
+	}
+
+	for_each_new_crtc_in_state(state, crtc, new_crtc_state, i)
+		if (inline_mask & BIT(i))
+			_msm_atomic_wait_for_crtc_done(c, crtc, false);
+
+	if (!atomic_dec_and_test(&c->pending_waits))
+		wait_for_completion(&c->waits_done);
+}
+
 static void
 msm_disable_outputs(struct drm_device *dev, struct drm_atomic_state *old_state)
 {
@@ -492,27 +670,14 @@ int msm_atomic_prepare_fb(struct drm_plane *plane,
 	return msm_framebuffer_prepare(new_state->fb, kms->aspace);
 }
 
-/* The (potentially) asynchronous part of the commit.  At this point
- * nothing can fail short of armageddon.
- */
-static void complete_commit(struct msm_commit *c)
+/* Wait for the commit to be done and release what it held */
+static void retire_commit(struct msm_commit *c)
 {
 	struct drm_atomic_state *state = c->state;
 	struct drm_device *dev = state->dev;
 	struct msm_drm_private *priv = dev->dev_private;
 	struct msm_kms *kms = priv->kms;
 
-	drm_atomic_helper_wait_for_fences(dev, state, false);
-
-	kms->funcs->prepare_commit(kms, state);
-
-	msm_atomic_helper_commit_modeset_disables(dev, state);
-
-	drm_atomic_helper_commit_planes(dev, state,
-				DRM_PLANE_COMMIT_ACTIVE_ONLY);
-
-	msm_atomic_helper_commit_modeset_enables(dev, state);
-
 	/* NOTE: _wait_for_vblanks() only waits for vblank on
 	 * enabled CRTCs.  So we end up faulting when disabling
 	 * due to (potentially) unref'ing the outgoing fb's
@@ -526,7 +691,7 @@ static void complete_commit(struct msm_commit *c)
 	 * not be critical path)
 	 */
 
-	msm_atomic_wait_for_commit_done(dev, state);
+	msm_atomic_commit_wait_for_done(c);
 
 	drm_atomic_helper_cleanup_planes(dev, state);
 
@@ -537,6 +702,38 @@ static void complete_commit(struct msm_commit *c)
 	commit_destroy(c);
 }
 
+/* The (potentially) asynchronous part of the commit.  At this point
+ * nothing can fail short of armageddon.
+ */
+static void complete_commit(struct msm_commit *c)
+{
+	struct drm_atomic_state *state = c->state;
+	struct drm_device *dev = state->dev;
+	struct msm_drm_private *priv = dev->dev_private;
+	struct msm_kms *kms = priv->kms;
+
+	drm_atomic_helper_wait_for_fences(dev, state, false);
+
+	kms->funcs->prepare_commit(kms, state);
+
+	msm_atomic_helper_commit_modeset_disables(dev, state);
+
+	drm_atomic_helper_commit_planes(dev, state,
+				DRM_PLANE_COMMIT_ACTIVE_ONLY);
+
+	msm_atomic_helper_commit_modeset_enables(dev, state);
+
+	/*
+	 * With a retire thread the done wait no longer holds the display
+	 * thread, which can wait for the input fences of the next commit
+	 * while this one is in flight.
+	 */
+	if (c->retire_thread)
+		kthread_queue_work(&c->retire_thread->worker, &c->retire_work);
+	else
+		retire_commit(c);
+}
+
 static void _msm_drm_commit_work_cb(struct kthread_work *work)
 {
 	struct msm_commit *commit = NULL;
@@ -553,6 +750,40 @@ static void _msm_drm_commit_work_cb(struct kthread_work *work)
 	SDE_ATRACE_END("complete_commit");
 }
 
+static void _msm_drm_retire_work_cb(struct kthread_work *work)
+{
+	struct msm_commit *commit = container_of(work, struct msm_commit,
+			retire_work);
+
+	SDE_ATRACE_BEGIN("retire_commit");
+	retire_commit(commit);
+	SDE_ATRACE_END("retire_commit");
+}
+
+/*
+ * Wait for the input fences of a commit queued behind the one in flight.
+ * Runs on the display thread of the commit, ahead of its commit work.
+ */
+static void _msm_drm_fence_work_cb(struct kthread_work *work)
+{
+	struct msm_commit *c = container_of(work, struct msm_commit,
+			fence_work);
+	struct msm_drm_private *priv = c->dev->dev_private;
+	struct msm_kms *kms = priv->kms;
+	int ret;
+
+	SDE_ATRACE_BEGIN("commit_pipeline_fences");
+	ret = drm_atomic_helper_wait_for_fences(c->dev, c->state, true);
+	if (!ret && kms->funcs->prewait_input_fences)
+		ret = kms->funcs->prewait_input_fences(kms, c->state);
+	SDE_ATRACE_END("commit_pipeline_fences");
+
+	/* the wait only overlapped if the previous commit is still pending */
+	spin_lock(&priv->pending_crtcs_event.lock);
+	c->overlapped = !ret && (priv->pending_crtcs & c->crtc_mask);
+	spin_unlock(&priv->pending_crtcs_event.lock);
+}
+
 static struct msm_commit *commit_init(struct drm_atomic_state *state,
 	bool nonblock)
 {
@@ -564,8 +795,11 @@ static struct msm_commit *commit_init(struct drm_atomic_state *state,
 	c->dev = state->dev;
 	c->state = state;
 	c->nonblock = nonblock;
+	init_completion(&c->waits_done);
 
+	kthread_init_work(&c->fence_work, _msm_drm_fence_work_cb);
 	kthread_init_work(&c->commit_work, _msm_drm_commit_work_cb);
+	kthread_init_work(&c->retire_work, _msm_drm_retire_work_cb);
 
 	return c;
 }
@@ -583,11 +817,22 @@ static void msm_atomic_commit_dispatch(struct drm_device *dev,
 	/* cache since work will kfree commit in non-blocking case */
 	nonblock = commit->nonblock;
 
+	commit->start = ktime_get();
+	commit->split = priv->split_commit &&
+			hweight32(commit->crtc_mask) > 1 &&
+			!_msm_atomic_commit_has_wb(state);
+
 	for_each_old_crtc_in_state(state, crtc, crtc_state, i) {
 		for (j = 0; j < priv->num_crtcs; j++) {
 			if (priv->disp_thread[j].crtc_id ==
 						crtc->base.id) {
 				if (priv->disp_thread[j].thread) {
+					commit->lead_thread =
+						&priv->disp_thread[j];
+					if (priv->commit_pipeline &&
+					    priv->retire_thread[j].thread)
+						commit->retire_thread =
+						  &priv->retire_thread[j];
 					kthread_queue_work(
 						&priv->disp_thread[j].worker,
 							&commit->commit_work);
@@ -604,10 +849,9 @@ static void msm_atomic_commit_dispatch(struct drm_device *dev,
 			}
 		}
 		/*
-		 * TODO: handle cases where there will be more than
-		 * one crtc per commit cycle. Remove this check then.
-		 * Current assumption is there will be only one crtc
-		 * per commit cycle.
+		 * The commit runs on the thread of its first crtc. With
+		 * split_commit set, the done wait of the other crtcs is
+		 * handed to their own threads from complete_commit.
 		 */
 		if (j < priv->num_crtcs)
 			break;
@@ -628,6 +872,7 @@ static void msm_atomic_commit_dispatch(struct drm_device *dev,
 		complete_commit(commit);
 	} else if (!nonblock) {
 		kthread_flush_work(&commit->commit_work);
+		kthread_flush_work(&commit->retire_work);
 	}
 
 	/* free nonblocking commits in this context, after processing */
@@ -635,6 +880,60 @@ static void msm_atomic_commit_dispatch(struct drm_device *dev,
 		kfree(commit);
 }
 
+/*
+ * Queue the input fence wait of a commit behind the commit in flight on
+ * its crtcs. The wait runs on the display thread of the commit while the
+ * retire thread waits for the previous commit to be done, so neither the
+ * ioctl nor the kickoff of the commit sleeps on fences already signaled
+ * by then. Only one commit can wait behind the in-flight one, further
+ * commits are held back until it got dispatched.
+ */
+static int msm_atomic_commit_pipeline(struct msm_drm_private *priv,
+		struct msm_commit *c)
+{
+	struct msm_drm_thread *thread;
+	int ret;
+
+	if (!priv->commit_pipeline)
+		return 0;
+
+	thread = _msm_atomic_get_lead_thread(priv, c->state);
+	if (!thread)
+		return 0;
+
+	spin_lock(&priv->pending_crtcs_event.lock);
+	ret = wait_event_interruptible_locked(priv->pending_crtcs_event,
+			!(priv->queued_crtcs & c->crtc_mask));
+	if (!ret && (priv->pending_crtcs & c->crtc_mask)) {
+		priv->queued_crtcs |= c->crtc_mask;
+		c->queued = true;
+	}
+	spin_unlock(&priv->pending_crtcs_event.lock);
+
+	/* the commit work is queued behind it on the same thread */
+	if (!ret && c->queued)
+		kthread_queue_work(&thread->worker, &c->fence_work);
+
+	return ret;
+}
+
+/* must be called with pending_crtcs_event.lock held */
+static void _msm_atomic_commit_unqueue_locked(struct msm_drm_private *priv,
+		struct msm_commit *c)
+{
+	if (c->queued) {
+		priv->queued_crtcs &= ~c->crtc_mask;
+		if (c->overlapped)
+			priv->commit_overlapped++;
+		else
+			priv->commit_serialized++;
+		c->queued = false;
+		wake_up_all_locked(&priv->pending_crtcs_event);
+	} else if (c->serialized) {
+		priv->commit_serialized++;
+	}
+}
+
 /**
  * drm_atomic_helper_commit - commit validated state object
  * @dev: DRM device
@@ -700,6 +999,15 @@ int msm_atomic_commit(struct drm_device *dev,
 		c->plane_mask |= (1 << drm_plane_index(plane));
 	}
 
+	/*
+	 * While an earlier commit is still in flight on the same crtcs,
+	 * have the commit thread wait for the input fences now instead of
+	 * after it completes.
+	 */
+	ret = msm_atomic_commit_pipeline(priv, c);
+	if (ret)
+		goto err_unqueue;
+
 	/* Protection for prepare_fence callback */
 retry:
 	ret = drm_modeset_lock(&state->dev->mode_config.connection_mutex,
@@ -717,6 +1025,8 @@ retry:
 
 	/* Start Atomic */
 	spin_lock(&priv->pending_crtcs_event.lock);
+	/* count the commits that had to wait without overlapping */
+	c->serialized = !c->queued && (priv->pending_crtcs & c->crtc_mask);
 	ret = wait_event_interruptible_locked(priv->pending_crtcs_event,
 			!(priv->pending_crtcs & c->crtc_mask) &&
 			!(priv->pending_planes & c->plane_mask));
@@ -724,11 +1034,12 @@ retry:
 		DBG("start: %08x", c->crtc_mask);
 		priv->pending_crtcs |= c->crtc_mask;
 		priv->pending_planes |= c->plane_mask;
+		_msm_atomic_commit_unqueue_locked(priv, c);
 	}
 	spin_unlock(&priv->pending_crtcs_event.lock);
 
 	if (ret)
-		goto err_free;
+		goto err_unqueue;
 
 	WARN_ON(drm_atomic_helper_swap_state(state, false) < 0);
 
@@ -764,7 +1075,14 @@ retry:
 	SDE_ATRACE_END("atomic_commit");
 
 	return 0;
-err_free:
+err_unqueue:
+	if (c->queued) {
+		kthread_cancel_work_sync(&c->fence_work);
+		spin_lock(&priv->pending_crtcs_event.lock);
+		priv->queued_crtcs &= ~c->crtc_mask;
+		wake_up_all_locked(&priv->pending_crtcs_event);
+		spin_unlock(&priv->pending_crtcs_event.lock);
+	}
 	kfree(c);
 error:
 	drm_atomic_helper_cleanup_planes(dev, state);
@@ -830,3 +1148,60 @@ void msm_atomic_commit_tail(struct drm_atomic_state *state)
 
 	drm_atomic_helper_cleanup_planes(dev, state);
 }
+
+#ifdef CONFIG_DEBUG_FS
+static int _msm_atomic_commit_latency_show(struct seq_file *s, void *data)
+{
+	struct msm_drm_private *priv = s->private;
+	struct msm_commit_stats *stats;
+	int i, j;
+
+	for (i = 0; i < priv->num_crtcs; i++) {
+		stats = &priv->commit_stats[i];
+		seq_printf(s, "crtc%d count:%llu split:%llu max_us:%llu hist_ms:",
+				priv->disp_thread[i].crtc_id, stats->count,
+				stats->split_count, stats->max_us);
+		for (j = 0; j < MSM_COMMIT_LAT_BUCKETS; j++)
+			seq_printf(s, " %llu", stats->hist[j]);
+		seq_puts(s, "\n");
+	}
+
+	return 0;
+}
+
+static int _msm_atomic_commit_latency_open(struct inode *inode,
+		struct file *file)
+{
+	return single_open(file, _msm_atomic_commit_latency_show,
+			inode->i_private);
+}
+
+static const struct file_operations msm_atomic_commit_latency_fops = {
+	.open = _msm_atomic_commit_latency_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+void msm_atomic_debugfs_init(struct drm_device *dev, struct dentry *root)
+{
+	struct msm_drm_private *priv = dev->dev_private;
+
+	if (!root)
+		return;
+
+	debugfs_create_bool("split_commit", 0600, root, &priv->split_commit);
+	debugfs_create_bool("commit_pipeline", 0600, root,
+			&priv->commit_pipeline);
+	debugfs_create_u64("commit_overlapped", 0400, root,
+			&priv->commit_overlapped);
+	debugfs_create_u64("commit_serialized", 0400, root,
+			&priv->commit_serialized);
+	debugfs_create_file("commit_latency", 0400, root, priv,
+			&msm_atomic_commit_latency_fops);
+}
+#else
+void msm_atomic_debugfs_init(struct drm_device *dev, struct dentry *root)
+{
+}
+#endif
@@ -49,6 +49,7 @@
 #include "msm_kms.h"
 #include "msm_mmu.h"
 #include "sde_wb.h"
+#include "sde_fence.h"
 #include "sde_dbg.h"
 
 /*
@@ -413,6 +414,12 @@ static int msm_drm_uninit(struct device *dev)
 			kthread_stop(priv->event_thread[i].thread);
 			priv->event_thread[i].thread = NULL;
 		}
+
+		if (priv->retire_thread[i].thread) {
+			kthread_flush_worker(&priv->retire_thread[i].worker);
+			kthread_stop(priv->retire_thread[i].thread);
+			priv->retire_thread[i].thread = NULL;
+		}
 	}
 
 	drm_kms_helper_poll_fini(ddev);
@@ -657,6 +664,27 @@ static int msm_drm_display_thread_create(struct sched_param param,
 			priv->event_thread[i].thread = NULL;
 		}
 
+		/*
+		 * retire thread waits for a commit to be done while the
+		 * display thread prepares the next one, without it commits
+		 * are retired on the display thread
+		 */
+		priv->retire_thread[i].crtc_id = priv->crtcs[i]->base.id;
+		kthread_init_worker(&priv->retire_thread[i].worker);
+		priv->retire_thread[i].dev = ddev;
+		priv->retire_thread[i].thread =
+			kthread_run(kthread_worker_fn,
+				&priv->retire_thread[i].worker,
+				"crtc_retire:%d",
+				priv->retire_thread[i].crtc_id);
+		if (IS_ERR(priv->retire_thread[i].thread)) {
+			dev_warn(dev, "failed to create crtc_retire kthread\n");
+			priv->retire_thread[i].thread = NULL;
+		} else if (sched_setscheduler(priv->retire_thread[i].thread,
+					SCHED_FIFO, &param)) {
+			pr_warn("display retire thread priority update failed\n");
+		}
+
 		if ((!priv->disp_thread[i].thread) ||
 				!priv->event_thread[i].thread) {
 			/* clean up previously created threads if any */
@@ -672,6 +700,12 @@ static int msm_drm_display_thread_create(struct sched_param param,
 						priv->event_thread[i].thread);
 					priv->event_thread[i].thread = NULL;
 				}
+
+				if (priv->retire_thread[i].thread) {
+					kthread_stop(
+						priv->retire_thread[i].thread);
+					priv->retire_thread[i].thread = NULL;
+				}
 			}
 			return -EINVAL;
 		}
@@ -835,6 +869,7 @@ static int msm_drm_component_init(struct device *dev)
 
 	priv->wq = alloc_ordered_workqueue("msm_drm", 0);
 	init_waitqueue_head(&priv->pending_crtcs_event);
+	priv->commit_pipeline = true;
 
 	INIT_LIST_HEAD(&priv->client_event_list);
 	INIT_LIST_HEAD(&priv->inactive_list);
@@ -927,6 +962,8 @@ static int msm_drm_component_init(struct device *dev)
 		goto fail;
 	}
 
+	msm_atomic_debugfs_init(ddev, priv->debug_root);
+
 	/* perform subdriver post initialization */
 	if (kms && kms->funcs && kms->funcs->postinit) {
 		ret = kms->funcs->postinit(kms);
@@ -2230,6 +2267,7 @@ static int __init msm_drm_register(void)
 		return -EINVAL;
 
 	DBG("init");
+	sde_fence_register();
 	sde_rsc_rpmh_register();
 	sde_rsc_register();
 	dsi_display_register();
@@ -2258,6 +2296,7 @@ static void __exit msm_drm_unregister(void)
 	dp_display_unregister();
 	dsi_display_unregister();
 	sde_rsc_unregister();
+	sde_fence_unregister();
 }
 
 module_init(msm_drm_register);
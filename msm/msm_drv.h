@@ -826,6 +826,23 @@ struct msm_drm_thread {
 	struct kthread_worker worker;
 };
 
+#define MSM_COMMIT_LAT_BUCKETS	8
+
+/**
+ * struct msm_commit_stats - commit latency statistics of a crtc
+ * @count: number of commits completed on the crtc
+ * @split_count: number of those that waited on the crtc's own thread
+ * @max_us: longest commit latency, in microseconds
+ * @hist: commit latency histogram, bucket 0 counts commits below 1ms and
+ *        bucket n those within [2^(n-1), 2^n) ms, the last one is open
+ */
+struct msm_commit_stats {
+	u64 count;
+	u64 split_count;
+	u64 max_us;
+	u64 hist[MSM_COMMIT_LAT_BUCKETS];
+};
+
 struct msm_drm_private {
 
 	struct drm_device *dev;
@@ -882,6 +899,21 @@ struct msm_drm_private {
 
 	struct msm_drm_thread disp_thread[MAX_CRTCS];
 	struct msm_drm_thread event_thread[MAX_CRTCS];
+	struct msm_drm_thread retire_thread[MAX_CRTCS];
+
+	/* fan out the done wait of multi crtc commits to each crtc thread */
+	bool split_commit;
+	struct msm_commit_stats commit_stats[MAX_CRTCS];
+
+	/*
+	 * crtcs with a commit waiting behind the one in flight, the commit
+	 * thread waits for its input fences while the retire thread waits
+	 * for the in-flight commit to be done
+	 */
+	uint32_t queued_crtcs;
+	bool commit_pipeline;
+	u64 commit_overlapped;
+	u64 commit_serialized;
 
 	struct task_struct *pp_event_thread;
 	struct kthread_worker pp_event_worker;
@@ -954,6 +986,7 @@ int msm_atomic_prepare_fb(struct drm_plane *plane,
 void msm_atomic_commit_tail(struct drm_atomic_state *state);
 int msm_atomic_commit(struct drm_device *dev,
 	struct drm_atomic_state *state, bool nonblock);
+void msm_atomic_debugfs_init(struct drm_device *dev, struct dentry *root);
 
 /* callback from wq once fence has passed: */
 struct msm_fence_cb {
@@ -995,6 +1028,35 @@ struct msm_gem_address_space *
 msm_gem_smmu_address_space_create(struct drm_device *dev, struct msm_mmu *mmu,
 		const char *name);
 
+/**
+ * msm_gem_map_cache_park: hand the mapped attachment of a freed import to
+ * the aspace, together with the dma-buf reference of the attachment
+ * Return: 0 if parked, or an error if the caller has to release it
+ */
+int msm_gem_map_cache_park(struct msm_gem_address_space *aspace,
+		struct dma_buf_attachment *attach, struct sg_table *sgt);
+
+/**
+ * msm_gem_map_cache_take: take back a parked mapping of a dma-buf, made by
+ * @dev with @attrs. The caller owns the returned attachment and one
+ * reference of the dma-buf. Misses are counted as maps.
+ * Return: mapping of the attachment, or NULL if none is parked
+ */
+struct sg_table *msm_gem_map_cache_take(struct msm_gem_address_space *aspace,
+		struct dma_buf *dmabuf, struct device *dev, unsigned long attrs,
+		struct dma_buf_attachment **attach);
+
+/**
+ * msm_gem_map_cache_flush: unmap all the mappings parked in the aspace
+ */
+void msm_gem_map_cache_flush(struct msm_gem_address_space *aspace);
+
+/**
+ * msm_gem_map_cache_describe: print the mapping cache counters of the aspace
+ */
+void msm_gem_map_cache_describe(struct msm_gem_address_space *aspace,
+		struct seq_file *m);
+
 /**
  * msm_gem_add_obj_to_aspace_active_list: adds obj to active obj list in aspace
  */
@@ -1110,7 +1172,46 @@ struct drm_gem_object *msm_gem_import(struct drm_device *dev,
 __printf(2, 3)
 void msm_gem_object_set_name(struct drm_gem_object *bo, const char *fmt, ...);
 
-int msm_gem_delayed_import(struct drm_gem_object *obj);
+int msm_gem_delayed_import(struct drm_gem_object *obj,
+		struct msm_gem_address_space *aspace);
+
+/**
+ * enum msm_framebuffer_layout_state - fill state of a framebuffer layout
+ * @MSM_FB_LAYOUT_EMPTY: nothing cached yet
+ * @MSM_FB_LAYOUT_FILLING: a caller is filling the layout
+ * @MSM_FB_LAYOUT_VALID: layout can be used
+ */
+enum msm_framebuffer_layout_state {
+	MSM_FB_LAYOUT_EMPTY,
+	MSM_FB_LAYOUT_FILLING,
+	MSM_FB_LAYOUT_VALID,
+};
+
+/**
+ * struct msm_framebuffer_layout - plane layout of a framebuffer, computed
+ *                                 by the kms on first use and kept for the
+ *                                 lifetime of the framebuffer
+ * @state: enum msm_framebuffer_layout_state, written once by the filler
+ * @format: pixel format the layout was computed for
+ * @modifier: format modifier the layout was computed for
+ * @width: width the layout was computed for
+ * @height: height the layout was computed for
+ * @num_planes: number of hw planes
+ * @total_size: size of all the planes in bytes
+ * @plane_size: size of each plane in bytes
+ * @plane_pitch: pitch of each plane in bytes
+ */
+struct msm_framebuffer_layout {
+	u32 state;
+	u32 format;
+	u64 modifier;
+	u32 width;
+	u32 height;
+	u32 num_planes;
+	u32 total_size;
+	u32 plane_size[4];
+	u32 plane_pitch[4];
+};
 
 void msm_framebuffer_set_keepattrs(struct drm_framebuffer *fb, bool enable);
 int msm_framebuffer_prepare(struct drm_framebuffer *fb,
@@ -1122,6 +1223,8 @@ uint32_t msm_framebuffer_iova(struct drm_framebuffer *fb,
 uint32_t msm_framebuffer_phys(struct drm_framebuffer *fb, int plane);
 struct drm_gem_object *msm_framebuffer_bo(struct drm_framebuffer *fb, int plane);
 const struct msm_format *msm_framebuffer_format(struct drm_framebuffer *fb);
+struct msm_framebuffer_layout *msm_framebuffer_layout(
+		struct drm_framebuffer *fb);
 struct drm_framebuffer *msm_framebuffer_init(struct drm_device *dev,
 		const struct drm_mode_fb_cmd2 *mode_cmd,
 		struct drm_gem_object **bos);
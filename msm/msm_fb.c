@@ -31,6 +31,7 @@
 struct msm_framebuffer {
 	struct drm_framebuffer base;
 	const struct msm_format *format;
+	struct msm_framebuffer_layout layout;
 };
 #define to_msm_framebuffer(x) container_of(x, struct msm_framebuffer, base)
 
@@ -197,6 +198,12 @@ const struct msm_format *msm_framebuffer_format(struct drm_framebuffer *fb)
 	return fb ? (to_msm_framebuffer(fb))->format : NULL;
 }
 
+struct msm_framebuffer_layout *msm_framebuffer_layout(
+		struct drm_framebuffer *fb)
+{
+	return fb ? &(to_msm_framebuffer(fb))->layout : NULL;
+}
+
 struct drm_framebuffer *msm_framebuffer_create(struct drm_device *dev,
 		struct drm_file *file, const struct drm_mode_fb_cmd2 *mode_cmd)
 {
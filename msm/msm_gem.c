@@ -472,7 +472,7 @@ static int msm_gem_get_iova_locked(struct drm_gem_object *obj,
 		/* perform delayed import for buffers without existing sgt */
 		if (((msm_obj->flags & MSM_BO_EXTBUF) && !(msm_obj->sgt))
 				|| reattach) {
-			ret = msm_gem_delayed_import(obj);
+			ret = msm_gem_delayed_import(obj, aspace);
 			if (ret) {
 				DRM_ERROR("delayed dma-buf import failed %d\n",
 						ret);
@@ -658,6 +658,9 @@ void msm_gem_aspace_domain_attach_detach_update(
 				mutex_unlock(&msm_obj->lock);
 			}
 		}
+
+		/* parked mappings belong to the domain going away */
+		msm_gem_map_cache_flush(aspace);
 	} else {
 		/* map active buffers */
 		list_for_each_entry(msm_obj, &aspace->active_list, iova_list) {
@@ -1035,7 +1038,11 @@ void msm_gem_free_object(struct drm_gem_object *obj)
 		if (msm_obj->pages)
 			kvfree(msm_obj->pages);
 
-		drm_prime_gem_destroy(obj, msm_obj->sgt);
+		/* keep the mapping in case the buffer gets imported again */
+		if (!msm_obj->sgt || msm_obj->obj_dirty ||
+				msm_gem_map_cache_park(msm_obj->aspace,
+					obj->import_attach, msm_obj->sgt))
+			drm_prime_gem_destroy(obj, msm_obj->sgt);
 	} else {
 		msm_gem_vunmap_locked(obj);
 		put_pages(obj);
@@ -1209,9 +1216,10 @@ struct drm_gem_object *msm_gem_new(struct drm_device *dev,
 	return _msm_gem_new(dev, size, flags, false);
 }
 
-int msm_gem_delayed_import(struct drm_gem_object *obj)
+int msm_gem_delayed_import(struct drm_gem_object *obj,
+		struct msm_gem_address_space *aspace)
 {
-	struct dma_buf_attachment *attach;
+	struct dma_buf_attachment *attach, *parked = NULL;
 	struct sg_table *sgt;
 	struct msm_gem_object *msm_obj;
 	int ret = 0;
@@ -1243,6 +1251,21 @@ int msm_gem_delayed_import(struct drm_gem_object *obj)
 				(DMA_ATTR_IOMMU_USE_UPSTREAM_HINT |
 				DMA_ATTR_IOMMU_USE_LLC_NWA);
 
+	/* reuse the mapping of an earlier import of the same buffer */
+	sgt = msm_gem_map_cache_take(aspace, attach->dmabuf, attach->dev,
+			attach->dma_map_attrs, &parked);
+	if (sgt) {
+		struct dma_buf *dmabuf = attach->dmabuf;
+
+		/* the parked attachment holds its own dma-buf reference */
+		dma_buf_detach(dmabuf, attach);
+		dma_buf_put(dmabuf);
+		obj->import_attach = parked;
+		msm_obj->sgt = sgt;
+		msm_obj->pages = NULL;
+		return 0;
+	}
+
 	/*
 	 * dma_buf_map_attachment will call dma_map_sg for ion buffer
 	 * mapping, and iova will get mapped when the function returns.
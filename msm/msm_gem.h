@@ -51,6 +51,45 @@ struct msm_gem_aspace_ops {
 			void *cb_data);
 };
 
+/* parked dma-buf mappings kept per address space */
+#define MSM_GEM_MAP_CACHE_MAX		8
+/* delay of the check for parked buffers nobody else uses anymore */
+#define MSM_GEM_MAP_CACHE_TRIM_MS	1000
+
+/**
+ * struct msm_gem_map_cache_entry - mapped attachment of a freed import
+ * @list: node in msm_gem_map_cache::lru
+ * @attach: attachment, owned by the cache together with a dma-buf reference
+ * @sgt: mapping of @attach
+ */
+struct msm_gem_map_cache_entry {
+	struct list_head list;
+	struct dma_buf_attachment *attach;
+	struct sg_table *sgt;
+};
+
+/**
+ * struct msm_gem_map_cache - mappings of imported buffers kept after their
+ *                            gem object is freed, so a buffer imported
+ *                            again does not have to be mapped again
+ * @lock: protects the cache
+ * @lru: parked entries, most recently parked first
+ * @trim_work: drops the entries of released buffers while any are parked
+ * @count: number of parked entries
+ * @hits: imports that reused a parked mapping
+ * @maps: imports that had to map the buffer
+ * @unmaps: parked mappings unmapped on eviction or flush
+ */
+struct msm_gem_map_cache {
+	struct mutex lock;
+	struct list_head lru;
+	struct delayed_work trim_work;
+	u32 count;
+	u64 hits;
+	u64 maps;
+	u64 unmaps;
+};
+
 struct aspace_client {
 	void (*cb)(void *cb, bool data);
 	void *cb_data;
@@ -75,6 +114,7 @@ struct msm_gem_address_space {
 	/* list of clients */
 	struct list_head clients;
 	struct mutex list_lock; /* Protects active_list & clients */
+	struct msm_gem_map_cache map_cache;
 };
 
 struct msm_gem_vma {
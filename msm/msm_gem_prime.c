@@ -94,9 +94,10 @@ struct drm_gem_object *msm_gem_prime_import(struct drm_device *dev,
 	unsigned long flags = 0;
 	struct msm_drm_private *priv;
 	struct msm_kms *kms;
+	struct msm_gem_address_space *aspace;
 	int ret;
 	bool lazy_unmap = true;
-	u32 domain;
+	u32 domain = MSM_SMMU_DOMAIN_UNSECURE;
 
 	if (!dma_buf || !dev->dev_private)
 		return ERR_PTR(-EINVAL);
@@ -163,6 +164,20 @@ struct drm_gem_object *msm_gem_prime_import(struct drm_device *dev,
 		attach_dev = dev->dev;
 	}
 
+	/* reuse the mapping of an earlier import of the same buffer */
+	if (lazy_unmap && (flags & ION_FLAG_CACHED) &&
+			kms->funcs->get_address_space) {
+		aspace = kms->funcs->get_address_space(kms, domain);
+		sgt = msm_gem_map_cache_take(aspace, dma_buf, attach_dev,
+				DMA_ATTR_IOMMU_USE_LLC_NWA |
+				DMA_ATTR_DELAYED_UNMAP, &attach);
+		if (sgt) {
+			/* the parked attachment holds its own reference */
+			dma_buf_put(dma_buf);
+			goto import;
+		}
+	}
+
 	attach = dma_buf_attach(dma_buf, attach_dev);
 	if (IS_ERR(attach)) {
 		DRM_ERROR("dma_buf_attach failure, err=%ld\n", PTR_ERR(attach));
@@ -188,6 +203,7 @@ struct drm_gem_object *msm_gem_prime_import(struct drm_device *dev,
 		}
 	}
 
+import:
 	/*
 	 * If importing a NULL sg table (i.e. for uncached buffers),
 	 * create a drm gem object with only the dma buf attachment.
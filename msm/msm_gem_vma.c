@@ -16,9 +16,15 @@
  * this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <linux/dma-buf.h>
+#include <linux/seq_file.h>
+
 #include "msm_drv.h"
 #include "msm_gem.h"
 #include "msm_mmu.h"
+#include "sde_dbg.h"
+
+static void _msm_gem_map_cache_trim_work(struct work_struct *work);
 
 /* SDE address space operations */
 static void smmu_aspace_unmap_vma(struct msm_gem_address_space *aspace,
@@ -187,6 +193,10 @@ msm_gem_smmu_address_space_create(struct drm_device *dev, struct msm_mmu *mmu,
 	INIT_LIST_HEAD(&aspace->clients);
 	kref_init(&aspace->kref);
 	mutex_init(&aspace->list_lock);
+	mutex_init(&aspace->map_cache.lock);
+	INIT_LIST_HEAD(&aspace->map_cache.lru);
+	INIT_DELAYED_WORK(&aspace->map_cache.trim_work,
+			_msm_gem_map_cache_trim_work);
 
 	return aspace;
 }
@@ -197,6 +207,8 @@ msm_gem_address_space_destroy(struct kref *kref)
 	struct msm_gem_address_space *aspace = container_of(kref,
 			struct msm_gem_address_space, kref);
 
+	cancel_delayed_work_sync(&aspace->map_cache.trim_work);
+	msm_gem_map_cache_flush(aspace);
 	drm_mm_takedown(&aspace->mm);
 	if (aspace->mmu)
 		aspace->mmu->funcs->destroy(aspace->mmu);
@@ -210,6 +222,181 @@ void msm_gem_address_space_put(struct msm_gem_address_space *aspace)
 		kref_put(&aspace->kref, msm_gem_address_space_destroy);
 }
 
+static void _msm_gem_map_cache_release(struct list_head *list)
+{
+	struct msm_gem_map_cache_entry *entry, *tmp;
+	struct dma_buf *dmabuf;
+
+	list_for_each_entry_safe(entry, tmp, list, list) {
+		dmabuf = entry->attach->dmabuf;
+
+		SDE_EVT32(entry->sgt->sgl->dma_address,
+				file_count(dmabuf->file));
+		dma_buf_unmap_attachment(entry->attach, entry->sgt,
+				DMA_BIDIRECTIONAL);
+		dma_buf_detach(dmabuf, entry->attach);
+		dma_buf_put(dmabuf);
+
+		list_del(&entry->list);
+		kfree(entry);
+	}
+}
+
+/* Called with map_cache.lock held, moves the entries to drop to @evict */
+static void _msm_gem_map_cache_trim(struct msm_gem_map_cache *cache,
+		u32 max, struct list_head *evict)
+{
+	struct msm_gem_map_cache_entry *entry, *tmp;
+
+	/* the cache holds the last reference of buffers nobody uses anymore */
+	list_for_each_entry_safe(entry, tmp, &cache->lru, list) {
+		if (file_count(entry->attach->dmabuf->file) > 1)
+			continue;
+
+		list_move_tail(&entry->list, evict);
+		cache->count--;
+		cache->unmaps++;
+	}
+
+	while (cache->count > max) {
+		entry = list_last_entry(&cache->lru,
+				struct msm_gem_map_cache_entry, list);
+		list_move_tail(&entry->list, evict);
+		cache->count--;
+		cache->unmaps++;
+	}
+}
+
+static void _msm_gem_map_cache_trim_work(struct work_struct *work)
+{
+	struct msm_gem_map_cache *cache = container_of(to_delayed_work(work),
+			struct msm_gem_map_cache, trim_work);
+	LIST_HEAD(evict);
+	bool rearm;
+
+	mutex_lock(&cache->lock);
+	_msm_gem_map_cache_trim(cache, MSM_GEM_MAP_CACHE_MAX, &evict);
+	rearm = cache->count;
+	mutex_unlock(&cache->lock);
+
+	_msm_gem_map_cache_release(&evict);
+
+	if (rearm)
+		schedule_delayed_work(&cache->trim_work,
+				msecs_to_jiffies(MSM_GEM_MAP_CACHE_TRIM_MS));
+}
+
+int msm_gem_map_cache_park(struct msm_gem_address_space *aspace,
+		struct dma_buf_attachment *attach, struct sg_table *sgt)
+{
+	struct msm_gem_map_cache *cache;
+	struct msm_gem_map_cache_entry *entry;
+	LIST_HEAD(evict);
+
+	if (!aspace || !aspace->domain_attached || !attach || !sgt ||
+			attach->dev != msm_gem_get_aspace_device(aspace))
+		return -EINVAL;
+
+	entry = kzalloc(sizeof(*entry), GFP_KERNEL);
+	if (!entry)
+		return -ENOMEM;
+
+	entry->attach = attach;
+	entry->sgt = sgt;
+
+	cache = &aspace->map_cache;
+	mutex_lock(&cache->lock);
+	list_add(&entry->list, &cache->lru);
+	cache->count++;
+	_msm_gem_map_cache_trim(cache, MSM_GEM_MAP_CACHE_MAX, &evict);
+	mutex_unlock(&cache->lock);
+
+	_msm_gem_map_cache_release(&evict);
+
+	/* parked buffers released later are dropped without another park */
+	schedule_delayed_work(&cache->trim_work,
+			msecs_to_jiffies(MSM_GEM_MAP_CACHE_TRIM_MS));
+
+	return 0;
+}
+
+struct sg_table *msm_gem_map_cache_take(struct msm_gem_address_space *aspace,
+		struct dma_buf *dmabuf, struct device *dev, unsigned long attrs,
+		struct dma_buf_attachment **attach)
+{
+	struct msm_gem_map_cache *cache;
+	struct msm_gem_map_cache_entry *entry, *found = NULL;
+	struct sg_table *sgt = NULL;
+	LIST_HEAD(evict);
+
+	if (!aspace || !dmabuf || !attach ||
+			dev != msm_gem_get_aspace_device(aspace))
+		return NULL;
+
+	cache = &aspace->map_cache;
+	mutex_lock(&cache->lock);
+	list_for_each_entry(entry, &cache->lru, list) {
+		if (entry->attach->dmabuf == dmabuf &&
+				entry->attach->dev == dev &&
+				entry->attach->dma_map_attrs == attrs) {
+			found = entry;
+			break;
+		}
+	}
+
+	if (found) {
+		list_del(&found->list);
+		cache->count--;
+		cache->hits++;
+	} else {
+		cache->maps++;
+	}
+	_msm_gem_map_cache_trim(cache, MSM_GEM_MAP_CACHE_MAX, &evict);
+	mutex_unlock(&cache->lock);
+
+	_msm_gem_map_cache_release(&evict);
+
+	if (found) {
+		*attach = found->attach;
+		sgt = found->sgt;
+		kfree(found);
+	}
+
+	return sgt;
+}
+
+void msm_gem_map_cache_flush(struct msm_gem_address_space *aspace)
+{
+	struct msm_gem_map_cache *cache;
+	LIST_HEAD(evict);
+
+	if (!aspace)
+		return;
+
+	cache = &aspace->map_cache;
+	mutex_lock(&cache->lock);
+	_msm_gem_map_cache_trim(cache, 0, &evict);
+	mutex_unlock(&cache->lock);
+
+	_msm_gem_map_cache_release(&evict);
+}
+
+void msm_gem_map_cache_describe(struct msm_gem_address_space *aspace,
+		struct seq_file *m)
+{
+	struct msm_gem_map_cache *cache;
+
+	if (!aspace)
+		return;
+
+	cache = &aspace->map_cache;
+	mutex_lock(&cache->lock);
+	seq_printf(m, "%s: parked %u/%u hits %llu maps %llu unmaps %llu\n",
+			aspace->name, cache->count, MSM_GEM_MAP_CACHE_MAX,
+			cache->hits, cache->maps, cache->unmaps);
+	mutex_unlock(&cache->lock);
+}
+
 /* GPU address space operations */
 static void iommu_aspace_unmap_vma(struct msm_gem_address_space *aspace,
 		struct msm_gem_vma *vma, struct sg_table *sgt,
@@ -307,6 +494,10 @@ msm_gem_address_space_create(struct device *dev, struct iommu_domain *domain,
 		size >> PAGE_SHIFT);
 
 	kref_init(&aspace->kref);
+	mutex_init(&aspace->map_cache.lock);
+	INIT_LIST_HEAD(&aspace->map_cache.lru);
+	INIT_DELAYED_WORK(&aspace->map_cache.trim_work,
+			_msm_gem_map_cache_trim_work);
 
 	return aspace;
 }
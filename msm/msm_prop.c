@@ -14,6 +14,10 @@ void msm_property_init(struct msm_property_info *info,
 		uint32_t blob_count,
 		uint32_t state_size)
 {
+	BUILD_BUG_ON(PLANE_PROP_COUNT > MSM_PROP_MAX_COUNT);
+	BUILD_BUG_ON(CRTC_PROP_COUNT > MSM_PROP_MAX_COUNT);
+	BUILD_BUG_ON(CONNECTOR_PROP_COUNT > MSM_PROP_MAX_COUNT);
+
 	/* prevent access if any of these are NULL */
 	if (!base || !dev || !property_array || !property_data) {
 		property_count = 0;
@@ -23,6 +27,13 @@ void msm_property_init(struct msm_property_info *info,
 		return;
 	}
 
+	/* dirty bitmaps of the states are sized at build time */
+	if (property_count > MSM_PROP_MAX_COUNT) {
+		DRM_ERROR("too many properties %u, capping to %d\n",
+				property_count, MSM_PROP_MAX_COUNT);
+		property_count = MSM_PROP_MAX_COUNT;
+	}
+
 	/* can't have more blob properties than total properties */
 	if (blob_count > property_count) {
 		blob_count = property_count;
@@ -69,7 +80,6 @@ void msm_property_destroy(struct msm_property_info *info)
 int msm_property_pop_dirty(struct msm_property_info *info,
 		struct msm_property_state *property_state)
 {
-	struct list_head *item;
 	int rc = 0;
 
 	if (!info || !property_state || !property_state->values) {
@@ -79,23 +89,36 @@ int msm_property_pop_dirty(struct msm_property_info *info,
 
 	WARN_ON(!mutex_is_locked(&info->property_lock));
 
-	if (list_empty(&property_state->dirty_list)) {
+	rc = find_first_bit(property_state->dirty, info->property_count);
+	if (rc >= info->property_count) {
 		rc = -EAGAIN;
 	} else {
-		item = property_state->dirty_list.next;
-		list_del_init(item);
-		rc = container_of(item, struct msm_property_value, dirty_node)
-			- property_state->values;
+		__clear_bit(rc, property_state->dirty);
 		DRM_DEBUG_KMS("property %d dirty\n", rc);
 	}
 
 	return rc;
 }
 
+int msm_property_pop_all_dirty(struct msm_property_info *info,
+		struct msm_property_state *property_state,
+		unsigned long *dirty)
+{
+	if (!info || !property_state || !property_state->values || !dirty) {
+		DRM_ERROR("invalid argument(s)\n");
+		return -EINVAL;
+	}
+
+	bitmap_copy(dirty, property_state->dirty, MSM_PROP_MAX_COUNT);
+	bitmap_zero(property_state->dirty, MSM_PROP_MAX_COUNT);
+
+	return bitmap_weight(dirty, info->property_count);
+}
+
 /**
  * _msm_property_set_dirty_no_lock - flag given property as being dirty
  *                                   This function doesn't mutex protect the
- *                                   dirty linked list.
+ *                                   property values.
  * @info: Pointer to property info container struct
  * @property_state: Pointer to property state container struct
  * @property_idx: Property index
@@ -111,14 +134,8 @@ static void _msm_property_set_dirty_no_lock(
 		return;
 	}
 
-	/* avoid re-inserting if already dirty */
-	if (!list_empty(&property_state->values[property_idx].dirty_node)) {
+	if (__test_and_set_bit(property_idx, property_state->dirty))
 		DRM_DEBUG_KMS("property %u already dirty\n", property_idx);
-		return;
-	}
-
-	list_add_tail(&property_state->values[property_idx].dirty_node,
-			&property_state->dirty_list);
 }
 
 bool msm_property_is_dirty(
@@ -132,7 +149,7 @@ bool msm_property_is_dirty(
 		return false;
 	}
 
-	return !list_empty(&property_state->values[property_idx].dirty_node);
+	return test_bit(property_idx, property_state->dirty);
 }
 
 /**
@@ -496,7 +513,7 @@ void msm_property_reset_state(struct msm_property_info *info, void *state,
 	if (property_state) {
 		property_state->property_count = info->property_count;
 		property_state->values = property_values;
-		INIT_LIST_HEAD(&property_state->dirty_list);
+		bitmap_zero(property_state->dirty, MSM_PROP_MAX_COUNT);
 	}
 
 	/*
@@ -508,7 +525,6 @@ void msm_property_reset_state(struct msm_property_info *info, void *state,
 			property_values[i].value =
 				info->property_data[i].default_value;
 			property_values[i].blob = NULL;
-			INIT_LIST_HEAD(&property_values[i].dirty_node);
 		}
 }
 
@@ -529,17 +545,15 @@ void msm_property_duplicate_state(struct msm_property_info *info,
 	if (!property_state)
 		return;
 
-	INIT_LIST_HEAD(&property_state->dirty_list);
+	bitmap_zero(property_state->dirty, MSM_PROP_MAX_COUNT);
 	property_state->values = property_values;
 
 	if (property_state->values)
-		/* add ref count for blobs and initialize dirty nodes */
-		for (i = 0; i < info->property_count; ++i) {
+		/* add ref count for blobs */
+		for (i = 0; i < info->property_count; ++i)
 			if (property_state->values[i].blob)
 				drm_property_blob_get(
 						property_state->values[i].blob);
-			INIT_LIST_HEAD(&property_state->values[i].dirty_node);
-		}
 }
 
 void msm_property_destroy_state(struct msm_property_info *info, void *state,
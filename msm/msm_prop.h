@@ -6,11 +6,15 @@
 #ifndef _MSM_PROP_H_
 #define _MSM_PROP_H_
 
+#include <linux/bitmap.h>
 #include <linux/list.h>
 #include "msm_drv.h"
 
 #define MSM_PROP_STATE_CACHE_SIZE	2
 
+/* upper bound of the property count of any drm object */
+#define MSM_PROP_MAX_COUNT		64
+
 /**
  * struct msm_property_data - opaque structure for tracking per
  *                            drm-object per property stuff
@@ -28,12 +32,10 @@ struct msm_property_data {
  *                             drm-object per property stuff
  * @value: Current property value for this drm object
  * @blob: Pointer to associated blob data, if available
- * @dirty_node: Linked list node to track if property is dirty or not
  */
 struct msm_property_value {
 	uint64_t value;
 	struct drm_property_blob *blob;
-	struct list_head dirty_node;
 };
 
 /**
@@ -78,13 +80,13 @@ struct msm_property_info {
  * struct msm_property_state - Structure for local property state information
  * @property_count: Total number of properties
  * @values: Pointer to array of msm_property_value objects
- * @dirty_list: List of all properties that have been 'atomic_set' but not
- *              yet cleared with 'msm_property_pop_dirty'
+ * @dirty: Bitmap of all properties that have been 'atomic_set' but not
+ *         yet cleared with 'msm_property_pop_dirty'
  */
 struct msm_property_state {
 	uint32_t property_count;
 	struct msm_property_value *values;
-	struct list_head dirty_list;
+	DECLARE_BITMAP(dirty, MSM_PROP_MAX_COUNT);
 };
 
 /**
@@ -175,6 +177,19 @@ bool msm_property_get_is_active(struct msm_property_info *info)
 int msm_property_pop_dirty(struct msm_property_info *info,
 		struct msm_property_state *property_state);
 
+/**
+ * msm_property_pop_all_dirty - fetch and clear all dirty properties at once
+ *	The dirty bitmap belongs to the property state, so this doesn't need
+ *	the property lock as long as the caller owns the state.
+ * @info: Pointer to property info container struct
+ * @property_state: Pointer to property state container struct
+ * @dirty: Bitmap of MSM_PROP_MAX_COUNT bits receiving the dirty properties
+ * Returns: Number of dirty properties, or -EINVAL on error
+ */
+int msm_property_pop_all_dirty(struct msm_property_info *info,
+		struct msm_property_state *property_state,
+		unsigned long *dirty);
+
 /**
  * msm_property_init - initialize property info structure
  * @info: Pointer to property info container struct
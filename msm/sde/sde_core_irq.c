@@ -6,13 +6,107 @@
 #define pr_fmt(fmt)	"[drm:%s:%d] " fmt, __func__, __LINE__
 
 #include <linux/debugfs.h>
+#include <linux/delay.h>
+#include <linux/hrtimer.h>
 #include <linux/irqdomain.h>
 #include <linux/irq.h>
 #include <linux/kthread.h>
+#include <linux/rculist.h>
 
 #include "sde_core_irq.h"
 #include "sde_power_handle.h"
 
+/**
+ * _sde_core_irq_account_latency - account a latency sample in a histogram
+ * @lat:		Pointer to latency statistics
+ * @start:		time at which the measured interval started
+ *
+ * Called from the dispatcher, which serializes all interrupts through the
+ * hw interrupt lock, so the statistics need no further protection.
+ */
+static void _sde_core_irq_account_latency(struct sde_irq_latency *lat,
+		ktime_t start)
+{
+	u32 delta_ns = (u32)ktime_to_ns(ktime_sub(ktime_get(), start));
+	u32 bucket;
+
+	lat->total_ns += delta_ns;
+	lat->max_ns = max(lat->max_ns, delta_ns);
+
+	bucket = fls(delta_ns / NSEC_PER_USEC);
+	if (bucket >= SDE_IRQ_LATENCY_BUCKETS)
+		bucket = SDE_IRQ_LATENCY_BUCKETS - 1;
+	lat->buckets[bucket]++;
+}
+
+/**
+ * _sde_core_irq_update_latency - account callback latency of an irq_idx
+ * @irq_obj:		Pointer to irq object
+ * @irq_idx:		interrupt index
+ * @start:		time at which the callbacks were started
+ */
+static void _sde_core_irq_update_latency(struct sde_irq *irq_obj,
+		int irq_idx, ktime_t start)
+{
+	_sde_core_irq_account_latency(&irq_obj->irq_latency[irq_idx], start);
+}
+
+/**
+ * _sde_core_irq_call_fast - call the fast path handler of an irq_idx
+ * @irq_obj:		Pointer to irq object
+ * @irq_idx:		interrupt index
+ * Returns: true if a fast path handler was called
+ *
+ * Fast path handlers are cleared with WRITE_ONCE and the remover waits for
+ * the dispatch to finish, so a single READ_ONCE is all the protection the
+ * dispatcher needs.
+ */
+static bool _sde_core_irq_call_fast(struct sde_irq *irq_obj, int irq_idx)
+{
+	struct sde_irq_fast *fast;
+	struct sde_irq_callback *cb;
+
+	if (!irq_obj->irq_fast)
+		return false;
+
+	fast = &irq_obj->irq_fast[irq_idx];
+	cb = READ_ONCE(fast->cb);
+	if (!cb)
+		return false;
+
+	cb->func(cb->arg, irq_idx);
+
+	fast->count++;
+	_sde_core_irq_account_latency(&fast->latency, irq_obj->irq_ts);
+
+	return true;
+}
+
+/**
+ * _sde_core_irq_call_callbacks - call the callbacks listed for an irq_idx
+ * @irq_obj:		Pointer to irq object
+ * @irq_idx:		interrupt index
+ * Returns: true if the callback list was not empty
+ *
+ * The callback lists are rcu protected, writers wait for the dispatch to
+ * complete before a removed callback can be reused.
+ */
+static bool _sde_core_irq_call_callbacks(struct sde_irq *irq_obj, int irq_idx)
+{
+	struct sde_irq_callback *cb;
+	bool called = false;
+
+	rcu_read_lock();
+	list_for_each_entry_rcu(cb, &irq_obj->irq_cb_tbl[irq_idx], list) {
+		if (cb->func)
+			cb->func(cb->arg, irq_idx);
+		called = true;
+	}
+	rcu_read_unlock();
+
+	return called;
+}
+
 /**
  * sde_core_irq_callback_handler - dispatch core interrupts
  * @arg:		private data of callback handler
@@ -22,32 +116,29 @@ static void sde_core_irq_callback_handler(void *arg, int irq_idx)
 {
 	struct sde_kms *sde_kms = arg;
 	struct sde_irq *irq_obj = &sde_kms->irq_obj;
-	struct sde_irq_callback *cb;
-	unsigned long irq_flags;
-	bool cb_tbl_error = false;
+	bool cb_tbl_error = true;
 	int enable_counts = 0;
+	ktime_t start = ktime_get();
 
 	pr_debug("irq_idx=%d\n", irq_idx);
 
-	spin_lock_irqsave(&sde_kms->irq_obj.cb_lock, irq_flags);
-	if (list_empty(&irq_obj->irq_cb_tbl[irq_idx])) {
-		/* print error outside lock */
-		cb_tbl_error = true;
-		enable_counts = atomic_read(
-				&sde_kms->irq_obj.enable_counts[irq_idx]);
-	}
-
 	atomic_inc(&irq_obj->irq_counts[irq_idx]);
 
-	/*
-	 * Perform registered function callback
-	 */
-	list_for_each_entry(cb, &irq_obj->irq_cb_tbl[irq_idx], list)
-		if (cb->func)
-			cb->func(cb->arg, irq_idx);
-	spin_unlock_irqrestore(&sde_kms->irq_obj.cb_lock, irq_flags);
+	if (_sde_core_irq_call_fast(irq_obj, irq_idx))
+		cb_tbl_error = false;
+
+	/* Perform registered function callback */
+	if ((cb_tbl_error || !list_empty(&irq_obj->irq_cb_tbl[irq_idx])) &&
+			_sde_core_irq_call_callbacks(irq_obj, irq_idx))
+		cb_tbl_error = false;
+
+	if (irq_obj->irq_latency)
+		_sde_core_irq_update_latency(irq_obj, irq_idx, start);
 
 	if (cb_tbl_error) {
+		enable_counts = atomic_read(
+				&sde_kms->irq_obj.enable_counts[irq_idx]);
+
 		/*
 		 * If enable count is zero and callback list is empty, then it's
 		 * not a fatal issue. Log this case as debug. If the enable
@@ -88,6 +179,11 @@ int sde_core_irq_idx_lookup(struct sde_kms *sde_kms,
 			instance_idx);
 }
 
+static bool _sde_core_irq_has_fast(struct sde_irq *irq_obj, int irq_idx)
+{
+	return irq_obj->irq_fast && READ_ONCE(irq_obj->irq_fast[irq_idx].cb);
+}
+
 /**
  * _sde_core_irq_enable - enable core interrupt given by the index
  * @sde_kms:		Pointer to sde kms context
@@ -119,7 +215,9 @@ static int _sde_core_irq_enable(struct sde_kms *sde_kms, int irq_idx)
 	if (atomic_inc_return(&sde_kms->irq_obj.enable_counts[irq_idx]) == 1) {
 		spin_lock_irqsave(&sde_kms->irq_obj.cb_lock, irq_flags);
 		/* empty callback list but interrupt is being enabled */
-		if (list_empty(&sde_kms->irq_obj.irq_cb_tbl[irq_idx]))
+		if (list_empty(&sde_kms->irq_obj.irq_cb_tbl[irq_idx]) &&
+				!_sde_core_irq_has_fast(&sde_kms->irq_obj,
+					irq_idx))
 			SDE_ERROR("enabling irq_idx=%d with no callback\n",
 					irq_idx);
 		spin_unlock_irqrestore(&sde_kms->irq_obj.cb_lock, irq_flags);
@@ -278,11 +376,80 @@ u32 sde_core_irq_read(struct sde_kms *sde_kms, int irq_idx, bool clear)
 			irq_idx, clear);
 }
 
-int sde_core_irq_register_callback(struct sde_kms *sde_kms, int irq_idx,
-		struct sde_irq_callback *register_irq_cb)
+/**
+ * _sde_core_irq_in_dispatch - check if the caller runs inside the dispatcher
+ * @irq_obj:		Pointer to irq object
+ * Returns: true if called from an irq callback, with a warning
+ *
+ * The dispatcher holds the hw interrupt lock while calling the callbacks,
+ * so waiting for the grace period from a callback would deadlock on it.
+ */
+static bool _sde_core_irq_in_dispatch(struct sde_irq *irq_obj)
+{
+	return WARN_ONCE(READ_ONCE(irq_obj->dispatch_cpu) ==
+			raw_smp_processor_id(),
+			"irq callback updated from irq dispatch\n");
+}
+
+/**
+ * _sde_core_irq_remove_callback - remove a callback from its callback list
+ *	and wait until no dispatch can reference it anymore
+ * @irq_obj:		Pointer to irq object
+ * @dispatch_lock:	lock held by every dispatch of @irq_obj
+ * @cb:			callback to remove
+ * Returns: 0 on success, -EDEADLK if called from an irq callback
+ *
+ * All dispatching happens under the hw interrupt lock, so cycling that
+ * lock ends the grace period of the removed callback. Unlike
+ * synchronize_rcu this is allowed from the atomic context some callers
+ * unregister from, and it never waits on more than one dispatch. It must
+ * not be used from within a callback, which already holds that lock.
+ */
+static int _sde_core_irq_remove_callback(struct sde_irq *irq_obj,
+		spinlock_t *dispatch_lock, struct sde_irq_callback *cb)
+{
+	unsigned long irq_flags;
+	bool listed;
+
+	if (_sde_core_irq_in_dispatch(irq_obj))
+		return -EDEADLK;
+
+	spin_lock_irqsave(&irq_obj->cb_lock, irq_flags);
+	listed = !list_empty(&cb->list);
+	if (listed)
+		list_del_rcu(&cb->list);
+	spin_unlock_irqrestore(&irq_obj->cb_lock, irq_flags);
+
+	if (!listed)
+		return 0;
+
+	spin_lock_irqsave(dispatch_lock, irq_flags);
+	spin_unlock_irqrestore(dispatch_lock, irq_flags);
+
+	INIT_LIST_HEAD(&cb->list);
+
+	return 0;
+}
+
+/**
+ * _sde_core_irq_add_callback - add a removed callback to a callback list
+ * @irq_obj:		Pointer to irq object
+ * @irq_idx:		interrupt index
+ * @cb:			callback to add
+ */
+static void _sde_core_irq_add_callback(struct sde_irq *irq_obj, int irq_idx,
+		struct sde_irq_callback *cb)
 {
 	unsigned long irq_flags;
 
+	spin_lock_irqsave(&irq_obj->cb_lock, irq_flags);
+	list_add_tail_rcu(&cb->list, &irq_obj->irq_cb_tbl[irq_idx]);
+	spin_unlock_irqrestore(&irq_obj->cb_lock, irq_flags);
+}
+
+int sde_core_irq_register_callback(struct sde_kms *sde_kms, int irq_idx,
+		struct sde_irq_callback *register_irq_cb)
+{
 	if (!sde_kms || !sde_kms->irq_obj.irq_cb_tbl) {
 		SDE_ERROR("invalid params\n");
 		return -EINVAL;
@@ -303,12 +470,13 @@ int sde_core_irq_register_callback(struct sde_kms *sde_kms, int irq_idx,
 
 	SDE_DEBUG("[%pS] irq_idx=%d\n", __builtin_return_address(0), irq_idx);
 
-	spin_lock_irqsave(&sde_kms->irq_obj.cb_lock, irq_flags);
 	SDE_EVT32(irq_idx, register_irq_cb);
-	list_del_init(&register_irq_cb->list);
-	list_add_tail(&register_irq_cb->list,
-			&sde_kms->irq_obj.irq_cb_tbl[irq_idx]);
-	spin_unlock_irqrestore(&sde_kms->irq_obj.cb_lock, irq_flags);
+	if (_sde_core_irq_remove_callback(&sde_kms->irq_obj,
+			&sde_kms->hw_intr->irq_lock, register_irq_cb))
+		return -EDEADLK;
+
+	_sde_core_irq_add_callback(&sde_kms->irq_obj, irq_idx,
+			register_irq_cb);
 
 	return 0;
 }
@@ -338,11 +506,15 @@ int sde_core_irq_unregister_callback(struct sde_kms *sde_kms, int irq_idx,
 
 	SDE_DEBUG("[%pS] irq_idx=%d\n", __builtin_return_address(0), irq_idx);
 
-	spin_lock_irqsave(&sde_kms->irq_obj.cb_lock, irq_flags);
 	SDE_EVT32(irq_idx, register_irq_cb);
-	list_del_init(&register_irq_cb->list);
+	if (_sde_core_irq_remove_callback(&sde_kms->irq_obj,
+			&sde_kms->hw_intr->irq_lock, register_irq_cb))
+		return -EDEADLK;
+
+	spin_lock_irqsave(&sde_kms->irq_obj.cb_lock, irq_flags);
 	/* empty callback list but interrupt is still enabled */
 	if (list_empty(&sde_kms->irq_obj.irq_cb_tbl[irq_idx]) &&
+			!_sde_core_irq_has_fast(&sde_kms->irq_obj, irq_idx) &&
 			atomic_read(&sde_kms->irq_obj.enable_counts[irq_idx]))
 		SDE_ERROR("irq_idx=%d enabled with no callback\n", irq_idx);
 	spin_unlock_irqrestore(&sde_kms->irq_obj.cb_lock, irq_flags);
@@ -350,6 +522,91 @@ int sde_core_irq_unregister_callback(struct sde_kms *sde_kms, int irq_idx,
 	return 0;
 }
 
+int sde_core_irq_register_fast_callback(struct sde_kms *sde_kms, int irq_idx,
+		struct sde_irq_callback *register_irq_cb, const char *name)
+{
+	struct sde_irq_fast *fast;
+	unsigned long irq_flags;
+	int ret = 0;
+
+	if (!sde_kms || !sde_kms->irq_obj.irq_fast) {
+		SDE_ERROR("invalid params\n");
+		return -EINVAL;
+	}
+
+	if (!register_irq_cb || !register_irq_cb->func) {
+		SDE_ERROR("invalid irq_cb:%d func:%d\n",
+				register_irq_cb != NULL,
+				register_irq_cb ?
+					register_irq_cb->func != NULL : -1);
+		return -EINVAL;
+	}
+
+	if (irq_idx < 0 || irq_idx >= sde_kms->hw_intr->sde_irq_map_size) {
+		SDE_ERROR("invalid IRQ index: [%d]\n", irq_idx);
+		return -EINVAL;
+	}
+
+	SDE_DEBUG("[%pS] irq_idx=%d\n", __builtin_return_address(0), irq_idx);
+
+	fast = &sde_kms->irq_obj.irq_fast[irq_idx];
+
+	spin_lock_irqsave(&sde_kms->irq_obj.cb_lock, irq_flags);
+	if (fast->cb && fast->cb != register_irq_cb) {
+		ret = -EBUSY;
+	} else {
+		fast->name = name;
+		WRITE_ONCE(fast->cb, register_irq_cb);
+	}
+	spin_unlock_irqrestore(&sde_kms->irq_obj.cb_lock, irq_flags);
+
+	SDE_EVT32(irq_idx, register_irq_cb, ret);
+
+	return ret;
+}
+
+int sde_core_irq_unregister_fast_callback(struct sde_kms *sde_kms, int irq_idx,
+		struct sde_irq_callback *register_irq_cb)
+{
+	struct sde_irq_fast *fast;
+	unsigned long irq_flags;
+	int ret = 0;
+
+	if (!sde_kms || !sde_kms->irq_obj.irq_fast || !register_irq_cb) {
+		SDE_ERROR("invalid params\n");
+		return -EINVAL;
+	}
+
+	if (irq_idx < 0 || irq_idx >= sde_kms->hw_intr->sde_irq_map_size) {
+		SDE_ERROR("invalid IRQ index: [%d]\n", irq_idx);
+		return -EINVAL;
+	}
+
+	SDE_DEBUG("[%pS] irq_idx=%d\n", __builtin_return_address(0), irq_idx);
+
+	if (_sde_core_irq_in_dispatch(&sde_kms->irq_obj))
+		return -EDEADLK;
+
+	fast = &sde_kms->irq_obj.irq_fast[irq_idx];
+
+	spin_lock_irqsave(&sde_kms->irq_obj.cb_lock, irq_flags);
+	if (fast->cb == register_irq_cb)
+		WRITE_ONCE(fast->cb, NULL);
+	else
+		ret = -ENOENT;
+	spin_unlock_irqrestore(&sde_kms->irq_obj.cb_lock, irq_flags);
+
+	SDE_EVT32(irq_idx, register_irq_cb, ret);
+	if (ret)
+		return ret;
+
+	/* same grace period as _sde_core_irq_remove_callback */
+	spin_lock_irqsave(&sde_kms->hw_intr->irq_lock, irq_flags);
+	spin_unlock_irqrestore(&sde_kms->hw_intr->irq_lock, irq_flags);
+
+	return 0;
+}
+
 static void sde_clear_all_irqs(struct sde_kms *sde_kms)
 {
 	if (!sde_kms || !sde_kms->hw_intr ||
@@ -413,18 +670,330 @@ static int sde_debugfs_core_irq_show(struct seq_file *s, void *v)
 
 DEFINE_SDE_DEBUGFS_SEQ_FOPS(sde_debugfs_core_irq);
 
+static int sde_debugfs_core_irq_latency_show(struct seq_file *s, void *v)
+{
+	struct sde_irq *irq_obj = s->private;
+	struct sde_irq_latency lat;
+	int i, j, irq_count;
+
+	if (!irq_obj || !irq_obj->irq_counts || !irq_obj->irq_latency) {
+		SDE_ERROR("invalid parameters\n");
+		return 0;
+	}
+
+	seq_puts(s, "idx irq avg_ns max_ns buckets(<1us <2us <4us ...)\n");
+	for (i = 0; i < irq_obj->total_irqs; i++) {
+		irq_count = atomic_read(&irq_obj->irq_counts[i]);
+		if (!irq_count)
+			continue;
+
+		/* statistics only, a torn snapshot is acceptable */
+		lat = irq_obj->irq_latency[i];
+
+		seq_printf(s, "idx:%d irq:%d avg:%llu max:%u [", i, irq_count,
+				div_u64(lat.total_ns, irq_count), lat.max_ns);
+		for (j = 0; j < SDE_IRQ_LATENCY_BUCKETS; j++)
+			seq_printf(s, " %u", lat.buckets[j]);
+		seq_puts(s, " ]\n");
+	}
+
+	return 0;
+}
+
+DEFINE_SDE_DEBUGFS_SEQ_FOPS(sde_debugfs_core_irq_latency);
+
+static int sde_debugfs_core_irq_fast_show(struct seq_file *s, void *v)
+{
+	struct sde_irq *irq_obj = s->private;
+	struct sde_irq_fast fast;
+	int i, j;
+
+	if (!irq_obj || !irq_obj->irq_fast) {
+		SDE_ERROR("invalid parameters\n");
+		return 0;
+	}
+
+	seq_puts(s, "idx name irq avg_ns max_ns buckets(<1us <2us <4us ...)\n");
+	for (i = 0; i < irq_obj->total_irqs; i++) {
+		/* statistics only, a torn snapshot is acceptable */
+		fast = irq_obj->irq_fast[i];
+		if (!fast.cb && !fast.count)
+			continue;
+
+		seq_printf(s, "idx:%d %s irq:%u avg:%llu max:%u [", i,
+				fast.name ? fast.name : "unknown", fast.count,
+				fast.count ? div_u64(fast.latency.total_ns,
+					fast.count) : 0,
+				fast.latency.max_ns);
+		for (j = 0; j < SDE_IRQ_LATENCY_BUCKETS; j++)
+			seq_printf(s, " %u", fast.latency.buckets[j]);
+		seq_puts(s, " ]\n");
+	}
+
+	return 0;
+}
+
+DEFINE_SDE_DEBUGFS_SEQ_FOPS(sde_debugfs_core_irq_fast);
+
+#define SDE_IRQ_STRESS_IRQS		4
+#define SDE_IRQ_STRESS_CBS		16
+#define SDE_IRQ_STRESS_WRITERS		2
+#define SDE_IRQ_STRESS_PERIOD_NS	(20 * NSEC_PER_USEC)
+#define SDE_IRQ_STRESS_MAX_MS		60000
+
+struct sde_irq_stress;
+
+/**
+ * struct sde_irq_stress_cb - callback moved between lists by the stress test
+ * @cb:		callback, its argument points back to this structure
+ * @stress:	stress test the callback belongs to
+ * @irq_idx:	list the callback is on, -1 while it is not on any list
+ * @calls:	number of calls, updated under the dispatch lock
+ */
+struct sde_irq_stress_cb {
+	struct sde_irq_callback cb;
+	struct sde_irq_stress *stress;
+	int irq_idx;
+	u32 calls;
+};
+
+/**
+ * struct sde_irq_stress_writer - thread registering and unregistering
+ * @stress:	stress test the thread belongs to
+ * @first:	first callback of the thread, it owns every
+ *		SDE_IRQ_STRESS_WRITERS-th callback from there
+ * @task:	the thread
+ */
+struct sde_irq_stress_writer {
+	struct sde_irq_stress *stress;
+	u32 first;
+	struct task_struct *task;
+};
+
+/**
+ * struct sde_irq_stress - callback list stress test
+ * @irq_obj:	irq object private to the test, no hw interrupt reaches it
+ * @lists:	callback lists of @irq_obj
+ * @dispatch_lock: held by every simulated dispatch, like the hw irq lock
+ * @timer:	simulated interrupt source
+ * @cbs:	callbacks under test
+ * @writers:	register and unregister threads
+ * @dispatches:	number of simulated interrupts, updated under @dispatch_lock
+ * @updates:	number of callback moves
+ * @stale:	calls of a callback through a list it was removed from
+ */
+struct sde_irq_stress {
+	struct sde_irq irq_obj;
+	struct list_head lists[SDE_IRQ_STRESS_IRQS];
+	spinlock_t dispatch_lock;
+	struct hrtimer timer;
+	struct sde_irq_stress_cb cbs[SDE_IRQ_STRESS_CBS];
+	struct sde_irq_stress_writer writers[SDE_IRQ_STRESS_WRITERS];
+	u64 dispatches;
+	atomic_t updates;
+	atomic_t stale;
+};
+
+static void _sde_core_irq_stress_cb(void *arg, int irq_idx)
+{
+	struct sde_irq_stress_cb *s = arg;
+
+	if (READ_ONCE(s->irq_idx) != irq_idx)
+		atomic_inc(&s->stress->stale);
+	s->calls++;
+}
+
+/* the interrupt source, dispatches every list like sde_core_irq */
+static enum hrtimer_restart _sde_core_irq_stress_fire(struct hrtimer *timer)
+{
+	struct sde_irq_stress *stress = container_of(timer,
+			struct sde_irq_stress, timer);
+	unsigned long irq_flags;
+	int i;
+
+	spin_lock_irqsave(&stress->dispatch_lock, irq_flags);
+	WRITE_ONCE(stress->irq_obj.dispatch_cpu, raw_smp_processor_id());
+	for (i = 0; i < SDE_IRQ_STRESS_IRQS; i++)
+		_sde_core_irq_call_callbacks(&stress->irq_obj, i);
+	WRITE_ONCE(stress->irq_obj.dispatch_cpu, -1);
+	stress->dispatches++;
+	spin_unlock_irqrestore(&stress->dispatch_lock, irq_flags);
+
+	hrtimer_forward_now(timer, ns_to_ktime(SDE_IRQ_STRESS_PERIOD_NS));
+
+	return HRTIMER_RESTART;
+}
+
+/*
+ * Move each owned callback to another list, or leave it off all lists for
+ * a round, the same remove and add sequence as register and unregister.
+ */
+static int _sde_core_irq_stress_writer(void *data)
+{
+	struct sde_irq_stress_writer *w = data;
+	struct sde_irq_stress *stress = w->stress;
+	struct sde_irq_stress_cb *s;
+	u32 round = 0, i, idx;
+
+	while (!kthread_should_stop()) {
+		for (i = w->first; i < SDE_IRQ_STRESS_CBS;
+				i += SDE_IRQ_STRESS_WRITERS) {
+			s = &stress->cbs[i];
+			_sde_core_irq_remove_callback(&stress->irq_obj,
+					&stress->dispatch_lock, &s->cb);
+			WRITE_ONCE(s->irq_idx, -1);
+
+			idx = (i + round) % (SDE_IRQ_STRESS_IRQS + 1);
+			if (idx < SDE_IRQ_STRESS_IRQS) {
+				WRITE_ONCE(s->irq_idx, idx);
+				_sde_core_irq_add_callback(&stress->irq_obj,
+						idx, &s->cb);
+			}
+
+			atomic_inc(&stress->updates);
+		}
+
+		round++;
+		cond_resched();
+	}
+
+	return 0;
+}
+
+static int _sde_core_irq_stress_run(struct sde_irq_stress *stress,
+		u32 duration_ms)
+{
+	struct sde_irq_stress_writer *w;
+	int i, rc = 0;
+
+	stress->irq_obj.total_irqs = SDE_IRQ_STRESS_IRQS;
+	stress->irq_obj.irq_cb_tbl = stress->lists;
+	stress->irq_obj.dispatch_cpu = -1;
+	spin_lock_init(&stress->irq_obj.cb_lock);
+	spin_lock_init(&stress->dispatch_lock);
+	for (i = 0; i < SDE_IRQ_STRESS_IRQS; i++)
+		INIT_LIST_HEAD(&stress->lists[i]);
+
+	for (i = 0; i < SDE_IRQ_STRESS_CBS; i++) {
+		stress->cbs[i].stress = stress;
+		stress->cbs[i].irq_idx = -1;
+		stress->cbs[i].cb.func = _sde_core_irq_stress_cb;
+		stress->cbs[i].cb.arg = &stress->cbs[i];
+		INIT_LIST_HEAD(&stress->cbs[i].cb.list);
+	}
+
+	hrtimer_init(&stress->timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	stress->timer.function = _sde_core_irq_stress_fire;
+	hrtimer_start(&stress->timer, ns_to_ktime(SDE_IRQ_STRESS_PERIOD_NS),
+			HRTIMER_MODE_REL);
+
+	for (i = 0; i < SDE_IRQ_STRESS_WRITERS; i++) {
+		w = &stress->writers[i];
+		w->stress = stress;
+		w->first = i;
+		w->task = kthread_run(_sde_core_irq_stress_writer, w,
+				"sde_irq_stress%d", i);
+		if (IS_ERR(w->task)) {
+			rc = PTR_ERR(w->task);
+			w->task = NULL;
+			break;
+		}
+	}
+
+	if (!rc)
+		msleep_interruptible(duration_ms);
+
+	for (i = 0; i < SDE_IRQ_STRESS_WRITERS; i++)
+		if (stress->writers[i].task)
+			kthread_stop(stress->writers[i].task);
+
+	hrtimer_cancel(&stress->timer);
+
+	for (i = 0; i < SDE_IRQ_STRESS_CBS; i++)
+		_sde_core_irq_remove_callback(&stress->irq_obj,
+				&stress->dispatch_lock, &stress->cbs[i].cb);
+
+	for (i = 0; i < SDE_IRQ_STRESS_IRQS; i++)
+		if (!list_empty(&stress->lists[i]) && !rc)
+			rc = -EIO;
+
+	return rc;
+}
+
+/*
+ * Writing a duration in ms runs the stress test for that long. The write
+ * fails with -EIO if a callback was called after it had been removed from
+ * the list it was called through.
+ */
+static ssize_t sde_debugfs_core_irq_stress_write(struct file *file,
+		const char __user *user_buf, size_t count, loff_t *ppos)
+{
+	struct sde_irq_stress *stress;
+	u32 duration_ms, calls = 0;
+	int i, rc;
+
+	rc = kstrtouint_from_user(user_buf, count, 0, &duration_ms);
+	if (rc)
+		return rc;
+
+	if (!duration_ms || duration_ms > SDE_IRQ_STRESS_MAX_MS)
+		return -EINVAL;
+
+	stress = kzalloc(sizeof(*stress), GFP_KERNEL);
+	if (!stress)
+		return -ENOMEM;
+
+	rc = _sde_core_irq_stress_run(stress, duration_ms);
+
+	for (i = 0; i < SDE_IRQ_STRESS_CBS; i++)
+		calls += stress->cbs[i].calls;
+
+	if (!rc && (atomic_read(&stress->stale) || !calls))
+		rc = -EIO;
+
+	SDE_INFO("irq stress: %llu dispatches %d updates %u calls %d stale rc %d\n",
+			stress->dispatches, atomic_read(&stress->updates),
+			calls, atomic_read(&stress->stale), rc);
+	SDE_EVT32(stress->dispatches, atomic_read(&stress->updates), calls,
+			atomic_read(&stress->stale), rc);
+
+	kfree(stress);
+
+	return rc ? rc : count;
+}
+
+static const struct file_operations sde_debugfs_core_irq_stress_fops = {
+	.open = simple_open,
+	.write = sde_debugfs_core_irq_stress_write,
+};
+
 int sde_debugfs_core_irq_init(struct sde_kms *sde_kms,
 		struct dentry *parent)
 {
 	sde_kms->irq_obj.debugfs_file = debugfs_create_file("core_irq", 0400,
 			parent, &sde_kms->irq_obj,
 			&sde_debugfs_core_irq_fops);
+	sde_kms->irq_obj.debugfs_latency_file = debugfs_create_file(
+			"core_irq_latency", 0400, parent, &sde_kms->irq_obj,
+			&sde_debugfs_core_irq_latency_fops);
+	sde_kms->irq_obj.debugfs_fast_file = debugfs_create_file(
+			"core_irq_fast", 0400, parent, &sde_kms->irq_obj,
+			&sde_debugfs_core_irq_fast_fops);
+	sde_kms->irq_obj.debugfs_stress_file = debugfs_create_file(
+			"core_irq_stress", 0200, parent, &sde_kms->irq_obj,
+			&sde_debugfs_core_irq_stress_fops);
 
 	return 0;
 }
 
 void sde_debugfs_core_irq_destroy(struct sde_kms *sde_kms)
 {
+	debugfs_remove(sde_kms->irq_obj.debugfs_stress_file);
+	sde_kms->irq_obj.debugfs_stress_file = NULL;
+	debugfs_remove(sde_kms->irq_obj.debugfs_fast_file);
+	sde_kms->irq_obj.debugfs_fast_file = NULL;
+	debugfs_remove(sde_kms->irq_obj.debugfs_latency_file);
+	sde_kms->irq_obj.debugfs_latency_file = NULL;
 	debugfs_remove(sde_kms->irq_obj.debugfs_file);
 	sde_kms->irq_obj.debugfs_file = NULL;
 }
@@ -466,6 +1035,7 @@ void sde_core_irq_preinstall(struct sde_kms *sde_kms)
 	}
 
 	spin_lock_init(&sde_kms->irq_obj.cb_lock);
+	sde_kms->irq_obj.dispatch_cpu = -1;
 
 	/* Create irq callbacks for all possible irq_idx */
 	sde_kms->irq_obj.total_irqs = sde_kms->hw_intr->sde_irq_map_size;
@@ -475,6 +1045,10 @@ void sde_core_irq_preinstall(struct sde_kms *sde_kms)
 			sizeof(atomic_t), GFP_KERNEL);
 	sde_kms->irq_obj.irq_counts = kcalloc(sde_kms->irq_obj.total_irqs,
 			sizeof(atomic_t), GFP_KERNEL);
+	sde_kms->irq_obj.irq_latency = kcalloc(sde_kms->irq_obj.total_irqs,
+			sizeof(struct sde_irq_latency), GFP_KERNEL);
+	sde_kms->irq_obj.irq_fast = kcalloc(sde_kms->irq_obj.total_irqs,
+			sizeof(struct sde_irq_fast), GFP_KERNEL);
 	if (!sde_kms->irq_obj.irq_cb_tbl || !sde_kms->irq_obj.enable_counts
 			|| !sde_kms->irq_obj.irq_counts)
 		return;
@@ -514,7 +1088,8 @@ void sde_core_irq_uninstall(struct sde_kms *sde_kms)
 
 	for (i = 0; i < sde_kms->irq_obj.total_irqs; i++)
 		if (atomic_read(&sde_kms->irq_obj.enable_counts[i]) ||
-				!list_empty(&sde_kms->irq_obj.irq_cb_tbl[i]))
+				!list_empty(&sde_kms->irq_obj.irq_cb_tbl[i]) ||
+				_sde_core_irq_has_fast(&sde_kms->irq_obj, i))
 			SDE_ERROR("irq_idx=%d still enabled/registered\n", i);
 
 	sde_clear_all_irqs(sde_kms);
@@ -525,9 +1100,13 @@ void sde_core_irq_uninstall(struct sde_kms *sde_kms)
 	kfree(sde_kms->irq_obj.irq_cb_tbl);
 	kfree(sde_kms->irq_obj.enable_counts);
 	kfree(sde_kms->irq_obj.irq_counts);
+	kfree(sde_kms->irq_obj.irq_latency);
+	kfree(sde_kms->irq_obj.irq_fast);
 	sde_kms->irq_obj.irq_cb_tbl = NULL;
 	sde_kms->irq_obj.enable_counts = NULL;
 	sde_kms->irq_obj.irq_counts = NULL;
+	sde_kms->irq_obj.irq_latency = NULL;
+	sde_kms->irq_obj.irq_fast = NULL;
 	sde_kms->irq_obj.total_irqs = 0;
 	spin_unlock_irqrestore(&sde_kms->irq_obj.cb_lock, irq_flags);
 }
@@ -631,6 +1210,9 @@ int sde_core_irq_domain_fini(struct sde_kms *sde_kms)
 
 irqreturn_t sde_core_irq(struct sde_kms *sde_kms)
 {
+	/* start of the interval traced by the fast path handlers */
+	sde_kms->irq_obj.irq_ts = ktime_get();
+
 	/*
 	 * Read interrupt status from all sources. Interrupt status are
 	 * stored within hw_intr.
@@ -648,10 +1230,12 @@ irqreturn_t sde_core_irq(struct sde_kms *sde_kms)
 	 * callback, and do the interrupt status clearing once the registered
 	 * callback is finished.
 	 */
+	WRITE_ONCE(sde_kms->irq_obj.dispatch_cpu, raw_smp_processor_id());
 	sde_kms->hw_intr->ops.dispatch_irqs(
 			sde_kms->hw_intr,
 			sde_core_irq_callback_handler,
 			sde_kms);
+	WRITE_ONCE(sde_kms->irq_obj.dispatch_cpu, -1);
 
 	return IRQ_HANDLED;
 }
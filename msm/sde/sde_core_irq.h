@@ -143,6 +143,7 @@ u32 sde_core_irq_read_nolock(
  * @return:		0 for success registering callback, otherwise failure
  *
  * This function supports registration of multiple callbacks for each interrupt.
+ * Like unregistration it must not be called from an irq callback.
  */
 int sde_core_irq_register_callback(
 		struct sde_kms *sde_kms,
@@ -161,12 +162,47 @@ int sde_core_irq_register_callback(
  * @return:		0 for success registering callback, otherwise failure
  *
  * This function supports registration of multiple callbacks for each interrupt.
+ * It waits for the dispatch in flight to finish, so it must not be called
+ * from an irq callback and fails with -EDEADLK if it is.
  */
 int sde_core_irq_unregister_callback(
 		struct sde_kms *sde_kms,
 		int irq_idx,
 		struct sde_irq_callback *irq_cb);
 
+/**
+ * sde_core_irq_register_fast_callback - install the fast path handler of an
+ *	irq_idx. The dispatcher calls it directly, without walking the
+ *	callback list. Only one fast handler can be installed per irq_idx.
+ * @sde_kms:		SDE handle
+ * @irq_idx:		irq index
+ * @irq_cb:		IRQ callback structure, containing callback function
+ *			and argument
+ * @name:		name of the handler for debugfs
+ * @return:		0 for success, -EBUSY if another fast handler is
+ *			installed, otherwise failure
+ */
+int sde_core_irq_register_fast_callback(
+		struct sde_kms *sde_kms,
+		int irq_idx,
+		struct sde_irq_callback *irq_cb,
+		const char *name);
+
+/**
+ * sde_core_irq_unregister_fast_callback - remove the fast path handler of an
+ *	irq_idx and wait until no dispatch can reference it anymore
+ * @sde_kms:		SDE handle
+ * @irq_idx:		irq index
+ * @irq_cb:		IRQ callback structure, containing callback function
+ *			and argument
+ * @return:		0 for success, -ENOENT if @irq_cb isn't installed, or
+ *			-EDEADLK if called from an irq callback
+ */
+int sde_core_irq_unregister_fast_callback(
+		struct sde_kms *sde_kms,
+		int irq_idx,
+		struct sde_irq_callback *irq_cb);
+
 /**
  * sde_debugfs_core_irq_init - register core irq debugfs
  * @sde_kms: pointer to kms
@@ -8,6 +8,7 @@
 #include <linux/debugfs.h>
 #include <linux/errno.h>
 #include <linux/mutex.h>
+#include <linux/seq_file.h>
 #include <linux/sort.h>
 #include <linux/clk.h>
 #include <linux/bitmap.h>
@@ -188,6 +189,131 @@ static void _sde_core_perf_calc_crtc(struct sde_kms *kms,
 			perf->bw_ctl[SDE_POWER_HANDLE_DBUS_ID_EBI]);
 }
 
+static u32 _sde_core_perf_model_bpp(const struct sde_format *fmt)
+{
+	u32 luma;
+
+	if (!SDE_FORMAT_IS_YUV(fmt) ||
+			fmt->fetch_planes == SDE_PLANE_INTERLEAVED)
+		return fmt->bpp * SDE_PERF_MODEL_FP;
+
+	/* planar formats report the bpp of the chroma plane only */
+	luma = SDE_FORMAT_IS_DX(fmt) ? 2 : 1;
+	switch (fmt->chroma_sample) {
+	case SDE_CHROMA_420:
+		return luma * SDE_PERF_MODEL_FP * 3 / 2;
+	case SDE_CHROMA_H2V1:
+	case SDE_CHROMA_H1V2:
+		return luma * SDE_PERF_MODEL_FP * 2;
+	default:
+		return luma * SDE_PERF_MODEL_FP * 3;
+	}
+}
+
+static int _sde_core_perf_model_check(struct sde_kms *kms,
+		struct drm_crtc *crtc,
+		struct drm_crtc_state *state)
+{
+	struct sde_core_perf *perf = &kms->perf;
+	struct sde_perf_model_cfg *cfg = &perf->model_cfg;
+	struct sde_perf_model_result *res = &perf->model_last;
+	struct drm_display_mode *mode = &state->adjusted_mode;
+	struct sde_perf_model_timing timing;
+	const struct drm_plane_state *pstate;
+	struct drm_plane *plane;
+	const char *comp_ratio;
+	u32 count = 0;
+	int rc;
+
+	if (!state->active || !mode->vdisplay || !mode->vtotal)
+		return 0;
+
+	timing.width = mode->hdisplay;
+	timing.height = mode->vdisplay;
+	timing.vtotal = mode->vtotal;
+	timing.fps = drm_mode_vrefresh(mode);
+	timing.num_mixers = to_sde_crtc(crtc)->num_mixers;
+
+	if (sde_crtc_get_client_type(crtc) == NRT_CLIENT)
+		comp_ratio = kms->catalog->perf.comp_ratio_nrt;
+	else
+		comp_ratio = kms->catalog->perf.comp_ratio_rt;
+
+	mutex_lock(&sde_core_perf_lock);
+
+	/* limits are tunable through debugfs, refresh them on every check */
+	cfg->max_bw = kms->catalog->perf.max_bw_high * 1000ULL;
+	cfg->min_ib[SDE_PERF_MODEL_BUS_MNOC] =
+			kms->catalog->perf.min_core_ib * 1000ULL;
+	cfg->min_ib[SDE_PERF_MODEL_BUS_LLCC] =
+			kms->catalog->perf.min_llcc_ib * 1000ULL;
+	cfg->min_ib[SDE_PERF_MODEL_BUS_EBI] =
+			kms->catalog->perf.min_dram_ib * 1000ULL;
+	cfg->max_core_clk_rate = perf->max_core_clk_rate;
+
+	drm_atomic_crtc_state_for_each_plane_state(plane, pstate, state) {
+		struct sde_perf_model_plane *model_plane;
+		const struct sde_format *fmt;
+
+		if (IS_ERR_OR_NULL(pstate) || !pstate->fb)
+			continue;
+
+		if (count >= SDE_PERF_MODEL_MAX_PLANES)
+			break;
+
+		fmt = to_sde_format(msm_framebuffer_format(pstate->fb));
+		model_plane = &perf->model_planes[count++];
+		model_plane->src_w = pstate->src_w >> 16;
+		model_plane->src_h = pstate->src_h >> 16;
+		model_plane->dst_w = pstate->crtc_w;
+		model_plane->dst_h = pstate->crtc_h;
+		model_plane->bpp = _sde_core_perf_model_bpp(fmt);
+		model_plane->yuv = SDE_FORMAT_IS_YUV(fmt);
+		model_plane->tiled = !SDE_FORMAT_IS_LINEAR(fmt);
+
+		if (!SDE_FORMAT_IS_UBWC(fmt) ||
+				sde_perf_model_parse_comp_ratio(comp_ratio,
+					fmt->base.pixel_format,
+					&model_plane->comp_ratio))
+			model_plane->comp_ratio = SDE_PERF_MODEL_FP;
+	}
+
+	rc = sde_perf_model_calc(cfg, &timing, perf->model_planes, count, res);
+	if (rc) {
+		SDE_DEBUG("crtc%d perf model skipped, rc %d\n",
+				crtc->base.id, rc);
+		perf->model_last_count = 0;
+		mutex_unlock(&sde_core_perf_lock);
+		return 0;
+	}
+
+	perf->model_last_crtc = crtc->base.id;
+	perf->model_last_count = count;
+
+	SDE_EVT32(DRMID(crtc), count, res->core_clk,
+		GET_H32(res->ab[SDE_PERF_MODEL_BUS_MNOC]),
+		GET_L32(res->ab[SDE_PERF_MODEL_BUS_MNOC]),
+		GET_H32(res->ib[SDE_PERF_MODEL_BUS_MNOC]),
+		GET_L32(res->ib[SDE_PERF_MODEL_BUS_MNOC]),
+		res->bw_fits, res->clk_fits);
+
+	if (!res->bw_fits || !res->clk_fits) {
+		SDE_DEBUG(
+			"crtc%d perf model exceeds limits: ab=%llu clk=%llu\n",
+			crtc->base.id, res->ab[SDE_PERF_MODEL_BUS_MNOC],
+			res->core_clk);
+		if (perf->model_enforce) {
+			SDE_ERROR("crtc%d exceeds modeled bandwidth/clock\n",
+					crtc->base.id);
+			rc = -E2BIG;
+		}
+	}
+
+	mutex_unlock(&sde_core_perf_lock);
+
+	return rc;
+}
+
 int sde_core_perf_crtc_check(struct drm_crtc *crtc,
 		struct drm_crtc_state *state)
 {
@@ -262,7 +388,7 @@ int sde_core_perf_crtc_check(struct drm_crtc *crtc,
 		}
 	}
 
-	return 0;
+	return _sde_core_perf_model_check(kms, crtc, state);
 }
 
 static inline bool _is_crtc_client_type_matches(struct drm_crtc *tmp_crtc,
@@ -1162,6 +1288,57 @@ static ssize_t _sde_core_perf_mode_read(struct file *file,
 	return len;
 }
 
+static int _sde_core_perf_model_show(struct seq_file *s, void *data)
+{
+	struct sde_core_perf *perf = s->private;
+	struct sde_perf_model_result *res = &perf->model_last;
+	u32 i;
+
+	mutex_lock(&sde_core_perf_lock);
+	if (!perf->model_last_count) {
+		mutex_unlock(&sde_core_perf_lock);
+		return 0;
+	}
+
+	seq_printf(s, "crtc:%u core_clk:%llu bw_fits:%d clk_fits:%d\n",
+			perf->model_last_crtc, res->core_clk,
+			res->bw_fits, res->clk_fits);
+	seq_printf(s, "mnoc ab:%llu ib:%llu\n",
+			res->ab[SDE_PERF_MODEL_BUS_MNOC],
+			res->ib[SDE_PERF_MODEL_BUS_MNOC]);
+	seq_printf(s, "llcc ab:%llu ib:%llu\n",
+			res->ab[SDE_PERF_MODEL_BUS_LLCC],
+			res->ib[SDE_PERF_MODEL_BUS_LLCC]);
+	seq_printf(s, "ebi ab:%llu ib:%llu\n",
+			res->ab[SDE_PERF_MODEL_BUS_EBI],
+			res->ib[SDE_PERF_MODEL_BUS_EBI]);
+
+	for (i = 0; i < perf->model_last_count; i++)
+		seq_printf(s,
+			"pipe%u %ux%u->%ux%u ab:%llu ib:%llu clk:%llu prefill:%u\n",
+			i, perf->model_planes[i].src_w,
+			perf->model_planes[i].src_h,
+			perf->model_planes[i].dst_w,
+			perf->model_planes[i].dst_h,
+			res->pipe[i].ab, res->pipe[i].ib, res->pipe[i].clk,
+			res->pipe[i].prefill_lines);
+	mutex_unlock(&sde_core_perf_lock);
+
+	return 0;
+}
+
+static int _sde_core_perf_model_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, _sde_core_perf_model_show, inode->i_private);
+}
+
+static const struct file_operations sde_core_perf_model_fops = {
+	.open = _sde_core_perf_model_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
 static const struct file_operations sde_core_perf_threshold_high_fops = {
 	.open = simple_open,
 	.read = _sde_core_perf_threshold_high_read,
@@ -1229,6 +1406,10 @@ int sde_core_perf_debugfs_init(struct sde_core_perf *perf,
 			&perf->fix_core_ab_vote);
 	debugfs_create_bool("idle_sys_cache_enable", 0600, perf->debugfs_root,
 			&perf->idle_sys_cache_enabled);
+	debugfs_create_u32("model_enforce", 0600, perf->debugfs_root,
+			&perf->model_enforce);
+	debugfs_create_file("model_estimate", 0400, perf->debugfs_root,
+			perf, &sde_core_perf_model_fops);
 
 	debugfs_create_u32("uidle_perf_cnt", 0600, perf->debugfs_root,
 			&sde_kms->catalog->uidle_cfg.debugfs_perf);
@@ -1265,6 +1446,25 @@ void sde_core_perf_destroy(struct sde_core_perf *perf)
 	perf->dev = NULL;
 }
 
+static void _sde_core_perf_model_init(struct sde_core_perf *perf)
+{
+	struct sde_perf_cfg *cfg = &perf->catalog->perf;
+	struct sde_perf_model_cfg *model = &perf->model_cfg;
+
+	if (sde_perf_model_parse_fp(cfg->core_ib_ff, &model->core_ib_ff))
+		model->core_ib_ff = SDE_PERF_MODEL_FP;
+	if (sde_perf_model_parse_fp(cfg->core_clk_ff, &model->core_clk_ff))
+		model->core_clk_ff = SDE_PERF_MODEL_FP;
+
+	model->xtra_prefill_lines = cfg->xtra_prefill_lines;
+	model->dest_scale_prefill_lines = cfg->dest_scale_prefill_lines;
+	model->macrotile_prefill_lines = cfg->macrotile_prefill_lines;
+	model->yuv_nv12_prefill_lines = cfg->yuv_nv12_prefill_lines;
+	model->linear_prefill_lines = cfg->linear_prefill_lines;
+	model->downscaling_prefill_lines = cfg->downscaling_prefill_lines;
+	model->min_prefill_lines = cfg->min_prefill_lines;
+}
+
 int sde_core_perf_init(struct sde_core_perf *perf,
 		struct drm_device *dev,
 		struct sde_mdss_cfg *catalog,
@@ -1300,6 +1500,8 @@ int sde_core_perf_init(struct sde_core_perf *perf,
 	}
 	perf->idle_sys_cache_enabled = true;
 
+	_sde_core_perf_model_init(perf);
+
 	return 0;
 
 err:
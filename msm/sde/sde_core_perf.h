@@ -13,6 +13,7 @@
 
 #include "sde_hw_catalog.h"
 #include "sde_power_handle.h"
+#include "sde_perf_model.h"
 
 #define SDE_PERF_DEFAULT_MAX_CORE_CLK_RATE	320000000
 
@@ -78,6 +79,12 @@ struct sde_core_perf_tune {
  * @uidle_enabled: indicates if uidle is already enabled
  * @idle_sys_cache_enabled: override system cache enable state
  *                          for idle usecase
+ * @model_cfg: perf model limits parsed from the catalog
+ * @model_planes: plane list handed to the perf model
+ * @model_last: perf model estimate of the last checked crtc state
+ * @model_last_crtc: drm id of the crtc @model_last belongs to
+ * @model_last_count: number of planes in @model_last
+ * @model_enforce: reject crtc states the perf model does not fit
  */
 struct sde_core_perf {
 	struct drm_device *dev;
@@ -99,6 +106,12 @@ struct sde_core_perf {
 	bool llcc_active[SDE_SYS_CACHE_MAX];
 	bool uidle_enabled;
 	bool idle_sys_cache_enabled;
+	struct sde_perf_model_cfg model_cfg;
+	struct sde_perf_model_plane model_planes[SDE_PERF_MODEL_MAX_PLANES];
+	struct sde_perf_model_result model_last;
+	u32 model_last_crtc;
+	u32 model_last_count;
+	u32 model_enforce;
 };
 
 /**
@@ -58,6 +58,8 @@ static int sde_crtc_idle_interrupt_handler(struct drm_crtc *crtc_drm,
 	bool en, struct sde_irq_callback *idle_irq);
 static int sde_crtc_pm_event_handler(struct drm_crtc *crtc, bool en,
 		struct sde_irq_callback *noirq);
+static int sde_crtc_vsync_predict_event_handler(struct drm_crtc *crtc,
+		bool en, struct sde_irq_callback *noirq);
 
 static struct sde_crtc_custom_events custom_events[] = {
 	{DRM_EVENT_AD_BACKLIGHT, sde_cp_ad_interrupt},
@@ -68,6 +70,7 @@ static struct sde_crtc_custom_events custom_events[] = {
 	{DRM_EVENT_LTM_HIST, sde_cp_ltm_hist_interrupt},
 	{DRM_EVENT_LTM_WB_PB, sde_cp_ltm_wb_pb_interrupt},
 	{DRM_EVENT_LTM_OFF, sde_cp_ltm_off_event_handler},
+	{DRM_EVENT_VSYNC_PREDICT, sde_crtc_vsync_predict_event_handler},
 };
 
 /* default input fence timeout, in ms */
@@ -92,9 +95,11 @@ static struct sde_crtc_custom_events custom_events[] = {
  */
 #define DEFAULT_FPS_PERIOD_1_SEC	1000000
 #define MAX_FPS_PERIOD_5_SECONDS	5000000
-#define MAX_FRAME_COUNT			1000
 #define MILI_TO_MICRO			1000
 
+/* length of a frame interval histogram window */
+#define FRAME_HIST_WINDOW_US		10000000
+
 #define SKIP_STAGING_PIPE_ZPOS		255
 
 static inline struct sde_kms *_sde_crtc_get_kms(struct drm_crtc *crtc)
@@ -114,52 +119,294 @@ static inline struct sde_kms *_sde_crtc_get_kms(struct drm_crtc *crtc)
 	return to_sde_kms(priv->kms);
 }
 
+static u32 _sde_crtc_frame_hist_bucket(u64 interval_us)
+{
+	u32 msb, sub;
+
+	if (interval_us < BIT(SDE_CRTC_FRAME_HIST_MIN_SHIFT))
+		return 0;
+
+	msb = fls64(interval_us) - 1;
+	if (msb >= SDE_CRTC_FRAME_HIST_MIN_SHIFT + SDE_CRTC_FRAME_HIST_OCTAVES)
+		return SDE_CRTC_FRAME_HIST_BUCKETS - 1;
+
+	sub = (interval_us >> (msb - SDE_CRTC_FRAME_HIST_SUB_BITS)) &
+			(BIT(SDE_CRTC_FRAME_HIST_SUB_BITS) - 1);
+
+	return ((msb - SDE_CRTC_FRAME_HIST_MIN_SHIFT) <<
+			SDE_CRTC_FRAME_HIST_SUB_BITS) + sub;
+}
+
+/* upper bound of a histogram bucket in microseconds */
+static u64 _sde_crtc_frame_hist_bucket_max(u32 bucket)
+{
+	u32 msb = SDE_CRTC_FRAME_HIST_MIN_SHIFT +
+			(bucket >> SDE_CRTC_FRAME_HIST_SUB_BITS);
+	u32 sub = bucket & (BIT(SDE_CRTC_FRAME_HIST_SUB_BITS) - 1);
+
+	return (u64)(BIT(SDE_CRTC_FRAME_HIST_SUB_BITS) + sub + 1) <<
+			(msb - SDE_CRTC_FRAME_HIST_SUB_BITS);
+}
+
+/* clear the fps slots that elapsed since the newest one, lock held */
+static void _sde_crtc_fps_advance(struct sde_crtc_fps_info *info, u32 slot)
+{
+	u32 i, gap;
+
+	if (slot <= info->slot)
+		return;
+
+	gap = min_t(u32, slot - info->slot, SDE_CRTC_FPS_SLOTS);
+	for (i = 1; i <= gap; i++)
+		info->slot_frames[(info->slot + i) % SDE_CRTC_FPS_SLOTS] = 0;
+	info->slot = slot;
+}
+
+/**
+ * _sde_crtc_get_fps - measure the fps over the most recent fps slots
+ * @info: fps info of the crtc
+ * @duration_us: length of the measurement window
+ * @frames: returns the number of frames within the window
+ * Returns: 10 times the measured fps, e.g. 594 for 59.4 fps
+ */
+static u32 _sde_crtc_get_fps(struct sde_crtc_fps_info *info, u32 duration_us,
+		u64 *frames)
+{
+	unsigned long flags;
+	u64 count = 0, elapsed_us, fps;
+	u32 slot, idx, rem, n, i;
+
+	slot = div_u64_rem(ktime_to_us(ktime_get()), SDE_CRTC_FPS_SLOT_US,
+			&rem);
+	n = clamp_t(u32, DIV_ROUND_UP(duration_us, SDE_CRTC_FPS_SLOT_US),
+			1, SDE_CRTC_FPS_SLOTS);
+
+	spin_lock_irqsave(&info->lock, flags);
+	_sde_crtc_fps_advance(info, slot);
+	idx = slot % SDE_CRTC_FPS_SLOTS;
+	for (i = 0; i < n; i++) {
+		count += info->slot_frames[idx];
+		idx = idx ? idx - 1 : SDE_CRTC_FPS_SLOTS - 1;
+	}
+	spin_unlock_irqrestore(&info->lock, flags);
+
+	/* the newest slot has only partially elapsed */
+	elapsed_us = (u64)(n - 1) * SDE_CRTC_FPS_SLOT_US + rem;
+	if (frames)
+		*frames = count;
+	if (!elapsed_us)
+		return 0;
+
+	fps = div64_u64(count * DEFAULT_FPS_PERIOD_1_SEC * 10, elapsed_us);
+
+	return (u32)fps;
+}
+
+/**
+ * _sde_crtc_get_frame_hist - merge the histogram windows that are still
+ *	within FRAME_HIST_WINDOW_US of now
+ * @info: fps info of the crtc
+ * @out: returns the merged histogram
+ */
+static void _sde_crtc_get_frame_hist(struct sde_crtc_fps_info *info,
+		struct sde_crtc_frame_hist *out)
+{
+	struct sde_crtc_frame_hist *hist;
+	unsigned long flags;
+	s64 age_us;
+	u32 i, w, windows;
+
+	memset(out, 0, sizeof(*out));
+
+	spin_lock_irqsave(&info->lock, flags);
+	age_us = ktime_us_delta(ktime_get(), info->hist_start);
+	windows = age_us < FRAME_HIST_WINDOW_US ? 2 :
+			age_us < 2 * FRAME_HIST_WINDOW_US ? 1 : 0;
+	for (w = 0; w < windows; w++) {
+		hist = &info->hist[info->hist_active ^ w];
+		for (i = 0; i < SDE_CRTC_FRAME_HIST_BUCKETS; i++)
+			out->buckets[i] += hist->buckets[i];
+		out->count += hist->count;
+		out->missed += hist->missed;
+	}
+	spin_unlock_irqrestore(&info->lock, flags);
+}
+
+static u64 _sde_crtc_frame_hist_percentile(
+		const struct sde_crtc_frame_hist *hist, u32 pct)
+{
+	u64 target, seen = 0;
+	u32 i;
+
+	if (!hist->count)
+		return 0;
+
+	target = DIV_ROUND_UP_ULL((u64)hist->count * pct, 100);
+	for (i = 0; i < SDE_CRTC_FRAME_HIST_BUCKETS; i++) {
+		seen += hist->buckets[i];
+		if (seen >= target)
+			break;
+	}
+
+	return _sde_crtc_frame_hist_bucket_max(
+			min_t(u32, i, SDE_CRTC_FRAME_HIST_BUCKETS - 1));
+}
+
 /**
- * sde_crtc_calc_fps() - Calculates fps value.
+ * _sde_crtc_frame_deadline - time by which a frame kicked off now has to
+ *	be retired to make its target vsync
  * @sde_crtc   : CRTC structure
+ * @state      : current crtc state
+ * @now        : kickoff time
+ * @period     : returns the vsync period in ns, 0 if unknown
  *
- * This function is called at frame done. It counts the number
- * of frames done for every 1 sec. Stores the value in measured_fps.
- * measured_fps value is 10 times the calculated fps value.
- * For example, measured_fps= 594 for calculated fps of 59.4
+ * The target is the next vsync predicted by the encoder, or one refresh
+ * period from now without a settled prediction. A command mode frame is
+ * transferred to the panel during the frame after its trigger, so it is
+ * due one period later.
+ */
+static ktime_t _sde_crtc_frame_deadline(struct sde_crtc *sde_crtc,
+		struct drm_crtc_state *state, ktime_t now, s64 *period)
+{
+	struct drm_crtc *crtc = &sde_crtc->base;
+	struct drm_encoder *encoder;
+	ktime_t target = 0;
+	u32 vrefresh;
+
+	*period = 0;
+	drm_for_each_encoder_mask(encoder, crtc->dev, state->encoder_mask) {
+		target = sde_encoder_get_next_vsync(encoder, period);
+		if (target)
+			break;
+	}
+
+	if (!target) {
+		vrefresh = drm_mode_vrefresh(&state->adjusted_mode);
+		if (!vrefresh)
+			return 0;
+		*period = div_u64(NSEC_PER_SEC, vrefresh);
+		target = ktime_add_ns(now, *period);
+	}
+
+	if (sde_crtc_get_intf_mode(crtc, state) == INTF_MODE_CMD)
+		target = ktime_add_ns(target, *period);
+
+	return target;
+}
+
+/**
+ * sde_crtc_calc_fps() - Account a commit in the fps statistics.
+ * @sde_crtc   : CRTC structure
+ *
+ * This function is called at every kickoff. It counts the commit in the
+ * current slot of the sliding fps window, records the interval to the
+ * previous commit in the frame interval histogram and queues the retire
+ * deadline of the frame for sde_crtc_account_frame_done().
  */
 static void sde_crtc_calc_fps(struct sde_crtc *sde_crtc)
 {
-	ktime_t current_time_us;
-	u64 fps, diff_us;
+	struct sde_crtc_fps_info *info = &sde_crtc->fps_info;
+	struct sde_crtc_frame_hist *hist;
+	struct drm_crtc_state *state = sde_crtc->base.state;
+	ktime_t now = ktime_get(), deadline = 0;
+	u32 slot, idx;
+	u64 interval_us;
+	unsigned long flags;
+	s64 age_us, period = 0;
 
-	current_time_us = ktime_get();
-	diff_us = (u64)ktime_us_delta(current_time_us,
-			sde_crtc->fps_info.last_sampled_time_us);
-	sde_crtc->fps_info.frame_count++;
+	if (state)
+		deadline = _sde_crtc_frame_deadline(sde_crtc, state, now,
+				&period);
 
-	if (diff_us >= DEFAULT_FPS_PERIOD_1_SEC) {
+	slot = div_u64(ktime_to_us(now), SDE_CRTC_FPS_SLOT_US);
 
-		 /* Multiplying with 10 to get fps in floating point */
-		fps = ((u64)sde_crtc->fps_info.frame_count)
-						* DEFAULT_FPS_PERIOD_1_SEC * 10;
-		do_div(fps, diff_us);
-		sde_crtc->fps_info.measured_fps = (unsigned int)fps;
-		SDE_DEBUG(" FPS for crtc%d is %d.%d\n",
-				sde_crtc->base.base.id, (unsigned int)fps/10,
-				(unsigned int)fps%10);
-		sde_crtc->fps_info.last_sampled_time_us = current_time_us;
-		sde_crtc->fps_info.frame_count = 0;
+	spin_lock_irqsave(&info->lock, flags);
+	_sde_crtc_fps_advance(info, slot);
+	info->slot_frames[slot % SDE_CRTC_FPS_SLOTS]++;
+	info->total_frames++;
+
+	age_us = ktime_us_delta(now, info->hist_start);
+	if (age_us >= FRAME_HIST_WINDOW_US) {
+		/* the current window becomes the previous one */
+		if (age_us >= 2 * FRAME_HIST_WINDOW_US)
+			memset(&info->hist[info->hist_active], 0,
+					sizeof(*hist));
+		info->hist_active ^= 1;
+		memset(&info->hist[info->hist_active], 0, sizeof(*hist));
+		info->hist_start = now;
 	}
+	hist = &info->hist[info->hist_active];
+
+	if (ktime_to_ns(info->last_frame)) {
+		interval_us = ktime_us_delta(now, info->last_frame);
+		hist->buckets[_sde_crtc_frame_hist_bucket(interval_us)]++;
+		hist->count++;
+	}
+	info->last_frame = now;
+
+	/* frames retire in order, drop the oldest if done events got lost */
+	if (info->deadline_count == SDE_CRTC_FRAME_DEADLINES) {
+		info->deadline_head = (info->deadline_head + 1) %
+				SDE_CRTC_FRAME_DEADLINES;
+		info->deadline_count--;
+	}
+	idx = (info->deadline_head + info->deadline_count) %
+			SDE_CRTC_FRAME_DEADLINES;
+	info->deadline[idx] = deadline;
+	info->deadline_period[idx] = period;
+	info->deadline_count++;
+	spin_unlock_irqrestore(&info->lock, flags);
+}
+
+/**
+ * sde_crtc_account_frame_done() - Account the retire of the oldest frame
+ *	in flight against its deadline.
+ * @sde_crtc   : CRTC structure
+ * @ts         : time of the frame done event
+ *
+ * Frames retired more than an eighth of a period past their deadline count
+ * the vsyncs they slipped as missed. Content slower than the refresh rate
+ * is not counted, as only the frames that were kicked off are considered.
+ */
+static void sde_crtc_account_frame_done(struct sde_crtc *sde_crtc,
+		ktime_t ts)
+{
+	struct sde_crtc_fps_info *info = &sde_crtc->fps_info;
+	struct sde_crtc_frame_hist *hist;
+	unsigned long flags;
+	s64 late, period, slack;
+	ktime_t deadline;
+	u32 missed = 0;
 
-	if (!sde_crtc->fps_info.time_buf)
+	spin_lock_irqsave(&info->lock, flags);
+	if (!info->deadline_count) {
+		spin_unlock_irqrestore(&info->lock, flags);
 		return;
+	}
 
-	/**
-	 * Array indexing is based on sliding window algorithm.
-	 * sde_crtc->time_buf has a maximum capacity of MAX_FRAME_COUNT
-	 * time slots. As the count increases to MAX_FRAME_COUNT + 1, the
-	 * counter loops around and comes back to the first index to store
-	 * the next ktime.
-	 */
-	sde_crtc->fps_info.time_buf[sde_crtc->fps_info.next_time_index++] =
-								ktime_get();
-	sde_crtc->fps_info.next_time_index %= MAX_FRAME_COUNT;
+	deadline = info->deadline[info->deadline_head];
+	period = info->deadline_period[info->deadline_head];
+	info->deadline_head = (info->deadline_head + 1) %
+			SDE_CRTC_FRAME_DEADLINES;
+	info->deadline_count--;
+
+	if (deadline && period > 0) {
+		late = ktime_to_ns(ktime_sub(ts, deadline));
+		slack = period >> 3;
+		if (late > slack)
+			missed = 1 + div64_s64(late - slack, period);
+	}
+
+	if (missed) {
+		hist = &info->hist[info->hist_active];
+		hist->missed += missed;
+		info->total_missed += missed;
+	}
+	spin_unlock_irqrestore(&info->lock, flags);
+
+	if (missed)
+		SDE_EVT32(DRMID(&sde_crtc->base), ktime_to_us(deadline),
+				ktime_to_us(ts), missed);
 }
 
 static void _sde_crtc_deinit_events(struct sde_crtc *sde_crtc)
@@ -172,9 +419,7 @@ static void _sde_crtc_deinit_events(struct sde_crtc *sde_crtc)
 static int _sde_debugfs_fps_status_show(struct seq_file *s, void *data)
 {
 	struct sde_crtc *sde_crtc;
-	u64 fps_int, fps_float;
-	ktime_t current_time_us;
-	u64 fps, diff_us;
+	u32 fps;
 
 	if (!s || !s->private) {
 		SDE_ERROR("invalid input param(s)\n");
@@ -183,32 +428,60 @@ static int _sde_debugfs_fps_status_show(struct seq_file *s, void *data)
 
 	sde_crtc = s->private;
 
-	current_time_us = ktime_get();
-	diff_us = (u64)ktime_us_delta(current_time_us,
-			sde_crtc->fps_info.last_sampled_time_us);
+	fps = _sde_crtc_get_fps(&sde_crtc->fps_info, DEFAULT_FPS_PERIOD_1_SEC,
+			NULL);
 
-	if (diff_us >= DEFAULT_FPS_PERIOD_1_SEC) {
+	seq_printf(s, "fps: %u.%u\n", fps / 10, fps % 10);
+
+	return 0;
+}
 
-		 /* Multiplying with 10 to get fps in floating point */
-		fps = ((u64)sde_crtc->fps_info.frame_count)
-						* DEFAULT_FPS_PERIOD_1_SEC * 10;
-		do_div(fps, diff_us);
-		sde_crtc->fps_info.measured_fps = (unsigned int)fps;
-		sde_crtc->fps_info.last_sampled_time_us = current_time_us;
-		sde_crtc->fps_info.frame_count = 0;
-		SDE_DEBUG("Measured FPS for crtc%d is %d.%d\n",
-				sde_crtc->base.base.id, (unsigned int)fps/10,
-				(unsigned int)fps%10);
+static int _sde_debugfs_frame_time_show(struct seq_file *s, void *data)
+{
+	struct sde_crtc *sde_crtc;
+	struct sde_crtc_frame_hist *hist;
+	u64 lo = 0, hi;
+	u32 i;
+
+	if (!s || !s->private) {
+		SDE_ERROR("invalid input param(s)\n");
+		return -EAGAIN;
 	}
 
-	fps_int = (unsigned int) sde_crtc->fps_info.measured_fps;
-	fps_float = do_div(fps_int, 10);
+	sde_crtc = s->private;
 
-	seq_printf(s, "fps: %llu.%llu\n", fps_int, fps_float);
+	hist = kzalloc(sizeof(*hist), GFP_KERNEL);
+	if (!hist)
+		return -ENOMEM;
+
+	_sde_crtc_get_frame_hist(&sde_crtc->fps_info, hist);
+
+	seq_printf(s, "frames: %u missed_vsync: %u\n", hist->count,
+			hist->missed);
+	seq_printf(s, "p50: %lluus p95: %lluus p99: %lluus\n",
+			_sde_crtc_frame_hist_percentile(hist, 50),
+			_sde_crtc_frame_hist_percentile(hist, 95),
+			_sde_crtc_frame_hist_percentile(hist, 99));
+
+	for (i = 0; i < SDE_CRTC_FRAME_HIST_BUCKETS; i++) {
+		hi = _sde_crtc_frame_hist_bucket_max(i);
+		if (hist->buckets[i])
+			seq_printf(s, "%8llu - %8lluus: %u\n", lo, hi,
+					hist->buckets[i]);
+		lo = hi;
+	}
+
+	kfree(hist);
 
 	return 0;
 }
 
+static int _sde_debugfs_frame_time_open(struct inode *inode,
+		struct file *file)
+{
+	return single_open(file, _sde_debugfs_frame_time_show,
+			inode->i_private);
+}
 
 static int _sde_debugfs_fps_status(struct inode *inode, struct file *file)
 {
@@ -281,11 +554,8 @@ static ssize_t measured_fps_show(struct device *device,
 {
 	struct drm_crtc *crtc;
 	struct sde_crtc *sde_crtc;
-	uint64_t fps_int, fps_decimal;
-	u64 fps = 0, frame_count = 0;
-	ktime_t current_time;
-	int i = 0, current_time_index;
-	u64 diff_us;
+	u64 frame_count = 0;
+	u32 fps;
 
 	if (!device || !buf) {
 		SDE_ERROR("invalid input param(s)\n");
@@ -300,69 +570,51 @@ static ssize_t measured_fps_show(struct device *device,
 
 	sde_crtc = to_sde_crtc(crtc);
 
-	if (!sde_crtc->fps_info.time_buf) {
-		scnprintf(buf, PAGE_SIZE,
-				"timebuf null - fps information not available");
-		return -EINVAL;
-	}
+	fps = _sde_crtc_get_fps(&sde_crtc->fps_info,
+			sde_crtc->fps_info.fps_periodic_duration, &frame_count);
 
-	/**
-	 * Whenever the time_index counter comes to zero upon decrementing,
-	 * it is set to the last index since it is the next index that we
-	 * should check for calculating the buftime.
-	 */
-	current_time_index = (sde_crtc->fps_info.next_time_index == 0) ?
-		MAX_FRAME_COUNT - 1 : (sde_crtc->fps_info.next_time_index - 1);
-
-	current_time = ktime_get();
-
-	for (i = 0; i < MAX_FRAME_COUNT; i++) {
-		u64 ptime = (u64)ktime_to_us(current_time);
-		u64 buftime = (u64)ktime_to_us(
-			sde_crtc->fps_info.time_buf[current_time_index]);
-		diff_us = (u64)ktime_us_delta(current_time,
-			sde_crtc->fps_info.time_buf[current_time_index]);
-		if (ptime > buftime && diff_us >= (u64)
-				sde_crtc->fps_info.fps_periodic_duration) {
-
-			/* Multiplying with 10 to get fps in floating point */
-			fps = frame_count * DEFAULT_FPS_PERIOD_1_SEC * 10;
-			do_div(fps, diff_us);
-			sde_crtc->fps_info.measured_fps = (unsigned int)fps;
-			SDE_DEBUG("measured fps: %d\n",
-					sde_crtc->fps_info.measured_fps);
-			break;
-		}
+	return scnprintf(buf, PAGE_SIZE,
+	"fps: %u.%u duration:%d frame_count:%llu\n", fps / 10, fps % 10,
+			sde_crtc->fps_info.fps_periodic_duration, frame_count);
+}
 
-		current_time_index = (current_time_index == 0) ?
-			(MAX_FRAME_COUNT - 1) : (current_time_index - 1);
-		SDE_DEBUG("current time index: %d\n", current_time_index);
+static ssize_t frame_stats_show(struct device *device,
+		struct device_attribute *attr, char *buf)
+{
+	struct drm_crtc *crtc;
+	struct sde_crtc *sde_crtc;
+	struct sde_crtc_frame_hist *hist;
+	ssize_t len;
 
-		frame_count++;
+	if (!device || !buf) {
+		SDE_ERROR("invalid input param(s)\n");
+		return -EAGAIN;
 	}
 
-	if (i == MAX_FRAME_COUNT) {
+	crtc = dev_get_drvdata(device);
+	if (!crtc)
+		return -EINVAL;
 
-		current_time_index = (sde_crtc->fps_info.next_time_index == 0) ?
-		MAX_FRAME_COUNT - 1 : (sde_crtc->fps_info.next_time_index - 1);
+	sde_crtc = to_sde_crtc(crtc);
 
-		diff_us = (u64)ktime_us_delta(current_time,
-			sde_crtc->fps_info.time_buf[current_time_index]);
+	hist = kzalloc(sizeof(*hist), GFP_KERNEL);
+	if (!hist)
+		return -ENOMEM;
 
-		if (diff_us >= sde_crtc->fps_info.fps_periodic_duration) {
+	_sde_crtc_get_frame_hist(&sde_crtc->fps_info, hist);
 
-			/* Multiplying with 10 to get fps in floating point */
-			fps = (frame_count) * DEFAULT_FPS_PERIOD_1_SEC * 10;
-			do_div(fps, diff_us);
-			sde_crtc->fps_info.measured_fps = (unsigned int)fps;
-		}
-	}
+	len = scnprintf(buf, PAGE_SIZE,
+		"frames:%u p50:%llu p95:%llu p99:%llu missed:%u total_frames:%llu total_missed:%llu\n",
+		hist->count,
+		_sde_crtc_frame_hist_percentile(hist, 50),
+		_sde_crtc_frame_hist_percentile(hist, 95),
+		_sde_crtc_frame_hist_percentile(hist, 99),
+		hist->missed, sde_crtc->fps_info.total_frames,
+		sde_crtc->fps_info.total_missed);
 
-	fps_int = (uint64_t) sde_crtc->fps_info.measured_fps;
-	fps_decimal = do_div(fps_int, 10);
-	return scnprintf(buf, PAGE_SIZE,
-	"fps: %d.%d duration:%d frame_count:%lld\n", fps_int, fps_decimal,
-			sde_crtc->fps_info.fps_periodic_duration, frame_count);
+	kfree(hist);
+
+	return len;
 }
 
 static ssize_t vsync_event_show(struct device *device,
@@ -403,12 +655,14 @@ static DEVICE_ATTR_RO(vsync_event);
 static DEVICE_ATTR_RO(measured_fps);
 static DEVICE_ATTR_RW(fps_periodicity_ms);
 static DEVICE_ATTR_RO(retire_frame_event);
+static DEVICE_ATTR_RO(frame_stats);
 
 static struct attribute *sde_crtc_dev_attrs[] = {
 	&dev_attr_vsync_event.attr,
 	&dev_attr_measured_fps.attr,
 	&dev_attr_fps_periodicity_ms.attr,
 	&dev_attr_retire_frame_event.attr,
+	&dev_attr_frame_stats.attr,
 	NULL
 };
 
@@ -2428,6 +2682,38 @@ u32 sde_crtc_get_dfps_maxfps(struct drm_crtc *crtc)
 	return 0;
 }
 
+/**
+ * _sde_crtc_vsync_predict_notify - send the predicted time of the next vsync
+ *	of the first encoder of the crtc that has a settled vsync model
+ * @crtc: Pointer to drm crtc structure
+ */
+static void _sde_crtc_vsync_predict_notify(struct drm_crtc *crtc)
+{
+	struct drm_encoder *encoder;
+	struct drm_event event;
+	struct drm_msm_vsync_predict predict = {0};
+	ktime_t next_vsync = 0;
+	s64 period = 0;
+
+	drm_for_each_encoder_mask(encoder, crtc->dev,
+			crtc->state->encoder_mask) {
+		next_vsync = sde_encoder_get_next_vsync(encoder, &period);
+		if (next_vsync)
+			break;
+	}
+
+	if (!next_vsync)
+		return;
+
+	predict.next_vsync_ns = ktime_to_ns(next_vsync);
+	predict.period_ns = period;
+
+	event.type = DRM_EVENT_VSYNC_PREDICT;
+	event.length = sizeof(predict);
+	msm_mode_object_event_notify(&crtc->base, crtc->dev, &event,
+			(u8 *)&predict);
+}
+
 static void sde_crtc_vblank_cb(void *data)
 {
 	struct drm_crtc *crtc = (struct drm_crtc *)data;
@@ -2442,6 +2728,9 @@ static void sde_crtc_vblank_cb(void *data)
 	sde_crtc->vblank_last_cb_time = ktime_get();
 	sysfs_notify_dirent(sde_crtc->vsync_event_sf);
 
+	if (READ_ONCE(sde_crtc->vsync_predict_en))
+		_sde_crtc_vsync_predict_notify(crtc);
+
 	drm_crtc_handle_vblank(crtc);
 	DRM_DEBUG_VBL("crtc%d\n", crtc->base.id);
 	SDE_EVT32_VERBOSE(DRMID(crtc));
@@ -2523,6 +2812,8 @@ static void sde_crtc_frame_event_work(struct kthread_work *work)
 			SDE_EVT32_VERBOSE(DRMID(crtc), fevent->event,
 							SDE_EVTLOG_FUNC_CASE3);
 		}
+
+		sde_crtc_account_frame_done(sde_crtc, fevent->ts);
 	}
 
 	if (fevent->event & SDE_ENCODER_FRAME_EVENT_SIGNAL_RELEASE_FENCE) {
@@ -3044,16 +3335,119 @@ err:
 	return ret;
 }
 
+static void _sde_crtc_input_fence_cb(struct dma_fence *fence,
+		struct dma_fence_cb *cb)
+{
+	struct sde_crtc_fence_cb *fcb =
+			container_of(cb, struct sde_crtc_fence_cb, cb);
+	struct sde_crtc_fence_wait *wait = fcb->wait;
+
+	if (atomic_dec_and_test(&wait->pending)) {
+		wait->straggler = fcb->plane;
+		wake_up(&wait->wq);
+	}
+}
+
+/**
+ * _sde_crtc_arm_fence_cbs - arm a callback on every pending input fence
+ * @crtc: Pointer to CRTC object
+ * @wait: Pointer to the fence wait of the crtc
+ * Returns: number of callbacks armed
+ */
+static u32 _sde_crtc_arm_fence_cbs(struct drm_crtc *crtc,
+		struct sde_crtc_fence_wait *wait)
+{
+	struct drm_plane *plane = NULL;
+	struct sde_crtc_fence_cb *fcb;
+	struct dma_fence *fence;
+	u32 count = 0;
+
+	/* bias the count so that it cannot drop to zero while arming */
+	atomic_set(&wait->pending, 1);
+	wait->straggler = NULL;
+
+	drm_atomic_crtc_for_each_plane(plane, crtc) {
+		if (!plane->state || count >= ARRAY_SIZE(wait->cbs))
+			continue;
+
+		fence = to_sde_plane_state(plane->state)->input_fence;
+		if (!fence)
+			continue;
+
+		fcb = &wait->cbs[count];
+		fcb->fence = fence;
+		fcb->plane = plane;
+		fcb->wait = wait;
+
+		atomic_inc(&wait->pending);
+		if (dma_fence_add_callback(fence, &fcb->cb,
+				_sde_crtc_input_fence_cb)) {
+			/* already signaled */
+			atomic_dec(&wait->pending);
+			continue;
+		}
+
+		count++;
+	}
+
+	if (atomic_dec_and_test(&wait->pending) && count)
+		wait->straggler = wait->cbs[count - 1].plane;
+
+	return count;
+}
+
+int sde_crtc_prewait_input_fences(struct drm_crtc *crtc,
+		struct drm_crtc_state *state)
+{
+	struct drm_plane *plane;
+	const struct drm_plane_state *pstate;
+	void *input_fence;
+	ktime_t kt_end;
+	s64 remain_ms;
+
+	if (!crtc || !state) {
+		SDE_ERROR("invalid crtc/state %pK\n", crtc);
+		return -EINVAL;
+	}
+
+	kt_end = ktime_add_ns(ktime_get(),
+			to_sde_crtc_state(state)->input_fence_timeout_ns);
+
+	/*
+	 * Errors are left to _sde_crtc_wait_for_fences, which waits for
+	 * the same fences again once the commit is kicked off.
+	 */
+	drm_atomic_crtc_state_for_each_plane_state(plane, pstate, state) {
+		input_fence = to_sde_plane_state(pstate)->input_fence;
+		if (!input_fence)
+			continue;
+
+		remain_ms = ktime_ms_delta(kt_end, ktime_get());
+		if (remain_ms <= 0 ||
+				sde_sync_wait(input_fence, remain_ms) <= 0) {
+			SDE_EVT32(DRMID(crtc), DRMID(plane), SDE_EVTLOG_ERROR);
+			return -ETIMEDOUT;
+		}
+	}
+
+	SDE_EVT32_VERBOSE(DRMID(crtc));
+	return 0;
+}
+
 /**
  * _sde_crtc_wait_for_fences - wait for incoming framebuffer sync fences
  * @crtc: Pointer to CRTC object
  */
 static void _sde_crtc_wait_for_fences(struct drm_crtc *crtc)
 {
+	struct sde_crtc *sde_crtc;
+	struct sde_crtc_fence_wait *wait;
+	struct sde_crtc_fence_cb *fcb;
 	struct drm_plane *plane = NULL;
-	uint32_t wait_ms = 1;
-	ktime_t kt_end, kt_wait;
-	int rc = 0;
+	ktime_t kt_start, kt_end;
+	bool timedout = false;
+	u32 i, count, straggler = 0;
+	s64 wait_us;
 
 	SDE_DEBUG("\n");
 
@@ -3062,33 +3456,62 @@ static void _sde_crtc_wait_for_fences(struct drm_crtc *crtc)
 		return;
 	}
 
+	sde_crtc = to_sde_crtc(crtc);
+	wait = &sde_crtc->fence_wait;
+
 	/* use monotonic timer to limit total fence wait time */
-	kt_end = ktime_add_ns(ktime_get(),
+	kt_start = ktime_get();
+	kt_end = ktime_add_ns(kt_start,
 		to_sde_crtc_state(crtc->state)->input_fence_timeout_ns);
 
 	/*
-	 * Wait for fences sequentially, as all of them need to be signalled
-	 * before we can proceed.
-	 *
-	 * Limit total wait time to INPUT_FENCE_TIMEOUT, but still call
-	 * sde_plane_wait_input_fence with wait_ms == 0 after the timeout so
-	 * that each plane can check its fence status and react appropriately
-	 * if its fence has timed out. Call input fence wait multiple times if
-	 * fence wait is interrupted due to interrupt call.
+	 * All fences need to be signalled before we can proceed, so arm a
+	 * callback on each of them and sleep until the last one fires
+	 * rather than waiting for them one after the other. The planes
+	 * are already programmed at this point, only the flush waits.
 	 */
 	SDE_ATRACE_BEGIN("plane_wait_input_fence");
-	drm_atomic_crtc_for_each_plane(plane, crtc) {
-		do {
-			kt_wait = ktime_sub(kt_end, ktime_get());
-			if (ktime_compare(kt_wait, ktime_set(0, 0)) >= 0)
-				wait_ms = ktime_to_ms(kt_wait);
-			else
-				wait_ms = 0;
+	count = _sde_crtc_arm_fence_cbs(crtc, wait);
+	if (count && atomic_read(&wait->pending))
+		timedout = !wait_event_timeout(wait->wq,
+				!atomic_read(&wait->pending),
+				nsecs_to_jiffies(ktime_to_ns(
+				ktime_sub(kt_end, kt_start))));
 
-			rc = sde_plane_wait_input_fence(plane, wait_ms);
-		} while (wait_ms && rc == -ERESTARTSYS);
+	for (i = 0; i < count; i++) {
+		fcb = &wait->cbs[i];
+
+		/* a callback still armed means its fence has not signaled */
+		if (dma_fence_remove_callback(fcb->fence, &fcb->cb) &&
+				!straggler)
+			straggler = DRMID(fcb->plane);
 	}
+
+	if (!straggler && wait->straggler)
+		straggler = DRMID(wait->straggler);
+
+	/*
+	 * Still call sde_plane_wait_input_fence with wait_ms == 0 so that
+	 * each plane can check its fence status and react appropriately
+	 * if its fence has timed out.
+	 */
+	drm_atomic_crtc_for_each_plane(plane, crtc)
+		sde_plane_wait_input_fence(plane, 0);
 	SDE_ATRACE_END("plane_wait_input_fence");
+
+	if (!count)
+		return;
+
+	wait_us = ktime_us_delta(ktime_get(), kt_start);
+	wait->commits++;
+	wait->timeouts += timedout;
+	wait->total_us += wait_us;
+	wait->max_us = max_t(u32, wait->max_us, wait_us);
+	wait->last_us = wait_us;
+	wait->last_fences = count;
+	wait->last_straggler = straggler;
+
+	SDE_EVT32(DRMID(crtc), count, wait_us, straggler, timedout);
 }
 
 static void _sde_crtc_setup_mixer_for_encoder(
@@ -4201,6 +4624,10 @@ static void sde_crtc_disable(struct drm_crtc *crtc)
 		atomic_set(&sde_crtc->frame_pending, 0);
 	}
 
+	spin_lock_irqsave(&sde_crtc->fps_info.lock, flags);
+	sde_crtc->fps_info.deadline_count = 0;
+	spin_unlock_irqrestore(&sde_crtc->fps_info.lock, flags);
+
 	spin_lock_irqsave(&sde_crtc->spin_lock, flags);
 	list_for_each_entry(node, &sde_crtc->user_event_list, list) {
 		ret = 0;
@@ -6226,6 +6653,17 @@ static int _sde_debugfs_fence_status_show(struct seq_file *s, void *data)
 	}
 
 skip_input_fence:
+	seq_puts(s, "===Input fence wait===\n");
+	seq_printf(s, "wait commits:%llu timeouts:%llu avg:%lluus max:%uus\n",
+		sde_crtc->fence_wait.commits, sde_crtc->fence_wait.timeouts,
+		sde_crtc->fence_wait.commits ?
+		div64_u64(sde_crtc->fence_wait.total_us,
+			sde_crtc->fence_wait.commits) : 0,
+		sde_crtc->fence_wait.max_us);
+	seq_printf(s, "last wait:%uus fences:%u straggler plane:%u\n",
+		sde_crtc->fence_wait.last_us, sde_crtc->fence_wait.last_fences,
+		sde_crtc->fence_wait.last_straggler);
+
 	/* Dump release fence info */
 	seq_puts(s, "\n");
 	seq_puts(s, "===Release fence===\n");
@@ -6279,6 +6717,12 @@ static int _sde_crtc_init_debugfs(struct drm_crtc *crtc)
 		.open =		_sde_debugfs_fps_status,
 		.read =		seq_read,
 	};
+	static const struct file_operations debugfs_frame_time_fops = {
+		.open =		_sde_debugfs_frame_time_open,
+		.read =		seq_read,
+		.llseek =	seq_lseek,
+		.release =	single_release,
+	};
 	static const struct file_operations debugfs_fence_fops = {
 		.open =		_sde_debugfs_fence_status,
 		.read =		seq_read,
@@ -6309,6 +6753,8 @@ static int _sde_crtc_init_debugfs(struct drm_crtc *crtc)
 					sde_crtc, &debugfs_misr_fops);
 	debugfs_create_file("fps", 0400, sde_crtc->debugfs_root,
 					sde_crtc, &debugfs_fps_fops);
+	debugfs_create_file("frame_time", 0400, sde_crtc->debugfs_root,
+					sde_crtc, &debugfs_frame_time_fops);
 	debugfs_create_file("fence_status", 0400, sde_crtc->debugfs_root,
 					sde_crtc, &debugfs_fence_fops);
 
@@ -6654,15 +7100,11 @@ struct drm_crtc *sde_crtc_init(struct drm_device *dev, struct drm_plane *plane)
 	sde_crtc->kickoff_in_progress = false;
 
 	/* Below parameters are for fps calculation for sysfs node */
+	BUILD_BUG_ON(SDE_CRTC_FPS_SLOTS * SDE_CRTC_FPS_SLOT_US <
+			MAX_FPS_PERIOD_5_SECONDS);
+	spin_lock_init(&sde_crtc->fps_info.lock);
+	init_waitqueue_head(&sde_crtc->fence_wait.wq);
 	sde_crtc->fps_info.fps_periodic_duration = DEFAULT_FPS_PERIOD_1_SEC;
-	sde_crtc->fps_info.time_buf = kmalloc_array(MAX_FRAME_COUNT,
-			sizeof(ktime_t), GFP_KERNEL);
-
-	if (!sde_crtc->fps_info.time_buf)
-		SDE_ERROR("invalid buffer\n");
-	else
-		memset(sde_crtc->fps_info.time_buf, 0,
-			sizeof(*(sde_crtc->fps_info.time_buf)));
 
 	INIT_LIST_HEAD(&sde_crtc->frame_event_list);
 	INIT_LIST_HEAD(&sde_crtc->user_event_list);
@@ -6952,6 +7394,17 @@ static int sde_crtc_idle_interrupt_handler(struct drm_crtc *crtc_drm,
 	return 0;
 }
 
+static int sde_crtc_vsync_predict_event_handler(struct drm_crtc *crtc,
+		bool en, struct sde_irq_callback *noirq)
+{
+	/*
+	 * The prediction is sent from the vblank callback, there is no irq
+	 * of its own to register.
+	 */
+	WRITE_ONCE(to_sde_crtc(crtc)->vsync_predict_en, en);
+	return 0;
+}
+
 /**
  * sde_crtc_update_cont_splash_settings - update mixer settings
  *	and initial clk during device bootup for cont_splash use case
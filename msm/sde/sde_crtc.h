@@ -21,6 +21,7 @@
 #define _SDE_CRTC_H_
 
 #include <linux/kthread.h>
+#include <linux/dma-fence.h>
 #include <linux/of_fdt.h>
 #include <drm/drm_crtc.h>
 #include "msm_prop.h"
@@ -165,24 +166,113 @@ struct sde_crtc_event {
 	void (*cb_func)(struct drm_crtc *crtc, void *usr);
 	void *usr;
 };
+/* frames counted per slot of the sliding fps window */
+#define SDE_CRTC_FPS_SLOT_US		100000
+#define SDE_CRTC_FPS_SLOTS		50
+
+/* retire deadlines kept for the frames in flight */
+#define SDE_CRTC_FRAME_DEADLINES	4
+
+/*
+ * Frame interval histogram buckets: each octave from 2^MIN_SHIFT us is
+ * split into 2^SUB_BITS linear buckets, the first and last bucket also
+ * hold the intervals below and above the covered range.
+ */
+#define SDE_CRTC_FRAME_HIST_MIN_SHIFT	10
+#define SDE_CRTC_FRAME_HIST_SUB_BITS	3
+#define SDE_CRTC_FRAME_HIST_OCTAVES	12
+#define SDE_CRTC_FRAME_HIST_BUCKETS	\
+	(SDE_CRTC_FRAME_HIST_OCTAVES << SDE_CRTC_FRAME_HIST_SUB_BITS)
+
+/**
+ * struct sde_crtc_frame_hist - frame intervals of one histogram window
+ * @buckets	: number of intervals in each bucket
+ * @count	: number of intervals recorded
+ * @missed	: number of vsyncs frames were retired past their deadline
+ */
+struct sde_crtc_frame_hist {
+	u32 buckets[SDE_CRTC_FRAME_HIST_BUCKETS];
+	u32 count;
+	u32 missed;
+};
+
 /**
  * struct sde_crtc_fps_info - structure for measuring fps periodicity
- * @frame_count		: Total frames during configured periodic duration
- * @last_sampled_time_us: Stores the last ktime in microsecs when fps
- *                        was calculated
- * @measured_fps	: Last measured fps value
- * @fps_periodic_duration	: Duration in milliseconds to measure the fps.
+ * @lock		: protects the counters against concurrent readers
+ * @fps_periodic_duration	: Duration in microseconds to measure the fps.
  *                                Default value is 1 second.
- * @time_buf		: Buffer for storing ktime of the commits
- * @next_time_index	: index into time_buf for storing ktime for next commit
+ * @slot_frames		: frames committed in each slot of the fps window
+ * @slot		: absolute index of the newest slot
+ * @last_frame		: ktime of the previous commit
+ * @hist		: frame interval histograms of the current and the
+ *			  previous window
+ * @hist_active		: index of the histogram of the current window
+ * @hist_start		: ktime the current histogram window started
+ * @total_frames	: frames committed since boot
+ * @total_missed	: vsyncs missed since boot
+ * @deadline		: retire deadlines of the frames in flight, oldest first
+ * @deadline_period	: vsync period of each deadline in ns, 0 if unknown
+ * @deadline_head	: index of the oldest deadline
+ * @deadline_count	: number of frames in flight with a deadline
  */
 struct sde_crtc_fps_info {
-	u32 frame_count;
-	ktime_t last_sampled_time_us;
-	u32 measured_fps;
+	spinlock_t lock;
 	u32 fps_periodic_duration;
-	ktime_t *time_buf;
-	u32 next_time_index;
+	u16 slot_frames[SDE_CRTC_FPS_SLOTS];
+	u64 slot;
+	ktime_t last_frame;
+	struct sde_crtc_frame_hist hist[2];
+	u32 hist_active;
+	ktime_t hist_start;
+	u64 total_frames;
+	u64 total_missed;
+	ktime_t deadline[SDE_CRTC_FRAME_DEADLINES];
+	s64 deadline_period[SDE_CRTC_FRAME_DEADLINES];
+	u32 deadline_head;
+	u32 deadline_count;
+};
+
+/**
+ * struct sde_crtc_fence_cb - callback armed on the input fence of a plane
+ * @cb		: dma fence callback
+ * @fence	: input fence the callback is armed on
+ * @plane	: plane the input fence belongs to
+ * @wait	: wait the callback reports to
+ */
+struct sde_crtc_fence_cb {
+	struct dma_fence_cb cb;
+	struct dma_fence *fence;
+	struct drm_plane *plane;
+	struct sde_crtc_fence_wait *wait;
+};
+
+/**
+ * struct sde_crtc_fence_wait - wait for all input fences of a commit
+ * @wq		: woken up when the last armed fence signals
+ * @pending	: number of armed fences that have not signaled yet
+ * @straggler	: plane whose input fence signaled last
+ * @cbs		: callbacks armed on the input fences
+ * @commits	: commits that had at least one input fence to wait for
+ * @timeouts	: commits whose input fences did not all signal in time
+ * @total_us	: total time spent waiting
+ * @max_us	: longest wait of a commit
+ * @last_us	: wait of the latest commit
+ * @last_fences	: number of fences waited for in the latest commit
+ * @last_straggler : drm id of the straggler of the latest commit
+ */
+struct sde_crtc_fence_wait {
+	wait_queue_head_t wq;
+	atomic_t pending;
+	struct drm_plane *straggler;
+	struct sde_crtc_fence_cb cbs[MAX_PLANES];
+
+	u64 commits;
+	u64 timeouts;
+	u64 total_us;
+	u32 max_us;
+	u32 last_us;
+	u32 last_fences;
+	u32 last_straggler;
 };
 
 /**
@@ -245,6 +335,7 @@ struct sde_crtc_misr_info {
  * @play_count    : frame count between crtc enable and disable
  * @vblank_cb_time  : ktime at vblank count reset
  * @vblank_last_cb_time  : ktime at last vblank notification
+ * @vsync_predict_en : whether the vsync prediction event is sent on vblank
  * @retire_frame_event_time  : ktime at last retire frame event
  * @sysfs_dev  : sysfs device node for crtc
  * @vsync_event_sf : vsync event notifier sysfs device
@@ -299,6 +390,7 @@ struct sde_crtc_misr_info {
  * @cache_state     : Current static image cache state
  * @dspp_blob_info  : blob containing dspp hw capability information
  * @cached_encoder_mask : cached encoder_mask for vblank work
+ * @fence_wait      : input fence wait of the commit thread
  */
 struct sde_crtc {
 	struct drm_crtc base;
@@ -327,6 +419,7 @@ struct sde_crtc {
 	u64 play_count;
 	ktime_t vblank_cb_time;
 	ktime_t vblank_last_cb_time;
+	bool vsync_predict_en;
 	ktime_t retire_frame_event_time;
 	struct sde_crtc_fps_info fps_info;
 	struct device *sysfs_dev;
@@ -395,6 +488,7 @@ struct sde_crtc {
 
 	struct drm_property_blob *dspp_blob_info;
 	u32 cached_encoder_mask;
+	struct sde_crtc_fence_wait fence_wait;
 };
 
 enum sde_crtc_dirty_flags {
@@ -620,6 +714,16 @@ void sde_crtc_commit_kickoff(struct drm_crtc *crtc,
 void sde_crtc_prepare_commit(struct drm_crtc *crtc,
 		struct drm_crtc_state *old_state);
 
+/**
+ * sde_crtc_prewait_input_fences - wait for the input fences of a commit
+ *	queued behind the one in flight, before its state is swapped in
+ * @crtc: Pointer to drm crtc object
+ * @state: Pointer to the new drm crtc state of the queued commit
+ * Returns: Zero once every fence signaled, error code otherwise
+ */
+int sde_crtc_prewait_input_fences(struct drm_crtc *crtc,
+		struct drm_crtc_state *state);
+
 /**
  * sde_crtc_complete_commit - callback signalling completion of current commit
  * @crtc: Pointer to drm crtc object
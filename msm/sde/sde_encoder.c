@@ -402,6 +402,18 @@ int sde_encoder_helper_wait_for_irq(struct sde_encoder_phys *phys_enc,
 	return ret;
 }
 
+static int _sde_encoder_helper_unregister_irq_cb(
+		struct sde_encoder_phys *phys_enc, struct sde_encoder_irq *irq)
+{
+	/* the callback is either the fast path handler or on the list */
+	if (irq->fast && !sde_core_irq_unregister_fast_callback(
+			phys_enc->sde_kms, irq->irq_idx, &irq->cb))
+		return 0;
+
+	return sde_core_irq_unregister_callback(phys_enc->sde_kms,
+			irq->irq_idx, &irq->cb);
+}
+
 int sde_encoder_helper_register_irq(struct sde_encoder_phys *phys_enc,
 		enum sde_intr_idx intr_idx)
 {
@@ -430,8 +442,13 @@ int sde_encoder_helper_register_irq(struct sde_encoder_phys *phys_enc,
 		return -EINVAL;
 	}
 
-	ret = sde_core_irq_register_callback(phys_enc->sde_kms, irq->irq_idx,
-			&irq->cb);
+	ret = -EBUSY;
+	if (irq->fast)
+		ret = sde_core_irq_register_fast_callback(phys_enc->sde_kms,
+				irq->irq_idx, &irq->cb, irq->name);
+	if (ret)
+		ret = sde_core_irq_register_callback(phys_enc->sde_kms,
+				irq->irq_idx, &irq->cb);
 	if (ret) {
 		SDE_ERROR_PHYS(phys_enc,
 			"failed to register IRQ callback for %s\n",
@@ -446,8 +463,7 @@ int sde_encoder_helper_register_irq(struct sde_encoder_phys *phys_enc,
 			"enable IRQ for intr:%s failed, irq_idx %d\n",
 			irq->name, irq->irq_idx);
 
-		sde_core_irq_unregister_callback(phys_enc->sde_kms,
-				irq->irq_idx, &irq->cb);
+		_sde_encoder_helper_unregister_irq_cb(phys_enc, irq);
 
 		SDE_EVT32(DRMID(phys_enc->parent), intr_idx, irq->hw_idx,
 				irq->irq_idx, SDE_EVTLOG_ERROR);
@@ -490,8 +506,7 @@ int sde_encoder_helper_unregister_irq(struct sde_encoder_phys *phys_enc,
 		SDE_EVT32(DRMID(phys_enc->parent), intr_idx, irq->hw_idx,
 				irq->irq_idx, ret, SDE_EVTLOG_ERROR);
 
-	ret = sde_core_irq_unregister_callback(phys_enc->sde_kms, irq->irq_idx,
-			&irq->cb);
+	ret = _sde_encoder_helper_unregister_irq_cb(phys_enc, irq);
 	if (ret)
 		SDE_EVT32(DRMID(phys_enc->parent), intr_idx, irq->hw_idx,
 				irq->irq_idx, ret, SDE_EVTLOG_ERROR);
@@ -1980,6 +1995,8 @@ static int _sde_encoder_rc_early_wakeup(struct drm_encoder *drm_enc,
 {
 	bool autorefresh_enabled = false;
 	struct msm_drm_thread *disp_thread;
+	ktime_t next_vsync;
+	s64 vsync_us = -1;
 	int ret = 0;
 
 	if (!sde_enc->crtc ||
@@ -2013,6 +2030,11 @@ static int _sde_encoder_rc_early_wakeup(struct drm_encoder *drm_enc,
 					&sde_enc->delayed_off_work,
 					msecs_to_jiffies(
 					IDLE_POWERCOLLAPSE_DURATION));
+
+		/* lead time the commit has before the next vsync */
+		next_vsync = sde_encoder_get_next_vsync(drm_enc, NULL);
+		if (next_vsync)
+			vsync_us = ktime_us_delta(next_vsync, ktime_get());
 	} else if (sde_enc->rc_state == SDE_ENC_RC_STATE_IDLE) {
 		/* enable all the clks and resources */
 		ret = _sde_encoder_resource_control_helper(drm_enc,
@@ -2045,7 +2067,7 @@ static int _sde_encoder_rc_early_wakeup(struct drm_encoder *drm_enc,
 	}
 
 	SDE_EVT32(DRMID(drm_enc), sw_event, sde_enc->rc_state,
-			SDE_ENC_RC_STATE_ON, SDE_EVTLOG_FUNC_CASE8);
+			SDE_ENC_RC_STATE_ON, vsync_us, SDE_EVTLOG_FUNC_CASE8);
 
 end:
 	mutex_unlock(&sde_enc->rc_lock);
@@ -2307,6 +2329,30 @@ static int sde_encoder_virt_modeset_rc(struct drm_encoder *drm_enc,
 	return 0;
 }
 
+static void _sde_encoder_vsync_model_reset(struct sde_encoder_virt *sde_enc)
+{
+	struct sde_encoder_vsync_model *model = &sde_enc->vsync_model;
+	struct msm_mode_info *info = &sde_enc->mode_info;
+	u64 l_bound = 0, u_bound = 0;
+	unsigned long lock_flags;
+
+	if (info->frame_rate && info->jitter_denom)
+		sde_encoder_helper_get_jitter_bounds_ns(&sde_enc->base,
+				&l_bound, &u_bound);
+
+	/* without a jitter window no interval would ever be accepted */
+	if (l_bound >= u_bound)
+		u_bound = 0;
+
+	spin_lock_irqsave(&sde_enc->enc_spinlock, lock_flags);
+	model->head = 0;
+	model->count = 0;
+	model->period_ns = 0;
+	model->l_bound = l_bound;
+	model->u_bound = u_bound;
+	spin_unlock_irqrestore(&sde_enc->enc_spinlock, lock_flags);
+}
+
 static void sde_encoder_virt_mode_set(struct drm_encoder *drm_enc,
 				      struct drm_display_mode *mode,
 				      struct drm_display_mode *adj_mode)
@@ -2359,6 +2405,7 @@ static void sde_encoder_virt_mode_set(struct drm_encoder *drm_enc,
 
 	sde_connector_state_get_mode_info(conn->state, &sde_enc->mode_info);
 	sde_encoder_dce_set_bpp(sde_enc->mode_info, sde_enc->crtc);
+	_sde_encoder_vsync_model_reset(sde_enc);
 
 	/* cancel delayed off work, if any */
 	kthread_cancel_delayed_work_sync(&sde_enc->delayed_off_work);
@@ -2868,6 +2915,7 @@ void sde_encoder_virt_reset(struct drm_encoder *drm_enc)
 	 */
 	sde_enc->crtc = NULL;
 	memset(&sde_enc->mode_info, 0, sizeof(sde_enc->mode_info));
+	_sde_encoder_vsync_model_reset(sde_enc);
 
 	SDE_DEBUG_ENC(sde_enc, "encoder disabled\n");
 
@@ -3097,6 +3145,104 @@ void sde_encoder_perf_uidle_status(struct sde_kms *sde_kms,
 	}
 }
 
+static void _sde_encoder_vsync_model_fit(struct sde_encoder_vsync_model *model)
+{
+	ktime_t first = model->ts[model->head];
+	s64 d, x2, sum_d = 0, sxy = 0, sxx = 0;
+	u32 i, n = model->count;
+
+	/*
+	 * x2 is twice the distance of a sample index to the mean index, which
+	 * keeps the centered fit in integers for both odd and even counts
+	 */
+	for (i = 0; i < n; i++) {
+		d = ktime_to_ns(ktime_sub(model->ts[(model->head + i) %
+				SDE_ENC_VSYNC_MODEL_SAMPLES], first));
+		x2 = 2 * (s64)i - (n - 1);
+
+		sum_d += d;
+		sxy += x2 * d;
+		sxx += x2 * x2;
+	}
+
+	model->period_ns = div64_s64(2 * sxy, sxx);
+	model->last = ktime_add(first, ns_to_ktime(div_s64(sum_d, n) +
+			div64_s64(sxy * (n - 1), sxx)));
+}
+
+static void _sde_encoder_vsync_model_update(
+		struct sde_encoder_vsync_model *model, ktime_t ts)
+{
+	u32 tail;
+	s64 interval;
+
+	if (!model->u_bound)
+		return;
+
+	model->samples++;
+
+	if (model->count) {
+		tail = (model->head + model->count - 1) %
+				SDE_ENC_VSYNC_MODEL_SAMPLES;
+		interval = ktime_to_ns(ktime_sub(ts, model->ts[tail]));
+		if (interval < (s64)model->l_bound ||
+				interval > (s64)model->u_bound) {
+			model->head = 0;
+			model->count = 0;
+			model->period_ns = 0;
+			model->resets++;
+		}
+	}
+
+	if (model->count < SDE_ENC_VSYNC_MODEL_SAMPLES) {
+		model->ts[(model->head + model->count) %
+				SDE_ENC_VSYNC_MODEL_SAMPLES] = ts;
+		model->count++;
+	} else {
+		model->ts[model->head] = ts;
+		model->head = (model->head + 1) % SDE_ENC_VSYNC_MODEL_SAMPLES;
+	}
+
+	if (model->count >= SDE_ENC_VSYNC_MODEL_MIN_SAMPLES)
+		_sde_encoder_vsync_model_fit(model);
+}
+
+ktime_t sde_encoder_get_next_vsync(struct drm_encoder *drm_enc, s64 *period_ns)
+{
+	struct sde_encoder_virt *sde_enc;
+	unsigned long lock_flags;
+	s64 period, elapsed, frames = 0;
+	ktime_t last;
+
+	if (!drm_enc) {
+		SDE_ERROR("invalid encoder\n");
+		return 0;
+	}
+
+	sde_enc = to_sde_encoder_virt(drm_enc);
+
+	spin_lock_irqsave(&sde_enc->enc_spinlock, lock_flags);
+	period = sde_enc->vsync_model.period_ns;
+	last = sde_enc->vsync_model.last;
+	spin_unlock_irqrestore(&sde_enc->enc_spinlock, lock_flags);
+
+	if (period <= 0)
+		return 0;
+
+	/* the fit error grows with every frame extrapolated past the window */
+	elapsed = ktime_to_ns(ktime_sub(ktime_get(), last));
+	if (elapsed > period * SDE_ENC_VSYNC_MODEL_SAMPLES)
+		return 0;
+
+	if (elapsed > 0)
+		frames = div64_s64(elapsed, period);
+
+	if (period_ns)
+		*period_ns = period;
+
+	return ktime_add_ns(last, (frames + 1) * period);
+}
+
 static void sde_encoder_vblank_callback(struct drm_encoder *drm_enc,
 		struct sde_encoder_phys *phy_enc)
 {
@@ -3110,6 +3256,9 @@ static void sde_encoder_vblank_callback(struct drm_encoder *drm_enc,
 	sde_enc = to_sde_encoder_virt(drm_enc);
 
 	spin_lock_irqsave(&sde_enc->enc_spinlock, lock_flags);
+	if (phy_enc == sde_enc->cur_master)
+		_sde_encoder_vsync_model_update(&sde_enc->vsync_model,
+				ktime_get());
 	if (sde_enc->crtc_vblank_cb)
 		sde_enc->crtc_vblank_cb(sde_enc->crtc_vblank_cb_data);
 	spin_unlock_irqrestore(&sde_enc->enc_spinlock, lock_flags);
@@ -3599,8 +3748,15 @@ static void _sde_encoder_kickoff_phys(struct sde_encoder_virt *sde_enc,
 				ctl->ops.reg_dma_flush(ctl, is_regdma_blocking);
 			_sde_encoder_trigger_flush(&sde_enc->base, phys, 0x0,
 					config_changed);
-		} else if (ctl->ops.get_pending_flush) {
-			ctl->ops.get_pending_flush(ctl, &pending_flush);
+		} else {
+			/* only the master ctl sends the reg dma last command */
+			if (config_changed && sde_enc->cur_master &&
+					ctl != sde_enc->cur_master->hw_ctl &&
+					ctl->ops.reg_dma_kickoff_pending)
+				ctl->ops.reg_dma_kickoff_pending(ctl);
+			if (ctl->ops.get_pending_flush)
+				ctl->ops.get_pending_flush(ctl,
+						&pending_flush);
 		}
 	}
 
@@ -3947,9 +4103,11 @@ int sde_encoder_poll_line_counts(struct drm_encoder *drm_enc)
 {
 	static const uint64_t timeout_us = 50000;
 	static const uint64_t sleep_us = 20;
+	static const uint64_t margin_us = 500;
 	struct sde_encoder_virt *sde_enc;
-	ktime_t cur_ktime, exp_ktime;
+	ktime_t cur_ktime, exp_ktime, next_vsync;
 	uint32_t line_count, tmp, i;
+	s64 wait_us;
 
 	if (!drm_enc) {
 		SDE_ERROR("invalid encoder\n");
@@ -3963,6 +4121,15 @@ int sde_encoder_poll_line_counts(struct drm_encoder *drm_enc)
 		return -EINVAL;
 	}
 
+	/* sleep through the frame if the start of the next one is known */
+	next_vsync = sde_encoder_get_next_vsync(drm_enc, NULL);
+	if (next_vsync) {
+		wait_us = ktime_us_delta(next_vsync, ktime_get()) - margin_us;
+		if (wait_us > 0)
+			usleep_range(wait_us, wait_us + sleep_us);
+		SDE_EVT32(DRMID(drm_enc), wait_us);
+	}
+
 	exp_ktime = ktime_add_ms(ktime_get(), timeout_us / 1000);
 
 	line_count = sde_enc->cur_master->ops.get_line_count(
@@ -4458,6 +4625,10 @@ int sde_encoder_helper_collect_misr(struct sde_encoder_phys *phys_enc,
 static int _sde_encoder_status_show(struct seq_file *s, void *data)
 {
 	struct sde_encoder_virt *sde_enc;
+	u64 samples, resets;
+	unsigned long lock_flags;
+	ktime_t next_vsync;
+	s64 period;
 	int i;
 
 	if (!s || !s->private)
@@ -4465,6 +4636,18 @@ static int _sde_encoder_status_show(struct seq_file *s, void *data)
 
 	sde_enc = s->private;
 
+	spin_lock_irqsave(&sde_enc->enc_spinlock, lock_flags);
+	period = sde_enc->vsync_model.period_ns;
+	samples = sde_enc->vsync_model.samples;
+	resets = sde_enc->vsync_model.resets;
+	spin_unlock_irqrestore(&sde_enc->enc_spinlock, lock_flags);
+
+	next_vsync = sde_encoder_get_next_vsync(&sde_enc->base, NULL);
+	seq_printf(s, "vsync period:%lldns samples:%llu resets:%llu ",
+			period, samples, resets);
+	seq_printf(s, "next:%lldus\n", next_vsync ?
+			ktime_us_delta(next_vsync, ktime_get()) : -1LL);
+
 	mutex_lock(&sde_enc->enc_lock);
 	for (i = 0; i < sde_enc->num_phys_encs; i++) {
 		struct sde_encoder_phys *phys = sde_enc->phys_encs[i];
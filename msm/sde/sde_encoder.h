@@ -50,6 +50,10 @@
 #define IDLE_POWERCOLLAPSE_DURATION	(66 - 16/2)
 #define IDLE_POWERCOLLAPSE_IN_EARLY_WAKEUP (200 - 16/2)
 
+/* vsync timestamps fitted by the vsync model */
+#define SDE_ENC_VSYNC_MODEL_SAMPLES	16
+#define SDE_ENC_VSYNC_MODEL_MIN_SAMPLES	4
+
 /**
  * Encoder functions and data types
  * @intfs:	Interfaces this encoder is using, INTF_MODE_NONE if unused
@@ -84,6 +88,31 @@ struct sde_encoder_kickoff_params {
 	enum frame_trigger_mode_type frame_trigger_mode;
 };
 
+/**
+ * struct sde_encoder_vsync_model - least squares fit of the recent vsync
+ *	timestamps of the master interface, used to predict the next vsync
+ * @ts:		ring of vsync timestamps
+ * @head:	index of the oldest timestamp in @ts
+ * @count:	number of valid timestamps in @ts
+ * @l_bound:	shortest vsync interval accepted, in ns
+ * @u_bound:	longest vsync interval accepted, in ns
+ * @period_ns:	fitted vsync period, zero while the model is not settled
+ * @last:	fitted time of the newest vsync
+ * @samples:	number of vsync timestamps recorded
+ * @resets:	number of times an out of bound interval restarted the fit
+ */
+struct sde_encoder_vsync_model {
+	ktime_t ts[SDE_ENC_VSYNC_MODEL_SAMPLES];
+	u32 head;
+	u32 count;
+	u64 l_bound;
+	u64 u_bound;
+	s64 period_ns;
+	ktime_t last;
+	u64 samples;
+	u64 resets;
+};
+
 /*
  * enum sde_enc_rc_states - states that the resource control maintains
  * @SDE_ENC_RC_STATE_OFF: Resource is in OFF state
@@ -193,6 +222,8 @@ struct sde_encoder_ops {
  *				of esd attack to ensure esd workqueue detects
  *				the previous frame transfer completion before
  *				next update is triggered.
+ * @vsync_model:		vsync prediction model, protected by
+ *				enc_spinlock
  */
 struct sde_encoder_virt {
 	struct drm_encoder base;
@@ -261,6 +292,7 @@ struct sde_encoder_virt {
 	struct cpumask valid_cpu_mask;
 	struct msm_mode_info mode_info;
 	bool delay_kickoff;
+	struct sde_encoder_vsync_model vsync_model;
 };
 
 #define to_sde_encoder_virt(x) container_of(x, struct sde_encoder_virt, base)
@@ -321,6 +353,15 @@ struct sde_rsc_client *sde_encoder_get_rsc_client(struct drm_encoder *encoder);
  */
 int sde_encoder_poll_line_counts(struct drm_encoder *encoder);
 
+/**
+ * sde_encoder_get_next_vsync - predict the time of the next vsync
+ * @encoder:	encoder pointer
+ * @period_ns:	optional pointer to return the fitted vsync period
+ * @Returns:	predicted time of the first vsync after now, or zero if the
+ *		vsync model has not settled
+ */
+ktime_t sde_encoder_get_next_vsync(struct drm_encoder *encoder, s64 *period_ns);
+
 /**
  * sde_encoder_prepare_for_kickoff - schedule double buffer flip of the ctl
  *	path (i.e. ctl flush and start) at next appropriate time.
@@ -233,6 +233,9 @@ enum sde_intr_idx {
  * @irq_idx:		IRQ interface lookup index from SDE IRQ framework
  *			will be -EINVAL if IRQ is not registered
  * @irq_cb:		interrupt callback
+ * @fast:		install the callback as the fast path handler of the
+ *			irq_idx, falls back to the callback list if another
+ *			fast path handler is installed
  */
 struct sde_encoder_irq {
 	const char *name;
@@ -241,6 +244,7 @@ struct sde_encoder_irq {
 	int hw_idx;
 	int irq_idx;
 	struct sde_irq_callback cb;
+	bool fast;
 };
 
 /**
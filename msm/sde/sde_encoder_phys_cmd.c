@@ -2048,6 +2048,7 @@ struct sde_encoder_phys *sde_encoder_phys_cmd_init(
 	irq->intr_type = SDE_IRQ_TYPE_PING_PONG_COMP;
 	irq->intr_idx = INTR_IDX_PINGPONG;
 	irq->cb.func = sde_encoder_phys_cmd_pp_tx_done_irq;
+	irq->fast = true;
 
 	irq = &phys_enc->irq[INTR_IDX_RDPTR];
 	irq->intr_idx = INTR_IDX_RDPTR;
@@ -2059,6 +2060,7 @@ struct sde_encoder_phys *sde_encoder_phys_cmd_init(
 		irq->intr_type = SDE_IRQ_TYPE_PING_PONG_RD_PTR;
 
 	irq->cb.func = sde_encoder_phys_cmd_te_rd_ptr_irq;
+	irq->fast = true;
 
 	irq = &phys_enc->irq[INTR_IDX_UNDERRUN];
 	irq->name = "underrun";
@@ -2076,6 +2078,7 @@ struct sde_encoder_phys *sde_encoder_phys_cmd_init(
 
 	irq->intr_idx = INTR_IDX_AUTOREFRESH_DONE;
 	irq->cb.func = sde_encoder_phys_cmd_autorefresh_done_irq;
+	irq->fast = true;
 
 	irq = &phys_enc->irq[INTR_IDX_WRPTR];
 	irq->intr_idx = INTR_IDX_WRPTR;
@@ -2086,6 +2089,7 @@ struct sde_encoder_phys *sde_encoder_phys_cmd_init(
 	else
 		irq->intr_type = SDE_IRQ_TYPE_PING_PONG_WR_PTR;
 	irq->cb.func = sde_encoder_phys_cmd_wr_ptr_irq;
+	irq->fast = true;
 
 	atomic_set(&phys_enc->vblank_refcount, 0);
 	atomic_set(&phys_enc->pending_kickoff_cnt, 0);
@@ -12,6 +12,8 @@
 
 #define TIMELINE_VAL_LENGTH		128
 
+static struct kmem_cache *sde_fence_cache;
+
 void *sde_sync_get(uint64_t fd)
 {
 	/* force signed compare, fdget accepts an int argument */
@@ -144,7 +146,7 @@ static void sde_fence_release(struct dma_fence *fence)
 	if (fence) {
 		f = to_sde_fence(fence);
 		kref_put(&f->ctx->kref, sde_fence_destroy);
-		kfree(f);
+		kmem_cache_free(sde_fence_cache, f);
 	}
 }
 
@@ -178,6 +180,28 @@ static struct dma_fence_ops sde_fence_ops = {
 	.timeline_value_str = sde_fence_timeline_value_str,
 };
 
+/**
+ * _sde_fence_list_insert - add a fence to the timeline list in seqno order
+ * Fences are created with non-decreasing seqnos, so the position is almost
+ * always the tail. Called with list_lock held.
+ * @ctx: Timeline the fence belongs to
+ * @fence: Fence to insert
+ */
+static void _sde_fence_list_insert(struct sde_fence_context *ctx,
+		struct sde_fence *fence)
+{
+	struct sde_fence *fc;
+
+	list_for_each_entry_reverse(fc, &ctx->fence_list_head, fence_list) {
+		if ((int)(fc->base.seqno - fence->base.seqno) <= 0) {
+			list_add(&fence->fence_list, &fc->fence_list);
+			return;
+		}
+	}
+
+	list_add(&fence->fence_list, &ctx->fence_list_head);
+}
+
 /**
  * _sde_fence_create_fd - create fence object and return an fd for it
  * This function is NOT thread-safe.
@@ -197,7 +221,10 @@ static int _sde_fence_create_fd(void *fence_ctx, uint32_t val)
 		goto exit;
 	}
 
-	sde_fence = kzalloc(sizeof(*sde_fence), GFP_KERNEL);
+	if (!sde_fence_cache)
+		return -ENOMEM;
+
+	sde_fence = kmem_cache_zalloc(sde_fence_cache, GFP_KERNEL);
 	if (!sde_fence)
 		return -ENOMEM;
 
@@ -231,13 +258,26 @@ static int _sde_fence_create_fd(void *fence_ctx, uint32_t val)
 	sde_fence->fd = fd;
 
 	spin_lock(&ctx->list_lock);
-	list_add_tail(&sde_fence->fence_list, &ctx->fence_list_head);
+	_sde_fence_list_insert(ctx, sde_fence);
 	spin_unlock(&ctx->list_lock);
 
 exit:
 	return fd;
 }
 
+void __init sde_fence_register(void)
+{
+	sde_fence_cache = KMEM_CACHE(sde_fence, 0);
+	if (!sde_fence_cache)
+		SDE_ERROR("failed to create fence cache\n");
+}
+
+void __exit sde_fence_unregister(void)
+{
+	kmem_cache_destroy(sde_fence_cache);
+	sde_fence_cache = NULL;
+}
+
 struct sde_fence_context *sde_fence_init(const char *name, uint32_t drm_id)
 {
 	struct sde_fence_context *ctx;
@@ -289,11 +329,42 @@ void sde_fence_prepare(struct sde_fence_context *ctx)
 	}
 }
 
-static void _sde_fence_trigger(struct sde_fence_context *ctx, bool error)
+/**
+ * _sde_fence_signal_ts_locked - signal a fence with a given timestamp
+ * @fence: Fence to signal, with its lock held
+ * @ts: Time to report as the signal time of the fence
+ *
+ * Open coded dma_fence_signal_timestamp_locked(), which this kernel lacks.
+ * The timestamp shares storage with the callback list, so the callbacks
+ * are stashed before the timestamp is stored and run afterwards.
+ */
+static void _sde_fence_signal_ts_locked(struct dma_fence *fence, ktime_t ts)
+{
+	struct dma_fence_cb *cur, *tmp;
+	struct list_head cb_list;
+
+	lockdep_assert_held(fence->lock);
+
+	if (test_and_set_bit(DMA_FENCE_FLAG_SIGNALED_BIT, &fence->flags))
+		return;
+
+	list_replace_init(&fence->cb_list, &cb_list);
+
+	fence->timestamp = ts;
+	set_bit(DMA_FENCE_FLAG_TIMESTAMP_BIT, &fence->flags);
+
+	list_for_each_entry_safe(cur, tmp, &cb_list, node) {
+		INIT_LIST_HEAD(&cur->node);
+		cur->func(fence, cur);
+	}
+}
+
+static void _sde_fence_trigger(struct sde_fence_context *ctx, ktime_t ts,
+		bool error)
 {
 	unsigned long flags;
 	struct sde_fence *fc, *next;
-	bool is_signaled = false;
+	LIST_HEAD(signaled);
 
 	kref_get(&ctx->kref);
 
@@ -303,20 +374,34 @@ static void _sde_fence_trigger(struct sde_fence_context *ctx, bool error)
 		goto end;
 	}
 
+	/*
+	 * The list is kept in seqno order, so everything after the first
+	 * fence that is still ahead of the timeline is pending as well.
+	 */
+	spin_lock_irqsave(&ctx->lock, flags);
 	list_for_each_entry_safe(fc, next, &ctx->fence_list_head, fence_list) {
-		spin_lock_irqsave(&ctx->lock, flags);
-		if (error)
-			dma_fence_set_error(&fc->base, -EBUSY);
-		is_signaled = dma_fence_is_signaled_locked(&fc->base);
-		spin_unlock_irqrestore(&ctx->lock, flags);
-
-		if (is_signaled) {
-			list_del_init(&fc->fence_list);
-			dma_fence_put(&fc->base);
+		if (!sde_fence_signaled(&fc->base))
+			break;
+
+		/* a waiter may have polled the fence to signaled already */
+		if (!test_bit(DMA_FENCE_FLAG_SIGNALED_BIT, &fc->base.flags)) {
+			if (error)
+				dma_fence_set_error(&fc->base, -EBUSY);
+			_sde_fence_signal_ts_locked(&fc->base, ts);
 		}
+
+		list_move_tail(&fc->fence_list, &signaled);
 	}
+	spin_unlock_irqrestore(&ctx->lock, flags);
+
 end:
 	spin_unlock(&ctx->list_lock);
+
+	list_for_each_entry_safe(fc, next, &signaled, fence_list) {
+		list_del_init(&fc->fence_list);
+		dma_fence_put(&fc->base);
+	}
+
 	kref_put(&ctx->kref, sde_fence_destroy);
 }
 
@@ -360,6 +445,7 @@ void sde_fence_signal(struct sde_fence_context *ctx, ktime_t ts,
 		enum sde_fence_event fence_event)
 {
 	unsigned long flags;
+	ktime_t now;
 
 	if (!ctx) {
 		SDE_ERROR("invalid ctx, %pK\n", ctx);
@@ -397,7 +483,12 @@ void sde_fence_signal(struct sde_fence_context *ctx, ktime_t ts,
 	SDE_EVT32(ctx->drm_id, ctx->done_count, ctx->commit_count,
 			ktime_to_us(ts));
 
-	_sde_fence_trigger(ctx, (fence_event == SDE_FENCE_SIGNAL_ERROR));
+	/* never report a signal time from the future or no time at all */
+	now = ktime_get();
+	if (!ktime_to_ns(ts) || ktime_after(ts, now))
+		ts = now;
+
+	_sde_fence_trigger(ctx, ts, (fence_event == SDE_FENCE_SIGNAL_ERROR));
 }
 
 void sde_fence_timeline_status(struct sde_fence_context *ctx,
@@ -8,6 +8,7 @@
 
 #include <linux/kernel.h>
 #include <linux/errno.h>
+#include <linux/init.h>
 #include <linux/mutex.h>
 
 #ifndef CHAR_BIT
@@ -96,6 +97,16 @@ signed long sde_sync_wait(void *fence, long timeout_ms);
  */
 uint32_t sde_sync_get_name_prefix(void *fence);
 
+/**
+ * sde_fence_register - create the allocation cache of the fences
+ */
+void __init sde_fence_register(void);
+
+/**
+ * sde_fence_unregister - destroy the allocation cache of the fences
+ */
+void __exit sde_fence_unregister(void);
+
 /**
  * sde_fence_init - initialize fence object
  * @drm_id: ID number of owning DRM Object
@@ -130,7 +141,7 @@ int sde_fence_create(struct sde_fence_context *fence, uint64_t *val,
 /**
  * sde_fence_signal - advance fence timeline to signal outstanding fences
  * @fence: Pointer fence container
- * @ts: fence timestamp
+ * @ts: fence timestamp, reported as the signal time of the fences
  * @fence_event: fence event to indicate nature of fence signal.
  */
 void sde_fence_signal(struct sde_fence_context *fence, ktime_t ts,
@@ -180,6 +191,14 @@ static inline uint32_t sde_sync_get_name_prefix(void *fence)
 	return 0x0;
 }
 
+static inline void __init sde_fence_register(void)
+{
+}
+
+static inline void __exit sde_fence_unregister(void)
+{
+}
+
 static inline struct sde_fence_context *sde_fence_init(const char *name,
 		uint32_t drm_id)
 {
@@ -0,0 +1,133 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2021, The Linux Foundation. All rights reserved.
+ */
+
+#ifndef _SDE_FORMAT_LUT_H_
+#define _SDE_FORMAT_LUT_H_
+
+/*
+ * Open addressed hash from (fourcc, class) to the index of a format table
+ * entry, shared by the sde and rotator format lookups. The class tells
+ * apart the tables a fourcc can be found in, e.g. the modifier family of
+ * a drm format. Like sde_perf_model.h the header has no kernel dependency
+ * so the tables can be checked on a host.
+ */
+#ifdef __KERNEL__
+#include <linux/errno.h>
+#include <linux/types.h>
+#else
+#include <errno.h>
+#include <stdint.h>
+typedef uint16_t u16;
+typedef uint32_t u32;
+#endif
+
+#define SDE_FORMAT_LUT_BITS	8
+#define SDE_FORMAT_LUT_SIZE	(1 << SDE_FORMAT_LUT_BITS)
+
+/**
+ * struct sde_format_lut_entry - slot of the lookup table
+ * @fourcc: format of the entry, zero if the slot is free
+ * @class: table the format belongs to
+ * @index: index of the format within its table
+ */
+struct sde_format_lut_entry {
+	u32 fourcc;
+	u16 class;
+	u16 index;
+};
+
+/**
+ * struct sde_format_lut - format lookup table
+ * @slot: hash slots, kept at most half full by the callers
+ * @count: number of used slots
+ */
+struct sde_format_lut {
+	struct sde_format_lut_entry slot[SDE_FORMAT_LUT_SIZE];
+	u32 count;
+};
+
+static inline u32 _sde_format_lut_hash(u32 fourcc, u32 class)
+{
+	/* fourccs differ mostly in their last characters, mix all bits */
+	u32 key = fourcc ^ (class * 0x9e3779b9);
+
+	key ^= key >> 16;
+	key *= 0x85ebca6b;
+	key ^= key >> 13;
+
+	return (key * 0x9e3779b1) >> (32 - SDE_FORMAT_LUT_BITS);
+}
+
+/**
+ * sde_format_lut_insert - add a format to the lookup table
+ * @lut: lookup table
+ * @fourcc: format to add, must not be zero
+ * @class: table the format belongs to
+ * @index: index of the format within its table
+ * return: zero if added, -EEXIST if the format is already in the table,
+ *         -ENOSPC if the table is full, or -EINVAL on invalid input
+ *
+ * The first index added for a (fourcc, class) pair is kept, so filling the
+ * table in array order resolves duplicates the way a linear scan does.
+ */
+static inline int sde_format_lut_insert(struct sde_format_lut *lut,
+		u32 fourcc, u32 class, u32 index)
+{
+	struct sde_format_lut_entry *e;
+	u32 i, h;
+
+	if (!lut || !fourcc || class > 0xffff || index > 0xffff)
+		return -EINVAL;
+
+	h = _sde_format_lut_hash(fourcc, class);
+	for (i = 0; i < SDE_FORMAT_LUT_SIZE; i++) {
+		e = &lut->slot[(h + i) & (SDE_FORMAT_LUT_SIZE - 1)];
+
+		if (!e->fourcc) {
+			e->fourcc = fourcc;
+			e->class = class;
+			e->index = index;
+			lut->count++;
+			return 0;
+		}
+
+		if (e->fourcc == fourcc && e->class == class)
+			return -EEXIST;
+	}
+
+	return -ENOSPC;
+}
+
+/**
+ * sde_format_lut_find - look up a format
+ * @lut: lookup table
+ * @fourcc: format to look up
+ * @class: table the format belongs to
+ * return: index of the format within its table, or -ENOENT
+ */
+static inline int sde_format_lut_find(const struct sde_format_lut *lut,
+		u32 fourcc, u32 class)
+{
+	const struct sde_format_lut_entry *e;
+	u32 i, h;
+
+	if (!lut || !fourcc)
+		return -ENOENT;
+
+	h = _sde_format_lut_hash(fourcc, class);
+	for (i = 0; i < SDE_FORMAT_LUT_SIZE; i++) {
+		e = &lut->slot[(h + i) & (SDE_FORMAT_LUT_SIZE - 1)];
+
+		if (!e->fourcc)
+			break;
+
+		if (e->fourcc == fourcc && e->class == class)
+			return e->index;
+	}
+
+	return -ENOENT;
+}
+
+#endif /* _SDE_FORMAT_LUT_H_ */
@@ -5,11 +5,14 @@
 
 #define pr_fmt(fmt)	"[drm:%s:%d] " fmt, __func__, __LINE__
 
+#include <linux/debugfs.h>
+#include <linux/once.h>
 #include <drm/drm_fourcc.h>
 #include <media/mmm_color_fmt.h>
 
 #include "sde_kms.h"
 #include "sde_formats.h"
+#include "sde_format_lut.h"
 
 #define SDE_UBWC_META_MACRO_W_H		16
 #define SDE_UBWC_META_BLOCK_SIZE	256
@@ -642,6 +645,66 @@ static const struct sde_format sde_format_map_tp10_ubwc[] = {
 		SDE_FETCH_UBWC, 4, SDE_TILE_HEIGHT_NV12),
 };
 
+/**
+ * enum sde_format_class - format maps selected by the format modifier
+ */
+enum sde_format_class {
+	SDE_FORMAT_CLASS_LINEAR,
+	SDE_FORMAT_CLASS_UBWC,
+	SDE_FORMAT_CLASS_P010,
+	SDE_FORMAT_CLASS_P010_UBWC,
+	SDE_FORMAT_CLASS_TP10_UBWC,
+	SDE_FORMAT_CLASS_TILE,
+	SDE_FORMAT_CLASS_P010_TILE,
+	SDE_FORMAT_CLASS_TP10_TILE,
+	SDE_FORMAT_CLASS_MAX,
+};
+
+#define SDE_FORMAT_CLASS_MAP(c, m)	[c] = { m, ARRAY_SIZE(m) }
+
+static const struct {
+	const struct sde_format *map;
+	u32 size;
+} sde_format_class_maps[SDE_FORMAT_CLASS_MAX] = {
+	SDE_FORMAT_CLASS_MAP(SDE_FORMAT_CLASS_LINEAR, sde_format_map),
+	SDE_FORMAT_CLASS_MAP(SDE_FORMAT_CLASS_UBWC, sde_format_map_ubwc),
+	SDE_FORMAT_CLASS_MAP(SDE_FORMAT_CLASS_P010, sde_format_map_p010),
+	SDE_FORMAT_CLASS_MAP(SDE_FORMAT_CLASS_P010_UBWC,
+			sde_format_map_p010_ubwc),
+	SDE_FORMAT_CLASS_MAP(SDE_FORMAT_CLASS_TP10_UBWC,
+			sde_format_map_tp10_ubwc),
+	SDE_FORMAT_CLASS_MAP(SDE_FORMAT_CLASS_TILE, sde_format_map_tile),
+	SDE_FORMAT_CLASS_MAP(SDE_FORMAT_CLASS_P010_TILE,
+			sde_format_map_p010_tile),
+	SDE_FORMAT_CLASS_MAP(SDE_FORMAT_CLASS_TP10_TILE,
+			sde_format_map_tp10_tile),
+};
+
+static struct sde_format_lut sde_format_lut;
+
+static void _sde_format_lut_init(void)
+{
+	const struct sde_format *map;
+	u32 class, i;
+	int rc;
+
+	for (class = 0; class < SDE_FORMAT_CLASS_MAX; class++) {
+		map = sde_format_class_maps[class].map;
+
+		for (i = 0; i < sde_format_class_maps[class].size; i++) {
+			rc = sde_format_lut_insert(&sde_format_lut,
+					map[i].base.pixel_format, class, i);
+			/* duplicates keep the first entry, as the scan did */
+			if (rc && rc != -EEXIST)
+				SDE_ERROR("fmt %4.4s class %u not hashed %d\n",
+					(char *)&map[i].base.pixel_format,
+					class, rc);
+		}
+	}
+
+	WARN_ON(sde_format_lut.count > SDE_FORMAT_LUT_SIZE / 2);
+}
+
 bool sde_format_is_tp10_ubwc(const struct sde_format *fmt)
 {
 	if (SDE_FORMAT_IS_YUV(fmt) && SDE_FORMAT_IS_DX(fmt) &&
@@ -1068,6 +1131,73 @@ static int _sde_format_populate_addrs_linear(
 	return 0;
 }
 
+static atomic_t sde_format_layout_hits;
+static atomic_t sde_format_layout_misses;
+
+/*
+ * _sde_format_get_fb_plane_sizes - get the plane sizes of a framebuffer,
+ *	computing them only on the first use of the framebuffer
+ * @fb: framebuffer
+ * @fmt: sde format of the framebuffer
+ * @layout: layout to fill, plane addresses are cleared
+ */
+static int _sde_format_get_fb_plane_sizes(struct drm_framebuffer *fb,
+		const struct sde_format *fmt,
+		struct sde_hw_fmt_layout *layout)
+{
+	struct msm_framebuffer_layout *cache = msm_framebuffer_layout(fb);
+	int i, ret;
+
+	BUILD_BUG_ON(ARRAY_SIZE(cache->plane_size) != SDE_MAX_PLANES);
+
+	if (cache && fmt &&
+			smp_load_acquire(&cache->state) == MSM_FB_LAYOUT_VALID &&
+			cache->format == fmt->base.pixel_format &&
+			cache->modifier == fb->modifier &&
+			cache->width == fb->width &&
+			cache->height == fb->height) {
+		memset(layout, 0, sizeof(*layout));
+		layout->format = fmt;
+		layout->width = cache->width;
+		layout->height = cache->height;
+		layout->num_planes = cache->num_planes;
+		layout->total_size = cache->total_size;
+		for (i = 0; i < SDE_MAX_PLANES; i++) {
+			layout->plane_size[i] = cache->plane_size[i];
+			layout->plane_pitch[i] = cache->plane_pitch[i];
+		}
+
+		atomic_inc(&sde_format_layout_hits);
+		return 0;
+	}
+
+	ret = sde_format_get_plane_sizes(fmt, fb->width, fb->height,
+			layout, fb->pitches);
+	if (ret || !cache)
+		return ret;
+
+	atomic_inc(&sde_format_layout_misses);
+
+	/* only the first caller fills the cache, the others recompute */
+	if (cmpxchg(&cache->state, MSM_FB_LAYOUT_EMPTY,
+			MSM_FB_LAYOUT_FILLING) != MSM_FB_LAYOUT_EMPTY)
+		return 0;
+
+	cache->format = fmt->base.pixel_format;
+	cache->modifier = fb->modifier;
+	cache->width = layout->width;
+	cache->height = layout->height;
+	cache->num_planes = layout->num_planes;
+	cache->total_size = layout->total_size;
+	for (i = 0; i < SDE_MAX_PLANES; i++) {
+		cache->plane_size[i] = layout->plane_size[i];
+		cache->plane_pitch[i] = layout->plane_pitch[i];
+	}
+	smp_store_release(&cache->state, MSM_FB_LAYOUT_VALID);
+
+	return 0;
+}
+
 int sde_format_populate_layout(
 		struct msm_gem_address_space *aspace,
 		struct drm_framebuffer *fb,
@@ -1089,9 +1219,8 @@ int sde_format_populate_layout(
 
 	layout->format = to_sde_format(msm_framebuffer_format(fb));
 
-	/* Populate the plane sizes etc via get_format */
-	ret = sde_format_get_plane_sizes(layout->format, fb->width, fb->height,
-			layout, fb->pitches);
+	/* Populate the plane sizes etc, computed once per framebuffer */
+	ret = _sde_format_get_fb_plane_sizes(fb, layout->format, layout);
 	if (ret)
 		return ret;
 
@@ -1112,6 +1241,23 @@ int sde_format_populate_layout(
 	return ret;
 }
 
+#ifdef CONFIG_DEBUG_FS
+void sde_format_debugfs_init(struct dentry *root)
+{
+	if (!root)
+		return;
+
+	debugfs_create_atomic_t("fb_layout_hits", 0400, root,
+			&sde_format_layout_hits);
+	debugfs_create_atomic_t("fb_layout_misses", 0400, root,
+			&sde_format_layout_misses);
+}
+#else
+void sde_format_debugfs_init(struct dentry *root)
+{
+}
+#endif /* CONFIG_DEBUG_FS */
+
 int sde_format_check_modified_format(
 		const struct msm_kms *kms,
 		const struct msm_format *msm_fmt,
@@ -1161,10 +1307,9 @@ const struct sde_format *sde_get_sde_format_ext(
 		const uint32_t format,
 		const uint64_t modifier)
 {
-	uint32_t i = 0;
 	const struct sde_format *fmt = NULL;
-	const struct sde_format *map = NULL;
-	ssize_t map_size = 0;
+	enum sde_format_class class;
+	int idx;
 
 	/*
 	 * Currently only support exactly zero or one modifier.
@@ -1174,27 +1319,23 @@ const struct sde_format *sde_get_sde_format_ext(
 
 	switch (modifier) {
 	case 0:
-		map = sde_format_map;
-		map_size = ARRAY_SIZE(sde_format_map);
+		class = SDE_FORMAT_CLASS_LINEAR;
 		break;
 	case DRM_FORMAT_MOD_QCOM_COMPRESSED:
 	case DRM_FORMAT_MOD_QCOM_COMPRESSED | DRM_FORMAT_MOD_QCOM_TILE:
-		map = sde_format_map_ubwc;
-		map_size = ARRAY_SIZE(sde_format_map_ubwc);
+		class = SDE_FORMAT_CLASS_UBWC;
 		SDE_DEBUG("found fmt: %4.4s  DRM_FORMAT_MOD_QCOM_COMPRESSED\n",
 				(char *)&format);
 		break;
 	case DRM_FORMAT_MOD_QCOM_DX:
-		map = sde_format_map_p010;
-		map_size = ARRAY_SIZE(sde_format_map_p010);
+		class = SDE_FORMAT_CLASS_P010;
 		SDE_DEBUG("found fmt: %4.4s DRM_FORMAT_MOD_QCOM_DX\n",
 				(char *)&format);
 		break;
 	case (DRM_FORMAT_MOD_QCOM_DX | DRM_FORMAT_MOD_QCOM_COMPRESSED):
 	case (DRM_FORMAT_MOD_QCOM_DX | DRM_FORMAT_MOD_QCOM_COMPRESSED |
 			DRM_FORMAT_MOD_QCOM_TILE):
-		map = sde_format_map_p010_ubwc;
-		map_size = ARRAY_SIZE(sde_format_map_p010_ubwc);
+		class = SDE_FORMAT_CLASS_P010_UBWC;
 		SDE_DEBUG(
 			"found fmt: %4.4s DRM_FORMAT_MOD_QCOM_COMPRESSED/DX\n",
 				(char *)&format);
@@ -1203,28 +1344,24 @@ const struct sde_format *sde_get_sde_format_ext(
 		DRM_FORMAT_MOD_QCOM_TIGHT):
 	case (DRM_FORMAT_MOD_QCOM_DX | DRM_FORMAT_MOD_QCOM_COMPRESSED |
 		DRM_FORMAT_MOD_QCOM_TIGHT | DRM_FORMAT_MOD_QCOM_TILE):
-		map = sde_format_map_tp10_ubwc;
-		map_size = ARRAY_SIZE(sde_format_map_tp10_ubwc);
+		class = SDE_FORMAT_CLASS_TP10_UBWC;
 		SDE_DEBUG(
 			"found fmt: %4.4s DRM_FORMAT_MOD_QCOM_COMPRESSED/DX/TIGHT\n",
 				(char *)&format);
 		break;
 	case DRM_FORMAT_MOD_QCOM_TILE:
-		map = sde_format_map_tile;
-		map_size = ARRAY_SIZE(sde_format_map_tile);
+		class = SDE_FORMAT_CLASS_TILE;
 		SDE_DEBUG("found fmt: %4.4s DRM_FORMAT_MOD_QCOM_TILE\n",
 				(char *)&format);
 		break;
 	case (DRM_FORMAT_MOD_QCOM_TILE | DRM_FORMAT_MOD_QCOM_DX):
-		map = sde_format_map_p010_tile;
-		map_size = ARRAY_SIZE(sde_format_map_p010_tile);
+		class = SDE_FORMAT_CLASS_P010_TILE;
 		SDE_DEBUG("found fmt: %4.4s DRM_FORMAT_MOD_QCOM_TILE/DX\n",
 				(char *)&format);
 		break;
 	case (DRM_FORMAT_MOD_QCOM_TILE | DRM_FORMAT_MOD_QCOM_DX |
 			DRM_FORMAT_MOD_QCOM_TIGHT):
-		map = sde_format_map_tp10_tile;
-		map_size = ARRAY_SIZE(sde_format_map_tp10_tile);
+		class = SDE_FORMAT_CLASS_TP10_TILE;
 		SDE_DEBUG(
 			"found fmt: %4.4s DRM_FORMAT_MOD_QCOM_TILE/DX/TIGHT\n",
 				(char *)&format);
@@ -1234,12 +1371,11 @@ const struct sde_format *sde_get_sde_format_ext(
 		return NULL;
 	}
 
-	for (i = 0; i < map_size; i++) {
-		if (format == map[i].base.pixel_format) {
-			fmt = &map[i];
-			break;
-		}
-	}
+	DO_ONCE(_sde_format_lut_init);
+
+	idx = sde_format_lut_find(&sde_format_lut, format, class);
+	if (idx >= 0)
+		fmt = &sde_format_class_maps[class].map[idx];
 
 	if (fmt == NULL)
 		SDE_ERROR("unsupported fmt: %4.4s modifier 0x%llX\n",
@@ -147,4 +147,10 @@ int sde_format_validate_fmt(struct msm_kms *kms,
 	const struct sde_format *sde_fmt,
 	const struct sde_format_extended *fmt_list);
 
+/**
+ * sde_format_debugfs_init - create the format debugfs nodes
+ * @root: Debugfs directory to create the nodes in
+ */
+void sde_format_debugfs_init(struct dentry *root);
+
 #endif /*_SDE_FORMATS_H */
@@ -768,6 +768,9 @@ static int sde_hw_ctl_reset_control(struct sde_hw_ctl *ctx)
 	c = &ctx->hw;
 	pr_debug("issuing hw ctl reset for ctl:%d\n", ctx->idx);
 	SDE_REG_WRITE(c, CTL_SW_RESET, 0x1);
+
+	/* the reset clears the blocks of the whole ctl path */
+	sde_hw_reg_shadow_invalidate_all();
 	if (sde_hw_ctl_poll_reset_status(ctx, SDE_REG_RESET_TIMEOUT_US))
 		return -EINVAL;
 
@@ -970,10 +973,10 @@ static void sde_hw_ctl_setup_blendstage(struct sde_hw_ctl *ctx,
 			(stage_cfg && !stage_cfg->stage[0][0])))
 		cfg.cfg |= CTL_MIXER_BORDER_OUT;
 
-	SDE_REG_WRITE(c, CTL_LAYER(lm), cfg.cfg);
-	SDE_REG_WRITE(c, CTL_LAYER_EXT(lm), cfg.ext);
-	SDE_REG_WRITE(c, CTL_LAYER_EXT2(lm), cfg.ext2);
-	SDE_REG_WRITE(c, CTL_LAYER_EXT3(lm), cfg.ext3);
+	SDE_REG_WRITE_CACHED(c, CTL_LAYER(lm), cfg.cfg);
+	SDE_REG_WRITE_CACHED(c, CTL_LAYER_EXT(lm), cfg.ext);
+	SDE_REG_WRITE_CACHED(c, CTL_LAYER_EXT2(lm), cfg.ext2);
+	SDE_REG_WRITE_CACHED(c, CTL_LAYER_EXT3(lm), cfg.ext3);
 }
 
 static u32 sde_hw_ctl_get_staged_sspp(struct sde_hw_ctl *ctx, enum sde_lm lm,
@@ -1337,6 +1340,19 @@ static int sde_hw_reg_dma_flush(struct sde_hw_ctl *ctx, bool blocking)
 
 }
 
+static int sde_hw_reg_dma_kickoff_pending(struct sde_hw_ctl *ctx)
+{
+	struct sde_hw_reg_dma_ops *ops = sde_reg_dma_get_ops();
+
+	if (!ctx)
+		return -EINVAL;
+
+	if (ops && ops->kick_off_pending)
+		return ops->kick_off_pending(ctx);
+
+	return 0;
+}
+
 static void _setup_ctl_ops(struct sde_hw_ctl_ops *ops,
 		unsigned long cap)
 {
@@ -1382,6 +1398,7 @@ static void _setup_ctl_ops(struct sde_hw_ctl_ops *ops,
 	ops->update_bitmask_sspp = sde_hw_ctl_update_bitmask_sspp;
 	ops->update_bitmask_mixer = sde_hw_ctl_update_bitmask_mixer;
 	ops->reg_dma_flush = sde_hw_reg_dma_flush;
+	ops->reg_dma_kickoff_pending = sde_hw_reg_dma_kickoff_pending;
 	ops->get_start_state = sde_hw_ctl_get_start_state;
 
 	if (cap & BIT(SDE_CTL_UNIFIED_DSPP_FLUSH)) {
@@ -1436,6 +1453,9 @@ struct sde_hw_ctl *sde_hw_ctl_init(enum sde_ctl idx,
 	sde_dbg_reg_register_dump_range(SDE_DBG_NAME, cfg->name, c->hw.blk_off,
 			c->hw.blk_off + c->hw.length, c->hw.xin_id);
 
+	if (sde_hw_reg_shadow_init(&c->hw, cfg->name, c->hw.length))
+		SDE_DEBUG("no register shadow for %s\n", cfg->name);
+
 	return c;
 
 blk_init_error:
@@ -1446,7 +1466,9 @@ blk_init_error:
 
 void sde_hw_ctl_destroy(struct sde_hw_ctl *ctx)
 {
-	if (ctx)
+	if (ctx) {
 		sde_hw_blk_destroy(&ctx->base);
+		sde_hw_reg_shadow_deinit(&ctx->hw);
+	}
 	kfree(ctx);
 }
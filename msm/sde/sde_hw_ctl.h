@@ -451,6 +451,14 @@ struct sde_hw_ctl_ops {
 	 */
 	int (*reg_dma_flush)(struct sde_hw_ctl *ctx, bool blocking);
 
+	/**
+	 * Submit the reg dma writes queued on a ctl that is flushed through
+	 * another ctl and does not send its own last command.
+	 * @ctx       : ctl path ctx pointer
+	 * @Return: error code
+	 */
+	int (*reg_dma_kickoff_pending)(struct sde_hw_ctl *ctx);
+
 	/**
 	 * check if ctl start trigger state to confirm the frame pending
 	 * status
@@ -191,6 +191,9 @@
 #define SDE_INTR_LTM_STATS_DONE BIT(0)
 #define SDE_INTR_LTM_STATS_WB_PB BIT(5)
 
+/* number of status bits in each interrupt register */
+#define SDE_INTR_REG_BITS 32
+
 /**
  * struct sde_intr_reg - array of SDE register sets
  * @clr_off:	offset to CLEAR reg
@@ -198,6 +201,8 @@
  * @status_off:	offset to STATUS reg
  * @map_idx_start   first offset in the sde_irq_map table
  * @map_idx_end    last offset in the sde_irq_map table
+ * @bit_irq_idx:	irq_idx in the sde_irq_map table serviced by each
+ *			status bit, -1 if the bit is not mapped
  */
 struct sde_intr_reg {
 	u32 clr_off;
@@ -205,6 +210,7 @@ struct sde_intr_reg {
 	u32 status_off;
 	u32 map_idx_start;
 	u32 map_idx_end;
+	s16 bit_irq_idx[SDE_INTR_REG_BITS];
 };
 
 /**
@@ -454,10 +460,10 @@ static void sde_hw_intr_dispatch_irq(struct sde_hw_intr *intr,
 {
 	int reg_idx;
 	int irq_idx;
-	int start_idx;
-	int end_idx;
+	int bit;
 	u32 irq_status;
 	unsigned long irq_flags;
+	const struct sde_intr_reg *reg;
 
 	if (!intr)
 		return;
@@ -470,51 +476,41 @@ static void sde_hw_intr_dispatch_irq(struct sde_hw_intr *intr,
 	spin_lock_irqsave(&intr->irq_lock, irq_flags);
 	for (reg_idx = 0; reg_idx < intr->sde_irq_size; reg_idx++) {
 		irq_status = intr->save_irq_status[reg_idx];
+		reg = &intr->sde_irq_tbl[reg_idx];
 
 		/*
-		 * Each Interrupt register has dynamic range of indexes,
-		 * initialized during hw_intr_init when sde_irq_tbl is created.
-		 */
-		start_idx = intr->sde_irq_tbl[reg_idx].map_idx_start;
-		end_idx = intr->sde_irq_tbl[reg_idx].map_idx_end;
-
-		if (start_idx >= intr->sde_irq_map_size ||
-				end_idx > intr->sde_irq_map_size)
-			continue;
-
-		/*
-		 * Search through matching intr status from irq map.
-		 * start_idx and end_idx defined the search range in
-		 * the sde_irq_map.
+		 * Each set status bit resolves to its irq_idx through the
+		 * per register lookup table built during hw_intr_init.
 		 */
-		for (irq_idx = start_idx;
-				(irq_idx < end_idx) && irq_status;
-				irq_idx++)
-			if ((irq_status &
-				intr->sde_irq_map[irq_idx].irq_mask) &&
-				(intr->sde_irq_map[irq_idx].reg_idx ==
-				 reg_idx)) {
-				/*
-				 * Once a match on irq mask, perform a callback
-				 * to the given cbfunc. cbfunc will take care
-				 * the interrupt status clearing. If cbfunc is
-				 * not provided, then the interrupt clearing
-				 * is here.
-				 */
-				if (cbfunc)
-					cbfunc(arg, irq_idx);
-				else
-					intr->ops.clear_intr_status_nolock(
-							intr, irq_idx);
-
-				/*
-				 * When callback finish, clear the irq_status
-				 * with the matching mask. Once irq_status
-				 * is all cleared, the search can be stopped.
-				 */
-				irq_status &=
-					~intr->sde_irq_map[irq_idx].irq_mask;
+		while (irq_status) {
+			bit = __ffs(irq_status);
+			irq_idx = reg->bit_irq_idx[bit];
+			if (irq_idx < 0) {
+				irq_status &= ~BIT(bit);
+				continue;
 			}
+
+			/*
+			 * Once a match on irq mask, perform a callback
+			 * to the given cbfunc. cbfunc will take care
+			 * the interrupt status clearing. If cbfunc is
+			 * not provided, then the interrupt clearing
+			 * is here.
+			 */
+			if (cbfunc)
+				cbfunc(arg, irq_idx);
+			else
+				intr->ops.clear_intr_status_nolock(
+						intr, irq_idx);
+
+			/*
+			 * When callback finish, clear the irq_status
+			 * with the matching mask. Once irq_status
+			 * is all cleared, the search can be stopped.
+			 */
+			irq_status &= ~(intr->sde_irq_map[irq_idx].irq_mask |
+					BIT(bit));
+		}
 	}
 	spin_unlock_irqrestore(&intr->irq_lock, irq_flags);
 }
@@ -1115,6 +1111,32 @@ static int _sde_copy_regs(struct sde_irq_type *sde_irq_map, u32 size,
 	return 0;
 }
 
+/*
+ * Build the direct status bit to irq_idx lookup of one interrupt register.
+ * The lowest irq_idx wins if several map entries share a status bit, which
+ * matches the order of the former linear search of the sde_irq_map.
+ */
+static void _sde_hw_intr_init_bit_irq_idx(struct sde_hw_intr *intr,
+	int reg_idx)
+{
+	struct sde_intr_reg *reg = &intr->sde_irq_tbl[reg_idx];
+	unsigned long irq_mask;
+	int i, bit;
+
+	for (bit = 0; bit < SDE_INTR_REG_BITS; bit++)
+		reg->bit_irq_idx[bit] = -1;
+
+	for (i = reg->map_idx_start; i < reg->map_idx_end; i++) {
+		if (intr->sde_irq_map[i].reg_idx != reg_idx)
+			continue;
+
+		irq_mask = intr->sde_irq_map[i].irq_mask;
+		for_each_set_bit(bit, &irq_mask, SDE_INTR_REG_BITS)
+			if (reg->bit_irq_idx[bit] < 0)
+				reg->bit_irq_idx[bit] = i;
+	}
+}
+
 static int _sde_hw_intr_init_irq_tables(struct sde_hw_intr *intr,
 	struct sde_mdss_cfg *m)
 {
@@ -1157,6 +1179,7 @@ static int _sde_hw_intr_init_irq_tables(struct sde_hw_intr *intr,
 		 */
 		intr->sde_irq_tbl[sde_irq_tbl_idx].map_idx_start = low_idx;
 		intr->sde_irq_tbl[sde_irq_tbl_idx].map_idx_end = high_idx;
+		_sde_hw_intr_init_bit_irq_idx(intr, sde_irq_tbl_idx);
 		ret = _set_sde_irq_tbl_offset(
 				&intr->sde_irq_tbl[sde_irq_tbl_idx], item);
 		if (ret)
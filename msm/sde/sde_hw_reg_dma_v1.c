@@ -5,6 +5,7 @@
  */
 
 #include <linux/iopoll.h>
+#include <linux/bitmap.h>
 #include "sde_hw_mdss.h"
 #include "sde_hw_ctl.h"
 #include "sde_hw_reg_dma_v1.h"
@@ -62,6 +63,14 @@
 #define MAX_DWORDS_SZ (BIT(14) - 1)
 #define REG_DMA_HEADERS_BUFFER_SZ (sizeof(u32) * 128)
 
+/* feature payloads of a ctl are merged here and submitted at flush time */
+#define REG_DMA_COALESCE_BUFFER_SZ SZ_32K
+#define REG_DMA_LAST_CMD_SZ (sizeof(u32) * 2)
+
+/* reg dma buffers are carved out of large pinned arena chunks */
+#define REG_DMA_ARENA_CHUNK_SZ SZ_1M
+#define REG_DMA_ARENA_GRANULES (REG_DMA_ARENA_CHUNK_SZ / ADDR_ALIGN)
+
 #define LUTBUS_TABLE_SEL_MASK 0x10000
 #define LUTBUS_BLOCK_SEL_MASK 0xffff
 #define LUTBUS_TRANS_SZ_MASK 0xff0000
@@ -151,6 +160,7 @@ static int kick_off_v1(struct sde_reg_dma_kickoff_cfg *cfg);
 static int reset_v1(struct sde_hw_ctl *ctl);
 static int last_cmd_v1(struct sde_hw_ctl *ctl, enum sde_reg_dma_queue q,
 		enum sde_reg_dma_last_cmd_mode mode);
+static int kick_off_pending_v1(struct sde_hw_ctl *ctl);
 static struct sde_reg_dma_buffer *alloc_reg_dma_buf_v1(u32 size);
 static int dealloc_reg_dma_v1(struct sde_reg_dma_buffer *lut_buf);
 static void dump_regs_v1(void);
@@ -180,6 +190,50 @@ static reg_dma_internal_ops validate_dma_op_params[REG_DMA_SETUP_OPS_MAX] = {
 static struct sde_reg_dma_buffer *last_cmd_buf_db[CTL_MAX];
 static struct sde_reg_dma_buffer *last_cmd_buf_sb[CTL_MAX];
 
+/**
+ * struct reg_dma_coalesce - pending DB queue0 writes of a ctl for a frame
+ * @lock: serializes appends, submission and reset of the ctl buffer
+ * @buf: buffer the feature payloads are appended to
+ * @closed: buffer ran out of space, remaining writes are submitted directly
+ * @kickoffs: queue submissions issued so far in the frame
+ * @bytes: payload bytes appended so far in the frame
+ */
+struct reg_dma_coalesce {
+	struct mutex lock;
+	struct sde_reg_dma_buffer *buf;
+	bool closed;
+	u32 kickoffs;
+	u32 bytes;
+};
+
+static struct reg_dma_coalesce coalesce[CTL_MAX];
+
+/**
+ * struct sde_reg_dma_arena_chunk - pinned buffer reg dma buffers are carved
+ *                                  out of, in ADDR_ALIGN granules
+ * @list: entry in the arena chunk list
+ * @buf: gem object backing the chunk
+ * @aspace: address space the chunk is mapped in
+ * @iova: ADDR_ALIGN aligned device address of the chunk
+ * @vaddr: cpu address matching @iova
+ * @bufs: reg dma buffers carved out of the chunk
+ * @used: granules in use
+ * @map: granule allocation bitmap
+ */
+struct sde_reg_dma_arena_chunk {
+	struct list_head list;
+	struct drm_gem_object *buf;
+	struct msm_gem_address_space *aspace;
+	u64 iova;
+	void *vaddr;
+	struct list_head bufs;
+	u32 used;
+	DECLARE_BITMAP(map, REG_DMA_ARENA_GRANULES);
+};
+
+static LIST_HEAD(reg_dma_arena);
+static DEFINE_MUTEX(reg_dma_arena_lock);
+
 static void get_decode_sel(unsigned long blk, u32 *decode_sel)
 {
 	int i = 0;
@@ -705,6 +759,9 @@ int init_v1(struct sde_hw_reg_dma *cfg)
 		return -EINVAL;
 
 	reg_dma = cfg;
+	for (i = CTL_0; i < CTL_MAX; i++)
+		mutex_init(&coalesce[i].lock);
+
 	for (i = CTL_0; i < CTL_MAX; i++) {
 		if (!last_cmd_buf_db[i]) {
 			last_cmd_buf_db[i] =
@@ -732,6 +789,16 @@ int init_v1(struct sde_hw_reg_dma *cfg)
 				return 0;
 			}
 		}
+		if (!coalesce[i].buf) {
+			coalesce[i].buf =
+			    alloc_reg_dma_buf_v1(REG_DMA_COALESCE_BUFFER_SZ);
+			/* features are then submitted one by one */
+			if (IS_ERR_OR_NULL(coalesce[i].buf)) {
+				pr_info("Failed to allocate coalesce buf, ret:%lu\n",
+						PTR_ERR(coalesce[i].buf));
+				coalesce[i].buf = NULL;
+			}
+		}
 	}
 	if (rc) {
 		for (i = 0; i < CTL_MAX; i++) {
@@ -758,6 +825,7 @@ int init_v1(struct sde_hw_reg_dma *cfg)
 	reg_dma->ops.reset_reg_dma_buf = reset_reg_dma_buffer_v1;
 	reg_dma->ops.last_command = last_cmd_v1;
 	reg_dma->ops.dump_regs = dump_regs_v1;
+	reg_dma->ops.kick_off_pending = kick_off_pending_v1;
 
 	reg_dma_register_count = 60;
 	reg_dma_decode_sel = 0x180ac060;
@@ -907,6 +975,86 @@ static int setup_payload_v1(struct sde_reg_dma_setup_ops_cfg *cfg)
 }
 
 
+/* called with the coalesce lock of the ctl held */
+static void reset_coalesce_v1(enum sde_ctl idx)
+{
+	struct reg_dma_coalesce *c = &coalesce[idx];
+
+	if (c->buf)
+		reset_reg_dma_buffer_v1(c->buf);
+	c->closed = false;
+	c->kickoffs = 0;
+	c->bytes = 0;
+}
+
+static int submit_coalesce_v1(struct sde_hw_ctl *ctl, u32 last_command)
+{
+	struct reg_dma_coalesce *c = &coalesce[ctl->idx];
+	struct sde_reg_dma_kickoff_cfg kick_off;
+	int rc;
+
+	memset(&kick_off, 0, sizeof(kick_off));
+	kick_off.ctl = ctl;
+	kick_off.op = REG_DMA_WRITE;
+	kick_off.dma_type = REG_DMA_TYPE_DB;
+	kick_off.queue_select = DMA_CTL_QUEUE0;
+	kick_off.dma_buf = c->buf;
+	kick_off.feature = REG_DMA_FEATURES_MAX;
+	kick_off.last_command = last_command;
+
+	rc = validate_kick_off_v1(&kick_off);
+	if (!rc)
+		rc = write_kick_off_v1(&kick_off);
+	if (!rc)
+		c->kickoffs++;
+
+	return rc;
+}
+
+/*
+ * Append a feature write to the ctl coalesced buffer instead of programming
+ * the queue. Returns -EAGAIN when the write has to be submitted directly.
+ */
+static int coalesce_kick_off_v1(struct sde_reg_dma_kickoff_cfg *cfg)
+{
+	struct reg_dma_coalesce *c = &coalesce[cfg->ctl->idx];
+	struct sde_reg_dma_buffer *dst = c->buf;
+	u32 len = cfg->dma_buf->index;
+
+	if (reg_dma->coalesce_disable || !dst || !dst->iova ||
+			cfg->op != REG_DMA_WRITE || cfg->last_command ||
+			cfg->dma_type != REG_DMA_TYPE_DB ||
+			cfg->queue_select != DMA_CTL_QUEUE0)
+		return -EAGAIN;
+
+	mutex_lock(&c->lock);
+	if (c->closed) {
+		mutex_unlock(&c->lock);
+		return -EAGAIN;
+	}
+
+	if (dst->index + len + REG_DMA_LAST_CMD_SZ > dst->buffer_size) {
+		/* keep ordering, flush what is merged and stop merging */
+		if (dst->index)
+			submit_coalesce_v1(cfg->ctl, 0);
+		reg_dma->coalesce_stats[cfg->ctl->idx].overflows++;
+		c->closed = true;
+		mutex_unlock(&c->lock);
+		return -EAGAIN;
+	}
+
+	memcpy((u8 *)dst->vaddr + dst->index, cfg->dma_buf->vaddr, len);
+	dst->index += len;
+	dst->ops_completed |= cfg->dma_buf->ops_completed;
+	c->bytes += len;
+	reg_dma->coalesce_stats[cfg->ctl->idx].coalesced++;
+	mutex_unlock(&c->lock);
+
+	SDE_EVT32(cfg->feature, cfg->ctl->idx, SIZE_DWORD(len),
+			SIZE_DWORD(dst->index));
+	return 0;
+}
+
 static int kick_off_v1(struct sde_reg_dma_kickoff_cfg *cfg)
 {
 	int rc = 0;
@@ -915,7 +1063,16 @@ static int kick_off_v1(struct sde_reg_dma_kickoff_cfg *cfg)
 	if (rc)
 		return rc;
 
+	if (!coalesce_kick_off_v1(cfg))
+		return 0;
+
 	rc = write_kick_off_v1(cfg);
+	if (!rc && cfg->dma_type == REG_DMA_TYPE_DB) {
+		mutex_lock(&coalesce[cfg->ctl->idx].lock);
+		coalesce[cfg->ctl->idx].kickoffs++;
+		mutex_unlock(&coalesce[cfg->ctl->idx].lock);
+	}
+
 	return rc;
 }
 
@@ -930,6 +1087,13 @@ int reset_v1(struct sde_hw_ctl *ctl)
 		return -EINVAL;
 	}
 
+	mutex_lock(&coalesce[ctl->idx].lock);
+	reset_coalesce_v1(ctl->idx);
+	mutex_unlock(&coalesce[ctl->idx].lock);
+	/* queued LUT writes may never reach the hw */
+	sde_reg_dma_invalidate_shadow();
+	sde_hw_reg_shadow_invalidate_all();
+
 	index = ctl->idx - CTL_0;
 	for (k = 0; k < REG_DMA_TYPE_MAX; k++) {
 		memset(&hw, 0, sizeof(hw));
@@ -954,72 +1118,103 @@ int reset_v1(struct sde_hw_ctl *ctl)
 	return 0;
 }
 
-static void sde_reg_dma_aspace_cb_locked(void *cb_data, bool is_detach)
+static void reg_dma_arena_bind_buf(struct sde_reg_dma_arena_chunk *chunk,
+		struct sde_reg_dma_buffer *dma_buf)
+{
+	if (!chunk->iova) {
+		dma_buf->iova = 0;
+		return;
+	}
+
+	dma_buf->iova = chunk->iova + dma_buf->offset;
+	dma_buf->vaddr = (u8 *)chunk->vaddr + dma_buf->offset;
+	dma_buf->next_op_allowed = DECODE_SEL_OP;
+}
+
+static int reg_dma_arena_map_chunk(struct sde_reg_dma_arena_chunk *chunk)
 {
-	struct sde_reg_dma_buffer *dma_buf = NULL;
-	struct msm_gem_address_space *aspace = NULL;
 	u32 iova_aligned, offset;
 	int rc;
 
-	if (!cb_data) {
-		DRM_ERROR("aspace cb called with invalid dma_buf\n");
-		return;
+	rc = msm_gem_get_iova(chunk->buf, chunk->aspace, &chunk->iova);
+	if (rc) {
+		DRM_ERROR("failed to get the iova rc %d\n", rc);
+		chunk->iova = 0;
+		return rc;
 	}
 
-	dma_buf = (struct sde_reg_dma_buffer *)cb_data;
-	aspace = dma_buf->aspace;
+	chunk->vaddr = msm_gem_get_vaddr(chunk->buf);
+	if (IS_ERR_OR_NULL(chunk->vaddr)) {
+		DRM_ERROR("failed to get va\n");
+		msm_gem_put_iova(chunk->buf, chunk->aspace);
+		chunk->iova = 0;
+		chunk->vaddr = NULL;
+		return -EINVAL;
+	}
+
+	iova_aligned = (chunk->iova + GUARD_BYTES) & ALIGNED_OFFSET;
+	offset = iova_aligned - chunk->iova;
+	chunk->iova = chunk->iova + offset;
+	chunk->vaddr = (void *)(((u8 *)chunk->vaddr) + offset);
+
+	return 0;
+}
+
+/* rebinds every buffer of the chunk when the aspace is attached/detached */
+static void sde_reg_dma_aspace_cb_locked(void *cb_data, bool is_detach)
+{
+	struct sde_reg_dma_arena_chunk *chunk = cb_data;
+	struct sde_reg_dma_buffer *dma_buf;
+
+	if (!chunk) {
+		DRM_ERROR("aspace cb called with invalid chunk\n");
+		return;
+	}
 
 	if (is_detach) {
 		/* invalidate the stored iova */
-		dma_buf->iova = 0;
+		chunk->iova = 0;
 
 		/* return the virtual address mapping */
-		msm_gem_put_vaddr(dma_buf->buf);
-		msm_gem_vunmap(dma_buf->buf, OBJ_LOCK_NORMAL);
+		msm_gem_put_vaddr(chunk->buf);
+		msm_gem_vunmap(chunk->buf, OBJ_LOCK_NORMAL);
+	} else if (reg_dma_arena_map_chunk(chunk)) {
+		return;
+	}
 
-	} else {
-		rc = msm_gem_get_iova(dma_buf->buf, aspace,
-				&dma_buf->iova);
-		if (rc) {
-			DRM_ERROR("failed to get the iova rc %d\n", rc);
-			return;
-		}
+	mutex_lock(&reg_dma_arena_lock);
+	list_for_each_entry(dma_buf, &chunk->bufs, node)
+		reg_dma_arena_bind_buf(chunk, dma_buf);
+	mutex_unlock(&reg_dma_arena_lock);
+}
 
-		dma_buf->vaddr = msm_gem_get_vaddr(dma_buf->buf);
-		if (IS_ERR_OR_NULL(dma_buf->vaddr)) {
-			DRM_ERROR("failed to get va rc %d\n", rc);
-			return;
-		}
+static void reg_dma_arena_free_chunk(struct sde_reg_dma_arena_chunk *chunk)
+{
+	msm_gem_put_iova(chunk->buf, chunk->aspace);
+	msm_gem_address_space_unregister_cb(chunk->aspace,
+			sde_reg_dma_aspace_cb_locked, chunk);
+	mutex_lock(&reg_dma->drm_dev->struct_mutex);
+	msm_gem_free_object(chunk->buf);
+	mutex_unlock(&reg_dma->drm_dev->struct_mutex);
 
-		iova_aligned = (dma_buf->iova + GUARD_BYTES) & ALIGNED_OFFSET;
-		offset = iova_aligned - dma_buf->iova;
-		dma_buf->iova = dma_buf->iova + offset;
-		dma_buf->vaddr = (void *)(((u8 *)dma_buf->vaddr) + offset);
-		dma_buf->next_op_allowed = DECODE_SEL_OP;
-	}
+	reg_dma->arena_stats.chunks--;
+	kfree(chunk);
 }
 
-static struct sde_reg_dma_buffer *alloc_reg_dma_buf_v1(u32 size)
+static struct sde_reg_dma_arena_chunk *reg_dma_arena_new_chunk(void)
 {
-	struct sde_reg_dma_buffer *dma_buf = NULL;
-	u32 iova_aligned, offset;
-	u32 rsize = size + GUARD_BYTES;
+	struct sde_reg_dma_arena_chunk *chunk;
 	struct msm_gem_address_space *aspace = NULL;
 	int rc = 0;
 
-	if (!size || SIZE_DWORD(size) > MAX_DWORDS_SZ) {
-		DRM_ERROR("invalid buffer size %d, max %d\n",
-				SIZE_DWORD(size), MAX_DWORDS_SZ);
-		return ERR_PTR(-EINVAL);
-	}
-
-	dma_buf = kzalloc(sizeof(*dma_buf), GFP_KERNEL);
-	if (!dma_buf)
+	chunk = kzalloc(sizeof(*chunk), GFP_KERNEL);
+	if (!chunk)
 		return ERR_PTR(-ENOMEM);
 
-	dma_buf->buf = msm_gem_new(reg_dma->drm_dev,
-				    rsize, MSM_BO_UNCACHED);
-	if (IS_ERR_OR_NULL(dma_buf->buf)) {
+	INIT_LIST_HEAD(&chunk->bufs);
+	chunk->buf = msm_gem_new(reg_dma->drm_dev,
+			REG_DMA_ARENA_CHUNK_SZ + GUARD_BYTES, MSM_BO_UNCACHED);
+	if (IS_ERR_OR_NULL(chunk->buf)) {
 		rc = -EINVAL;
 		goto fail;
 	}
@@ -1036,73 +1231,173 @@ static struct sde_reg_dma_buffer *alloc_reg_dma_buf_v1(u32 size)
 		DRM_ERROR("failed to get aspace %d", rc);
 		goto free_gem;
 	} else if (aspace) {
-		/* register to aspace */
+		/* one registration covers every buffer of the chunk */
 		rc = msm_gem_address_space_register_cb(aspace,
-				sde_reg_dma_aspace_cb_locked,
-				(void *)dma_buf);
+				sde_reg_dma_aspace_cb_locked, chunk);
 		if (rc) {
 			DRM_ERROR("failed to register callback %d", rc);
 			goto free_gem;
 		}
 	}
 
-	dma_buf->aspace = aspace;
-	rc = msm_gem_get_iova(dma_buf->buf, aspace, &dma_buf->iova);
-	if (rc) {
-		DRM_ERROR("failed to get the iova rc %d\n", rc);
+	chunk->aspace = aspace;
+	rc = reg_dma_arena_map_chunk(chunk);
+	if (rc)
 		goto free_aspace_cb;
-	}
 
-	dma_buf->vaddr = msm_gem_get_vaddr(dma_buf->buf);
-	if (IS_ERR_OR_NULL(dma_buf->vaddr)) {
-		DRM_ERROR("failed to get va rc %d\n", rc);
-		rc = -EINVAL;
-		goto put_iova;
-	}
-
-	dma_buf->buffer_size = size;
-	iova_aligned = (dma_buf->iova + GUARD_BYTES) & ALIGNED_OFFSET;
-	offset = iova_aligned - dma_buf->iova;
-	dma_buf->iova = dma_buf->iova + offset;
-	dma_buf->vaddr = (void *)(((u8 *)dma_buf->vaddr) + offset);
-	dma_buf->next_op_allowed = DECODE_SEL_OP;
+	reg_dma->arena_stats.chunks++;
+	return chunk;
 
-	return dma_buf;
-
-put_iova:
-	msm_gem_put_iova(dma_buf->buf, aspace);
 free_aspace_cb:
 	msm_gem_address_space_unregister_cb(aspace,
-			sde_reg_dma_aspace_cb_locked, dma_buf);
+			sde_reg_dma_aspace_cb_locked, chunk);
 free_gem:
 	mutex_lock(&reg_dma->drm_dev->struct_mutex);
-	msm_gem_free_object(dma_buf->buf);
+	msm_gem_free_object(chunk->buf);
 	mutex_unlock(&reg_dma->drm_dev->struct_mutex);
 fail:
-	kfree(dma_buf);
+	kfree(chunk);
 	return ERR_PTR(rc);
 }
 
+/* carve the buffer out of the first chunk with room, called locked */
+static int reg_dma_arena_carve(struct sde_reg_dma_buffer *dma_buf,
+		u32 granules)
+{
+	struct sde_reg_dma_arena_chunk *chunk;
+	unsigned long pos;
+
+	list_for_each_entry(chunk, &reg_dma_arena, list) {
+		if (REG_DMA_ARENA_GRANULES - chunk->used < granules)
+			continue;
+
+		pos = bitmap_find_next_zero_area(chunk->map,
+				REG_DMA_ARENA_GRANULES, 0, granules, 0);
+		if (pos >= REG_DMA_ARENA_GRANULES)
+			continue;
+
+		bitmap_set(chunk->map, pos, granules);
+		chunk->used += granules;
+		dma_buf->chunk = chunk;
+		dma_buf->buf = chunk->buf;
+		dma_buf->aspace = chunk->aspace;
+		dma_buf->offset = pos * ADDR_ALIGN;
+		list_add_tail(&dma_buf->node, &chunk->bufs);
+		reg_dma_arena_bind_buf(chunk, dma_buf);
+		return 0;
+	}
+
+	return -ENOSPC;
+}
+
+static struct sde_reg_dma_buffer *alloc_reg_dma_buf_v1(u32 size)
+{
+	struct sde_reg_dma_buffer *dma_buf = NULL;
+	struct sde_reg_dma_arena_chunk *chunk;
+	struct sde_reg_dma_arena_stats *stats;
+	u32 granules;
+	int rc;
+
+	if (!size || SIZE_DWORD(size) > MAX_DWORDS_SZ) {
+		DRM_ERROR("invalid buffer size %d, max %d\n",
+				SIZE_DWORD(size), MAX_DWORDS_SZ);
+		return ERR_PTR(-EINVAL);
+	}
+
+	dma_buf = kzalloc(sizeof(*dma_buf), GFP_KERNEL);
+	if (!dma_buf)
+		return ERR_PTR(-ENOMEM);
+
+	dma_buf->buffer_size = size;
+	granules = DIV_ROUND_UP(size, ADDR_ALIGN);
+
+	mutex_lock(&reg_dma_arena_lock);
+	rc = reg_dma_arena_carve(dma_buf, granules);
+	mutex_unlock(&reg_dma_arena_lock);
+
+	if (rc == -ENOSPC) {
+		/* mapping a chunk takes aspace locks, keep the arena unlocked */
+		chunk = reg_dma_arena_new_chunk();
+		if (IS_ERR(chunk)) {
+			kfree(dma_buf);
+			return ERR_CAST(chunk);
+		}
+
+		mutex_lock(&reg_dma_arena_lock);
+		list_add_tail(&chunk->list, &reg_dma_arena);
+		rc = reg_dma_arena_carve(dma_buf, granules);
+		mutex_unlock(&reg_dma_arena_lock);
+	}
+
+	if (rc) {
+		kfree(dma_buf);
+		return ERR_PTR(rc);
+	}
+
+	stats = &reg_dma->arena_stats;
+	stats->buffers++;
+	stats->used_bytes += granules * ADDR_ALIGN;
+	stats->peak_bytes = max(stats->peak_bytes, stats->used_bytes);
+
+	return dma_buf;
+}
+
 static int dealloc_reg_dma_v1(struct sde_reg_dma_buffer *dma_buf)
 {
+	struct sde_reg_dma_arena_chunk *chunk;
+	u32 granules;
+
 	if (!dma_buf) {
 		DRM_ERROR("invalid param reg_buf %pK\n", dma_buf);
 		return -EINVAL;
 	}
 
-	if (dma_buf->buf) {
-		msm_gem_put_iova(dma_buf->buf, 0);
-		msm_gem_address_space_unregister_cb(dma_buf->aspace,
-				sde_reg_dma_aspace_cb_locked, dma_buf);
-		mutex_lock(&reg_dma->drm_dev->struct_mutex);
-		msm_gem_free_object(dma_buf->buf);
-		mutex_unlock(&reg_dma->drm_dev->struct_mutex);
+	chunk = dma_buf->chunk;
+	if (chunk) {
+		granules = DIV_ROUND_UP(dma_buf->buffer_size, ADDR_ALIGN);
+
+		mutex_lock(&reg_dma_arena_lock);
+		list_del(&dma_buf->node);
+		bitmap_clear(chunk->map, dma_buf->offset / ADDR_ALIGN,
+				granules);
+		chunk->used -= granules;
+		reg_dma->arena_stats.buffers--;
+		reg_dma->arena_stats.used_bytes -= granules * ADDR_ALIGN;
+
+		/* keep the first chunk, it holds the long lived buffers */
+		if (!chunk->used && !list_is_first(&chunk->list,
+				&reg_dma_arena))
+			list_del(&chunk->list);
+		else
+			chunk = NULL;
+		mutex_unlock(&reg_dma_arena_lock);
+
+		if (chunk)
+			reg_dma_arena_free_chunk(chunk);
 	}
 
 	kfree(dma_buf);
 	return 0;
 }
 
+static void reg_dma_arena_deinit(void)
+{
+	struct sde_reg_dma_arena_chunk *chunk, *tmp;
+	LIST_HEAD(chunks);
+
+	mutex_lock(&reg_dma_arena_lock);
+	list_for_each_entry_safe(chunk, tmp, &reg_dma_arena, list) {
+		if (!chunk->used)
+			list_move_tail(&chunk->list, &chunks);
+	}
+	mutex_unlock(&reg_dma_arena_lock);
+
+	list_for_each_entry_safe(chunk, tmp, &chunks, list) {
+		list_del(&chunk->list);
+		reg_dma_arena_free_chunk(chunk);
+	}
+}
+
 static int reset_reg_dma_buffer_v1(struct sde_reg_dma_buffer *lut_buf)
 {
 	if (!lut_buf)
@@ -1143,12 +1438,62 @@ static int write_last_cmd(struct sde_reg_dma_setup_ops_cfg *cfg)
 	return 0;
 }
 
+/* called with the coalesce lock of the ctl held */
+static void update_coalesce_stats_v1(enum sde_ctl idx)
+{
+	struct sde_reg_dma_coalesce_stats *stats =
+			&reg_dma->coalesce_stats[idx];
+	struct reg_dma_coalesce *c = &coalesce[idx];
+
+	stats->frames++;
+	stats->kickoffs += c->kickoffs;
+	stats->last_kickoffs = c->kickoffs;
+	stats->last_bytes = c->bytes;
+	stats->max_bytes = max(stats->max_bytes, c->bytes);
+
+	SDE_EVT32(idx, c->kickoffs, c->bytes, c->closed);
+	reset_coalesce_v1(idx);
+}
+
+/*
+ * With a single flush only the master ctl receives a last command, the
+ * payloads merged on a slave ctl would never be kicked off. The encoder
+ * submits them as plain queue writes ahead of the master last command,
+ * which is what the direct kick off did before the writes were merged.
+ */
+static int kick_off_pending_v1(struct sde_hw_ctl *ctl)
+{
+	struct reg_dma_coalesce *c;
+	int rc = 0;
+
+	if (!ctl || ctl->idx >= CTL_MAX) {
+		DRM_ERROR("invalid ctl %pK ctl idx %d\n",
+			ctl, ((ctl) ? ctl->idx : 0));
+		return -EINVAL;
+	}
+
+	c = &coalesce[ctl->idx];
+	mutex_lock(&c->lock);
+	/* a closed buffer was already submitted when it overflowed */
+	if (!c->closed && c->buf && c->buf->index)
+		rc = submit_coalesce_v1(ctl, 0);
+	update_coalesce_stats_v1(ctl->idx);
+	mutex_unlock(&c->lock);
+
+	if (rc)
+		DRM_ERROR("kick off coalesced ctl %d failed %d\n",
+				ctl->idx, rc);
+	return rc;
+}
+
 static int last_cmd_v1(struct sde_hw_ctl *ctl, enum sde_reg_dma_queue q,
 		enum sde_reg_dma_last_cmd_mode mode)
 {
 	struct sde_reg_dma_setup_ops_cfg cfg;
 	struct sde_reg_dma_kickoff_cfg kick_off;
 	struct sde_hw_blk_reg_map hw;
+	struct reg_dma_coalesce *c;
+	u32 *loc;
 	u32 val;
 	int rc;
 
@@ -1163,6 +1508,30 @@ static int last_cmd_v1(struct sde_hw_ctl *ctl, enum sde_reg_dma_queue q,
 		return -EINVAL;
 	}
 
+	c = &coalesce[ctl->idx];
+	if (q == DMA_CTL_QUEUE0)
+		mutex_lock(&c->lock);
+	if (q == DMA_CTL_QUEUE0 && !c->closed && c->buf && c->buf->index) {
+		/* single submission: merged payloads followed by last cmd */
+		loc = (u32 *)((u8 *)c->buf->vaddr + c->buf->index);
+		loc[0] = reg_dma_decode_sel;
+		loc[1] = 0;
+		c->buf->index += REG_DMA_LAST_CMD_SZ;
+		rc = submit_coalesce_v1(ctl, 1);
+		update_coalesce_stats_v1(ctl->idx);
+		mutex_unlock(&c->lock);
+		if (rc) {
+			DRM_ERROR("kick off coalesced last cmd failed\n");
+			return rc;
+		}
+		kick_off.dma_type = REG_DMA_TYPE_DB;
+		kick_off.queue_select = q;
+		kick_off.op = REG_DMA_WRITE;
+		goto wait;
+	}
+	if (q == DMA_CTL_QUEUE0)
+		mutex_unlock(&c->lock);
+
 	cfg.dma_buf = last_cmd_buf_db[ctl->idx];
 	reset_reg_dma_buffer_v1(last_cmd_buf_db[ctl->idx]);
 	if (validate_last_cmd(&cfg)) {
@@ -1184,11 +1553,17 @@ static int last_cmd_v1(struct sde_hw_ctl *ctl, enum sde_reg_dma_queue q,
 	kick_off.dma_buf = last_cmd_buf_db[ctl->idx];
 	kick_off.feature = REG_DMA_FEATURES_MAX;
 	rc = kick_off_v1(&kick_off);
+	if (q == DMA_CTL_QUEUE0) {
+		mutex_lock(&c->lock);
+		update_coalesce_stats_v1(ctl->idx);
+		mutex_unlock(&c->lock);
+	}
 	if (rc) {
 		DRM_ERROR("kick off last cmd failed\n");
 		return rc;
 	}
 
+wait:
 	//Lack of block support will be caught by kick_off
 	memset(&hw, 0, sizeof(hw));
 	SET_UP_REG_DMA_REG(hw, reg_dma, kick_off.dma_type);
@@ -1224,7 +1599,15 @@ void deinit_v1(void)
 		if (last_cmd_buf_sb[i])
 			dealloc_reg_dma_v1(last_cmd_buf_sb[i]);
 		last_cmd_buf_sb[i] = NULL;
+		mutex_lock(&coalesce[i].lock);
+		if (coalesce[i].buf)
+			dealloc_reg_dma_v1(coalesce[i].buf);
+		coalesce[i].buf = NULL;
+		reset_coalesce_v1(i);
+		mutex_unlock(&coalesce[i].lock);
 	}
+
+	reg_dma_arena_deinit();
 }
 
 static void dump_regs_v1(void)
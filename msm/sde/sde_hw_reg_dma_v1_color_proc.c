@@ -114,6 +114,13 @@
 
 #define REG_DMA_DSPP_GAMUT_OP_MASK 0xFFFFFFE0
 
+/* LUT delta programming */
+#define LUT_SHADOW_BANKS 2
+#define LUT_DIRECT_ADDR U32_MAX
+#define LUT_OP_DWORDS 2
+/* updates costing more than 3/4 of a full write are written in full */
+#define LUT_DELTA_MAX_BYTES(full) (((full) * 3) / 4)
+
 #define LOG_FEATURE_OFF SDE_EVT32(ctx->idx, 0)
 #define LOG_FEATURE_ON SDE_EVT32(ctx->idx, 1)
 
@@ -132,6 +139,45 @@ static struct sde_reg_dma_buffer
 	*sspp_buf[SDE_SSPP_RECT_MAX][REG_DMA_FEATURES_MAX][SSPP_MAX];
 static struct sde_reg_dma_buffer *ltm_buf[REG_DMA_FEATURES_MAX][LTM_MAX];
 
+/**
+ * struct reg_dmav1_lut_shadow - last values programmed into a dspp LUT
+ * @data: shadow copy of each bank, allocated on first use
+ * @valid: bank content is known to match @data
+ * @banks: 2 for LUTs written to the inactive bank and swapped, 1 otherwise
+ * @bank: bank the next update is written to
+ * @blk: decode select the banks were programmed through
+ * @gen: reg dma shadow generation the banks were programmed in
+ */
+struct reg_dmav1_lut_shadow {
+	u32 *data[LUT_SHADOW_BANKS];
+	bool valid[LUT_SHADOW_BANKS];
+	u32 banks;
+	u32 bank;
+	u32 blk;
+	u32 gen;
+};
+
+/**
+ * struct reg_dmav1_lut_delta - state of a LUT update in progress
+ * @shadow: shadow of the LUT, NULL if it could not be allocated
+ * @prev: content of the bank being written, NULL if unknown
+ * @full: at least one table was written in full
+ * @runs: changed runs emitted
+ * @full_bytes: payload bytes a full write would have taken
+ * @bytes: payload bytes emitted
+ */
+struct reg_dmav1_lut_delta {
+	struct reg_dmav1_lut_shadow *shadow;
+	u32 *prev;
+	bool full;
+	u32 runs;
+	u32 full_bytes;
+	u32 bytes;
+};
+
+static struct reg_dmav1_lut_shadow
+	dspp_lut_shadow[REG_DMA_FEATURES_MAX][DSPP_MAX];
+
 static u32 feature_map[SDE_DSPP_MAX] = {
 	[SDE_DSPP_VLUT] = VLUT,
 	[SDE_DSPP_GAMUT] = GAMUT,
@@ -869,6 +915,210 @@ void reg_dmav1_setup_dspp_3d_gamutv42(struct sde_hw_dspp *ctx, void *cfg)
 	}
 }
 
+static void reg_dmav1_lut_shadow_invalidate(
+		struct reg_dmav1_lut_shadow *shadow)
+{
+	memset(shadow->valid, 0, sizeof(shadow->valid));
+	shadow->bank = 0;
+}
+
+static void reg_dmav1_lut_shadow_free(struct reg_dmav1_lut_shadow *shadow)
+{
+	int i;
+
+	for (i = 0; i < LUT_SHADOW_BANKS; i++)
+		kvfree(shadow->data[i]);
+	memset(shadow, 0, sizeof(*shadow));
+}
+
+static int reg_dmav1_lut_shadow_alloc(struct reg_dmav1_lut_shadow *shadow,
+		u32 len, u32 banks)
+{
+	u32 i;
+
+	for (i = 0; i < banks; i++) {
+		shadow->data[i] = kvzalloc(len * sizeof(u32), GFP_KERNEL);
+		if (!shadow->data[i]) {
+			reg_dmav1_lut_shadow_free(shadow);
+			return -ENOMEM;
+		}
+	}
+	shadow->banks = banks;
+
+	return 0;
+}
+
+/*
+ * Start a LUT update on a shadow. Delta writes are only possible when the
+ * bank about to be written was programmed through the same blocks in the
+ * current shadow generation.
+ */
+static void reg_dmav1_lut_delta_begin(struct reg_dmav1_lut_delta *delta,
+		struct reg_dmav1_lut_shadow *shadow, u32 len, u32 banks,
+		u32 blk)
+{
+	u32 gen = sde_reg_dma_get_shadow_gen();
+
+	memset(delta, 0, sizeof(*delta));
+	if (!shadow->data[0] && reg_dmav1_lut_shadow_alloc(shadow, len, banks))
+		return;
+
+	delta->shadow = shadow;
+	if (!gen || shadow->gen != gen || shadow->blk != blk) {
+		reg_dmav1_lut_shadow_invalidate(shadow);
+		shadow->gen = gen;
+		shadow->blk = blk;
+	}
+
+	if (shadow->valid[shadow->bank])
+		delta->prev = shadow->data[shadow->bank];
+	/* the bank is rewritten, it is valid again once the update succeeds */
+	shadow->valid[shadow->bank] = false;
+}
+
+static void reg_dmav1_lut_delta_end(struct reg_dmav1_lut_delta *delta,
+		enum sde_reg_dma_features feature, enum sde_dspp idx, int rc)
+{
+	struct reg_dmav1_lut_shadow *shadow = delta->shadow;
+	int i;
+
+	if (!rc)
+		sde_reg_dma_update_lut_delta_stats(feature, delta->full,
+				delta->runs, delta->full_bytes, delta->bytes);
+	if (!shadow)
+		return;
+
+	if (rc) {
+		reg_dmav1_lut_shadow_invalidate(shadow);
+		return;
+	}
+
+	shadow->valid[shadow->bank] = true;
+	shadow->bank = (shadow->bank + 1) % shadow->banks;
+
+	/* other dspps written through this broadcast no longer match theirs */
+	for (i = 0; i < DSPP_MAX; i++) {
+		if (i != idx && (dspp_lut_shadow[feature][i].blk & shadow->blk))
+			reg_dmav1_lut_shadow_invalidate(
+					&dspp_lut_shadow[feature][i]);
+	}
+}
+
+static u32 reg_dmav1_lut_run_bytes(bool indexed, u32 count)
+{
+	u32 dwords = (count == 1) ? LUT_OP_DWORDS : LUT_OP_DWORDS + count;
+
+	if (indexed)
+		dwords += LUT_OP_DWORDS;
+
+	return dwords * sizeof(u32);
+}
+
+/*
+ * Find the next run of changed entries at or after *start. Unchanged gaps
+ * shorter than the cost of starting a new run are folded into the run.
+ */
+static u32 reg_dmav1_lut_next_run(const u32 *data, const u32 *prev, u32 len,
+		u32 gap, u32 *start)
+{
+	u32 i = *start, end;
+
+	while (i < len && data[i] == prev[i])
+		i++;
+	if (i == len)
+		return 0;
+
+	*start = i;
+	end = ++i;
+	for (; i < len && i - end <= gap; i++) {
+		if (data[i] != prev[i])
+			end = i + 1;
+	}
+
+	return end - *start;
+}
+
+static int reg_dmav1_write_lut_run(struct sde_reg_dma_setup_ops_cfg *cfg,
+		u32 index_off, u32 data_off, u32 start, u32 *data, u32 count)
+{
+	struct sde_hw_reg_dma_ops *dma_ops = sde_reg_dma_get_ops();
+	enum sde_reg_dma_setup_ops op;
+	int rc;
+
+	if (index_off == LUT_DIRECT_ADDR) {
+		op = (count == 1) ? REG_SINGLE_WRITE : REG_BLK_WRITE_SINGLE;
+		data_off += start * sizeof(u32);
+	} else {
+		op = (count == 1) ? REG_SINGLE_WRITE : REG_BLK_WRITE_INC;
+		REG_DMA_SETUP_OPS(*cfg, index_off, &start, sizeof(start),
+				REG_SINGLE_WRITE, 0, 0, 0);
+		rc = dma_ops->setup_payload(cfg);
+		if (rc)
+			return rc;
+	}
+
+	REG_DMA_SETUP_OPS(*cfg, data_off, data + start, count * sizeof(u32),
+			op, 0, 0, 0);
+	return dma_ops->setup_payload(cfg);
+}
+
+/**
+ * reg_dmav1_write_lut - write a LUT table, only the changed runs if cheaper
+ * @cfg: reg dma setup cfg of the feature buffer
+ * @delta: LUT update the table belongs to
+ * @first: index of the table's first entry within the shadow
+ * @data: table content
+ * @len: number of table entries
+ * @index_off: offset of the table index register, LUT_DIRECT_ADDR when the
+ *             entries are individually addressed registers
+ * @data_off: offset of the table data port or first entry register
+ */
+static int reg_dmav1_write_lut(struct sde_reg_dma_setup_ops_cfg *cfg,
+		struct reg_dmav1_lut_delta *delta, u32 first, u32 *data,
+		u32 len, u32 index_off, u32 data_off)
+{
+	bool indexed = (index_off != LUT_DIRECT_ADDR);
+	u32 gap = indexed ? LUT_OP_DWORDS * 2 : LUT_OP_DWORDS;
+	u32 full_bytes = reg_dmav1_lut_run_bytes(indexed, len);
+	u32 *prev = delta->prev ? delta->prev + first : NULL;
+	u32 start, count, runs = 0, bytes = 0;
+	int rc = 0;
+
+	if (prev) {
+		for (start = 0; (count = reg_dmav1_lut_next_run(data, prev,
+				len, gap, &start)); start += count) {
+			bytes += reg_dmav1_lut_run_bytes(indexed, count);
+			runs++;
+		}
+		if (bytes > LUT_DELTA_MAX_BYTES(full_bytes))
+			prev = NULL;
+	}
+
+	if (!prev) {
+		rc = reg_dmav1_write_lut_run(cfg, index_off, data_off, 0,
+				data, len);
+		bytes = full_bytes;
+		runs = 0;
+		delta->full = true;
+	} else {
+		for (start = 0; !rc && (count = reg_dmav1_lut_next_run(data,
+				prev, len, gap, &start)); start += count)
+			rc = reg_dmav1_write_lut_run(cfg, index_off, data_off,
+					start, data, count);
+	}
+	if (rc)
+		return rc;
+
+	if (delta->shadow)
+		memcpy(delta->shadow->data[delta->shadow->bank] + first, data,
+				len * sizeof(u32));
+	delta->runs += runs;
+	delta->full_bytes += full_bytes;
+	delta->bytes += bytes;
+
+	return 0;
+}
+
 void reg_dmav1_setup_dspp_gcv18(struct sde_hw_dspp *ctx, void *cfg)
 {
 	struct drm_msm_pgc_lut *lut_cfg;
@@ -876,6 +1126,7 @@ void reg_dmav1_setup_dspp_gcv18(struct sde_hw_dspp *ctx, void *cfg)
 	struct sde_reg_dma_kickoff_cfg kick_off;
 	struct sde_hw_cp_cfg *hw_cfg = cfg;
 	struct sde_reg_dma_setup_ops_cfg dma_write_cfg;
+	struct reg_dmav1_lut_delta delta;
 	int rc, i = 0;
 	u32 reg;
 	u32 *addr[GC_TBL_NUM];
@@ -889,6 +1140,7 @@ void reg_dmav1_setup_dspp_gcv18(struct sde_hw_dspp *ctx, void *cfg)
 		DRM_DEBUG_DRIVER("disable pgc feature\n");
 		LOG_FEATURE_OFF;
 		SDE_REG_WRITE(&ctx->hw, ctx->cap->sblk->gc.base, 0);
+		reg_dmav1_lut_shadow_invalidate(&dspp_lut_shadow[GC][ctx->idx]);
 		return;
 	}
 
@@ -920,31 +1172,23 @@ void reg_dmav1_setup_dspp_gcv18(struct sde_hw_dspp *ctx, void *cfg)
 		return;
 	}
 
+	/* the tables are written to the inactive bank and swapped in */
+	reg_dmav1_lut_delta_begin(&delta, &dspp_lut_shadow[GC][ctx->idx],
+			GC_TBL_NUM * PGC_TBL_LEN, LUT_SHADOW_BANKS, blk);
+
 	addr[0] = lut_cfg->c0;
 	addr[1] = lut_cfg->c1;
 	addr[2] = lut_cfg->c2;
 	for (i = 0; i < GC_TBL_NUM; i++) {
-		reg = 0;
-		REG_DMA_SETUP_OPS(dma_write_cfg,
+		rc = reg_dmav1_write_lut(&dma_write_cfg, &delta,
+			i * PGC_TBL_LEN, addr[i], PGC_TBL_LEN,
 			ctx->cap->sblk->gc.base + GC_C0_INDEX_OFF +
 			(i * sizeof(u32) * 2),
-			&reg, sizeof(reg), REG_SINGLE_WRITE, 0, 0, 0);
-		rc = dma_ops->setup_payload(&dma_write_cfg);
-		if (rc) {
-			DRM_ERROR("index init failed ret %d\n", rc);
-			return;
-		}
-
-		REG_DMA_SETUP_OPS(dma_write_cfg,
 			ctx->cap->sblk->gc.base + GC_C0_OFF +
-			(i * sizeof(u32) * 2),
-			addr[i],
-			PGC_TBL_LEN * sizeof(u32),
-			REG_BLK_WRITE_INC, 0, 0, 0);
-		rc = dma_ops->setup_payload(&dma_write_cfg);
+			(i * sizeof(u32) * 2));
 		if (rc) {
 			DRM_ERROR("lut write failed ret %d\n", rc);
-			return;
+			goto exit;
 		}
 	}
 
@@ -955,7 +1199,7 @@ void reg_dmav1_setup_dspp_gcv18(struct sde_hw_dspp *ctx, void *cfg)
 	rc = dma_ops->setup_payload(&dma_write_cfg);
 	if (rc) {
 		DRM_ERROR("setting swap offset failed ret %d\n", rc);
-		return;
+		goto exit;
 	}
 
 	reg = GC_EN | ((lut_cfg->flags & PGC_8B_ROUND) ? GC_8B_ROUND_EN : 0);
@@ -965,17 +1209,18 @@ void reg_dmav1_setup_dspp_gcv18(struct sde_hw_dspp *ctx, void *cfg)
 	rc = dma_ops->setup_payload(&dma_write_cfg);
 	if (rc) {
 		DRM_ERROR("enabling gamma correction failed ret %d\n", rc);
-		return;
+		goto exit;
 	}
 
 	REG_DMA_SETUP_KICKOFF(kick_off, hw_cfg->ctl, dspp_buf[GC][ctx->idx],
 			REG_DMA_WRITE, DMA_CTL_QUEUE0, WRITE_IMMEDIATE, GC);
 	LOG_FEATURE_ON;
 	rc = dma_ops->kick_off(&kick_off);
-	if (rc) {
+	if (rc)
 		DRM_ERROR("failed to kick off ret %d\n", rc);
-		return;
-	}
+
+exit:
+	reg_dmav1_lut_delta_end(&delta, GC, ctx->idx, rc);
 }
 
 static void _dspp_igcv31_off(struct sde_hw_dspp *ctx, void *cfg)
@@ -1295,6 +1540,7 @@ void reg_dmav1_setup_dspp_pcc_common(struct sde_hw_dspp *ctx, void *cfg)
 	struct sde_reg_dma_setup_ops_cfg dma_write_cfg;
 	struct drm_msm_pcc *pcc_cfg;
 	struct drm_msm_pcc_coeff *coeffs = NULL;
+	struct reg_dmav1_lut_delta delta;
 	u32 *data = NULL;
 	int rc, i = 0;
 	u32 reg = 0;
@@ -1308,6 +1554,7 @@ void reg_dmav1_setup_dspp_pcc_common(struct sde_hw_dspp *ctx, void *cfg)
 		DRM_DEBUG_DRIVER("disable pcc feature\n");
 		LOG_FEATURE_OFF;
 		_dspp_pcc_common_off(ctx, cfg);
+		reg_dmav1_lut_shadow_invalidate(&dspp_lut_shadow[PCC][ctx->idx]);
 		return;
 	}
 
@@ -1378,17 +1625,16 @@ void reg_dmav1_setup_dspp_pcc_common(struct sde_hw_dspp *ctx, void *cfg)
 		data[i + 21] = coeffs->rgb;
 	}
 
-	REG_DMA_SETUP_OPS(dma_write_cfg,
-		ctx->cap->sblk->pcc.base + PCC_C_OFF,
-		data, PCC_LEN,
-		REG_BLK_WRITE_SINGLE, 0, 0, 0);
-	rc = dma_ops->setup_payload(&dma_write_cfg);
+	reg_dmav1_lut_delta_begin(&delta, &dspp_lut_shadow[PCC][ctx->idx],
+			PCC_LUT_ENTRIES, 1, blk);
+	rc = reg_dmav1_write_lut(&dma_write_cfg, &delta, 0, data,
+			PCC_LUT_ENTRIES, LUT_DIRECT_ADDR,
+			ctx->cap->sblk->pcc.base + PCC_C_OFF);
 	if (rc) {
 		DRM_ERROR("write pcc lut failed ret %d\n", rc);
-		goto exit;
+		goto end;
 	}
 
-
 	reg = PCC_EN;
 	if (pcc_cfg->flags & PCC_BEFORE)
 		reg |= BIT(16);
@@ -1399,7 +1645,7 @@ void reg_dmav1_setup_dspp_pcc_common(struct sde_hw_dspp *ctx, void *cfg)
 	rc = dma_ops->setup_payload(&dma_write_cfg);
 	if (rc) {
 		DRM_ERROR("setting opcode failed ret %d\n", rc);
-		goto exit;
+		goto end;
 	}
 
 	REG_DMA_SETUP_KICKOFF(kick_off, hw_cfg->ctl, dspp_buf[PCC][ctx->idx],
@@ -1409,6 +1655,8 @@ void reg_dmav1_setup_dspp_pcc_common(struct sde_hw_dspp *ctx, void *cfg)
 	if (rc)
 		DRM_ERROR("failed to kick off ret %d\n", rc);
 
+end:
+	reg_dmav1_lut_delta_end(&delta, PCC, ctx->idx, rc);
 exit:
 	kvfree(data);
 
@@ -1768,6 +2016,7 @@ int reg_dmav1_deinit_dspp_ops(enum sde_dspp idx)
 	}
 
 	for (i = 0; i < REG_DMA_FEATURES_MAX; i++) {
+		reg_dmav1_lut_shadow_free(&dspp_lut_shadow[i][idx]);
 		if (!dspp_buf[i][idx])
 			continue;
 		dma_ops->dealloc_reg_dma(dspp_buf[i][idx]);
@@ -3114,8 +3363,9 @@ void reg_dmav1_setup_vig_qseed3(struct sde_hw_pipe *ctx,
 	struct sde_hw_cp_cfg hw_cfg = {};
 	u32 op_mode = 0, offset;
 	u32 preload, src_y_rgb, src_uv, dst, dir_weight;
-	u32 cache[4];
+	u32 cache[4], lut_flag;
 	enum sde_sspp_multirect_index idx = SDE_SSPP_RECT_0;
+	ktime_t start;
 
 	if (!ctx || !pe || !scaler_cfg) {
 		DRM_ERROR("invalid params ctx %pK pe %pK scaler_cfg %pK",
@@ -3187,7 +3437,15 @@ void reg_dmav1_setup_vig_qseed3(struct sde_hw_pipe *ctx,
 			op_mode |= BIT(8);
 	}
 
+	lut_flag = scaler3_cfg->lut_flag;
+	if (sde_hw_scaler3_lut_cached(&ctx->hw, scaler3_cfg))
+		scaler3_cfg->lut_flag = 0;
+
+	start = ktime_get();
 	ctx->ops.setup_scaler_lut(&dma_write_cfg, scaler3_cfg, offset);
+	if (scaler3_cfg->lut_flag)
+		sde_hw_scaler3_lut_done(&ctx->hw, start);
+	scaler3_cfg->lut_flag = lut_flag;
 
 	cache[0] = scaler3_cfg->init_phase_x[0] & 0x1FFFFF;
 	cache[1] = scaler3_cfg->init_phase_y[0] & 0x1FFFFF;
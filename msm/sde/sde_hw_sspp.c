@@ -845,16 +845,16 @@ static void sde_hw_sspp_setup_qos_lut(struct sde_hw_pipe *ctx,
 	if (_sspp_subblk_offset(ctx, SDE_SSPP_SRC, &idx))
 		return;
 
-	SDE_REG_WRITE(&ctx->hw, SSPP_DANGER_LUT + idx, cfg->danger_lut);
-	SDE_REG_WRITE(&ctx->hw, SSPP_SAFE_LUT + idx, cfg->safe_lut);
+	SDE_REG_WRITE_CACHED(&ctx->hw, SSPP_DANGER_LUT + idx, cfg->danger_lut);
+	SDE_REG_WRITE_CACHED(&ctx->hw, SSPP_SAFE_LUT + idx, cfg->safe_lut);
 
 	if (ctx->cap && test_bit(SDE_PERF_SSPP_QOS_8LVL,
 				&ctx->cap->perf_features)) {
-		SDE_REG_WRITE(&ctx->hw, SSPP_CREQ_LUT_0 + idx, cfg->creq_lut);
-		SDE_REG_WRITE(&ctx->hw, SSPP_CREQ_LUT_1 + idx,
+		SDE_REG_WRITE_CACHED(&ctx->hw, SSPP_CREQ_LUT_0 + idx, cfg->creq_lut);
+		SDE_REG_WRITE_CACHED(&ctx->hw, SSPP_CREQ_LUT_1 + idx,
 				cfg->creq_lut >> 32);
 	} else {
-		SDE_REG_WRITE(&ctx->hw, SSPP_CREQ_LUT + idx, cfg->creq_lut);
+		SDE_REG_WRITE_CACHED(&ctx->hw, SSPP_CREQ_LUT + idx, cfg->creq_lut);
 	}
 }
 
@@ -880,7 +880,7 @@ static void sde_hw_sspp_setup_qos_ctrl(struct sde_hw_pipe *ctx,
 	if (cfg->danger_safe_en)
 		qos_ctrl |= SSPP_QOS_CTRL_DANGER_SAFE_EN;
 
-	SDE_REG_WRITE(&ctx->hw, SSPP_QOS_CTRL + idx, qos_ctrl);
+	SDE_REG_WRITE_CACHED(&ctx->hw, SSPP_QOS_CTRL + idx, qos_ctrl);
 }
 
 static void sde_hw_sspp_setup_ts_prefill(struct sde_hw_pipe *ctx,
@@ -1365,6 +1365,12 @@ struct sde_hw_pipe *sde_hw_sspp_init(enum sde_sspp idx,
 				cfg->sblk->scaler_blk.len,
 			hw_pipe->hw.xin_id);
 
+	/* shadow the source block and the csc, both rects share it */
+	if (sde_hw_reg_shadow_init(&hw_pipe->hw, cfg->name,
+			max_t(u32, hw_pipe->hw.length,
+			cfg->sblk->csc_blk.base + cfg->sblk->csc_blk.len)))
+		SDE_DEBUG("no register shadow for %s\n", cfg->name);
+
 	return hw_pipe;
 
 blk_init_error:
@@ -1378,6 +1384,7 @@ void sde_hw_sspp_destroy(struct sde_hw_pipe *ctx)
 	if (ctx) {
 		sde_hw_blk_destroy(&ctx->base);
 		reg_dmav1_deinit_sspp_ops(ctx->idx);
+		sde_hw_reg_shadow_deinit(&ctx->hw);
 		kfree(ctx->cap);
 	}
 	kfree(ctx);
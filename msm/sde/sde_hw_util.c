@@ -4,6 +4,9 @@
  */
 #define pr_fmt(fmt)	"[drm:%s:%d] " fmt, __func__, __LINE__
 
+#include <linux/debugfs.h>
+#include <linux/jhash.h>
+#include <linux/seq_file.h>
 #include <drm/sde_drm.h>
 #include "msm_drv.h"
 #include "sde_kms.h"
@@ -13,6 +16,11 @@
 /* using a file static variables for debugfs access */
 static u32 sde_hw_util_log_mask = SDE_DBG_MASK_NONE;
 
+/* register shadows of all blocks, for invalidation and debugfs */
+static LIST_HEAD(sde_hw_reg_shadow_list);
+static DEFINE_MUTEX(sde_hw_reg_shadow_lock);
+static bool sde_hw_reg_shadow_enable = true;
+
 /* SDE_SCALER_QSEED3 */
 #define QSEED3_HW_VERSION                  0x00
 #define QSEED3_OP_MODE                     0x04
@@ -80,7 +88,172 @@ void sde_reg_write(struct sde_hw_blk_reg_map *c,
 	SDE_EVT32_REGWRITE(c->blk_off + reg_off, val, GET_REG_BLK_ID(c));
 	writel_relaxed(val, c->base_off + c->blk_off + reg_off);
 	SDE_REG_LOG(GET_REG_BLK_ID(c), val, c->blk_off + reg_off);
+
+	/* keep the shadow coherent with uncached writes */
+	if (c->shadow && (reg_off >> 2) < c->shadow->count) {
+		c->shadow->val[reg_off >> 2] = val;
+		__set_bit(reg_off >> 2, c->shadow->valid);
+	}
+}
+
+void sde_reg_write_cached(struct sde_hw_blk_reg_map *c,
+		u32 reg_off,
+		u32 val,
+		const char *name)
+{
+	struct sde_hw_reg_shadow *shadow = c->shadow;
+	u32 idx = reg_off >> 2;
+
+	if (shadow && idx < shadow->count && sde_hw_reg_shadow_enable) {
+		if (test_bit(idx, shadow->valid) && shadow->val[idx] == val) {
+			shadow->hits++;
+			return;
+		}
+		shadow->misses++;
+	}
+
+	sde_reg_write(c, reg_off, val, name);
+}
+
+int sde_hw_reg_shadow_init(struct sde_hw_blk_reg_map *c, const char *name,
+		u32 size)
+{
+	struct sde_hw_reg_shadow *shadow;
+	void __iomem *addr;
+	int rc = 0;
+
+	if (!c || !size)
+		return -EINVAL;
+
+	addr = c->base_off + c->blk_off;
+
+	mutex_lock(&sde_hw_reg_shadow_lock);
+	list_for_each_entry(shadow, &sde_hw_reg_shadow_list, list) {
+		if (shadow->addr == addr) {
+			shadow->refcount++;
+			c->shadow = shadow;
+			goto exit;
+		}
+	}
+
+	shadow = kzalloc(sizeof(*shadow), GFP_KERNEL);
+	if (!shadow) {
+		rc = -ENOMEM;
+		goto exit;
+	}
+
+	shadow->count = size >> 2;
+	shadow->val = kcalloc(shadow->count, sizeof(u32), GFP_KERNEL);
+	shadow->valid = kcalloc(BITS_TO_LONGS(shadow->count),
+			sizeof(unsigned long), GFP_KERNEL);
+	if (!shadow->val || !shadow->valid) {
+		kfree(shadow->val);
+		kfree(shadow->valid);
+		kfree(shadow);
+		rc = -ENOMEM;
+		goto exit;
+	}
+
+	shadow->addr = addr;
+	shadow->name = name;
+	shadow->refcount = 1;
+	list_add_tail(&shadow->list, &sde_hw_reg_shadow_list);
+	c->shadow = shadow;
+
+exit:
+	mutex_unlock(&sde_hw_reg_shadow_lock);
+	return rc;
+}
+
+void sde_hw_reg_shadow_deinit(struct sde_hw_blk_reg_map *c)
+{
+	struct sde_hw_reg_shadow *shadow;
+
+	if (!c || !c->shadow)
+		return;
+
+	shadow = c->shadow;
+	c->shadow = NULL;
+
+	mutex_lock(&sde_hw_reg_shadow_lock);
+	if (--shadow->refcount) {
+		mutex_unlock(&sde_hw_reg_shadow_lock);
+		return;
+	}
+	list_del(&shadow->list);
+	mutex_unlock(&sde_hw_reg_shadow_lock);
+
+	kfree(shadow->val);
+	kfree(shadow->valid);
+	kfree(shadow);
+}
+
+void sde_hw_reg_shadow_invalidate(struct sde_hw_blk_reg_map *c)
+{
+	if (!c || !c->shadow)
+		return;
+
+	bitmap_zero(c->shadow->valid, c->shadow->count);
+	c->shadow->lut_hash = 0;
+}
+
+void sde_hw_reg_shadow_invalidate_all(void)
+{
+	struct sde_hw_reg_shadow *shadow;
+
+	mutex_lock(&sde_hw_reg_shadow_lock);
+	list_for_each_entry(shadow, &sde_hw_reg_shadow_list, list) {
+		bitmap_zero(shadow->valid, shadow->count);
+		shadow->lut_hash = 0;
+	}
+	mutex_unlock(&sde_hw_reg_shadow_lock);
+}
+
+#ifdef CONFIG_DEBUG_FS
+static int _sde_hw_reg_shadow_show(struct seq_file *s, void *data)
+{
+	struct sde_hw_reg_shadow *shadow;
+
+	mutex_lock(&sde_hw_reg_shadow_lock);
+	list_for_each_entry(shadow, &sde_hw_reg_shadow_list, list)
+		seq_printf(s,
+			"%-12s hits:%llu misses:%llu lut_hits:%llu lut_misses:%llu lut_us:%u lut_max_us:%u\n",
+			shadow->name ? shadow->name : "unknown",
+			shadow->hits, shadow->misses,
+			shadow->lut_hits, shadow->lut_misses,
+			shadow->lut_time_us, shadow->lut_time_max_us);
+	mutex_unlock(&sde_hw_reg_shadow_lock);
+
+	return 0;
+}
+
+static int _sde_hw_reg_shadow_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, _sde_hw_reg_shadow_show, inode->i_private);
+}
+
+static const struct file_operations sde_hw_reg_shadow_fops = {
+	.open = _sde_hw_reg_shadow_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+void sde_hw_reg_shadow_debugfs_init(struct dentry *root)
+{
+	if (!root)
+		return;
+
+	debugfs_create_bool("reg_shadow_enable", 0600, root,
+			&sde_hw_reg_shadow_enable);
+	debugfs_create_file("reg_shadow", 0400, root, NULL,
+			&sde_hw_reg_shadow_fops);
+}
+#else
+void sde_hw_reg_shadow_debugfs_init(struct dentry *root)
+{
 }
+#endif /* CONFIG_DEBUG_FS */
 
 int sde_reg_read(struct sde_hw_blk_reg_map *c, u32 reg_off)
 {
@@ -347,6 +520,77 @@ static inline scaler_lut_type get_scaler_lut(
 	return lut_ptr;
 }
 
+static void _sde_hw_scaler3_lut_hash_blob(const u32 *lut, size_t len,
+		u32 *lo, u32 *hi)
+{
+	if (!lut || len < sizeof(u32))
+		return;
+
+	*lo = jhash2(lut, len / sizeof(u32), *lo);
+	*hi = jhash2(lut, len / sizeof(u32), *hi);
+}
+
+bool sde_hw_scaler3_lut_cached(struct sde_hw_blk_reg_map *c,
+		struct sde_hw_scaler3_cfg *scaler3_cfg)
+{
+	struct sde_hw_reg_shadow *shadow;
+	u32 sel[6], lo, hi;
+	u64 hash;
+
+	if (!c || !c->shadow || !scaler3_cfg || !scaler3_cfg->lut_flag ||
+			!sde_hw_reg_shadow_enable)
+		return false;
+
+	shadow = c->shadow;
+
+	/* the selected slots and the contents of all referenced blobs */
+	sel[0] = scaler3_cfg->lut_flag;
+	sel[1] = scaler3_cfg->dir_lut_idx;
+	sel[2] = scaler3_cfg->y_rgb_cir_lut_idx;
+	sel[3] = scaler3_cfg->uv_cir_lut_idx;
+	sel[4] = scaler3_cfg->y_rgb_sep_lut_idx;
+	sel[5] = scaler3_cfg->uv_sep_lut_idx;
+	lo = jhash2(sel, ARRAY_SIZE(sel), 0);
+	hi = jhash2(sel, ARRAY_SIZE(sel), JHASH_INITVAL);
+
+	_sde_hw_scaler3_lut_hash_blob(scaler3_cfg->dir_lut,
+			scaler3_cfg->dir_len, &lo, &hi);
+	_sde_hw_scaler3_lut_hash_blob(scaler3_cfg->cir_lut,
+			scaler3_cfg->cir_len, &lo, &hi);
+	_sde_hw_scaler3_lut_hash_blob(scaler3_cfg->sep_lut,
+			scaler3_cfg->sep_len, &lo, &hi);
+
+	/* zero is reserved for unknown contents */
+	hash = ((u64)hi << 32) | lo;
+	if (!hash)
+		hash = 1;
+
+	if (shadow->lut_hash == hash) {
+		shadow->lut_hits++;
+		return true;
+	}
+
+	shadow->lut_hash = hash;
+	shadow->lut_misses++;
+
+	return false;
+}
+
+void sde_hw_scaler3_lut_done(struct sde_hw_blk_reg_map *c, ktime_t start)
+{
+	struct sde_hw_reg_shadow *shadow;
+	u32 time_us;
+
+	if (!c || !c->shadow)
+		return;
+
+	shadow = c->shadow;
+	time_us = (u32)ktime_us_delta(ktime_get(), start);
+	shadow->lut_time_us = time_us;
+	shadow->lut_time_max_us = max(shadow->lut_time_max_us, time_us);
+	SDE_EVT32_VERBOSE(c->blk_off, time_us);
+}
+
 void sde_hw_setup_scaler3(struct sde_hw_blk_reg_map *c,
 		struct sde_hw_scaler3_cfg *scaler3_cfg, u32 scaler_version,
 		u32 scaler_offset, const struct sde_format *format)
@@ -354,6 +598,8 @@ void sde_hw_setup_scaler3(struct sde_hw_blk_reg_map *c,
 	u32 op_mode = 0;
 	u32 phase_init, preload, src_y_rgb, src_uv, dst;
 	scaler_lut_type setup_lut = NULL;
+	u32 lut_flag;
+	ktime_t start;
 
 	if (!scaler3_cfg->enable)
 		goto end;
@@ -391,8 +637,17 @@ void sde_hw_setup_scaler3(struct sde_hw_blk_reg_map *c,
 	}
 
 	setup_lut = get_scaler_lut(scaler3_cfg, scaler_version);
-	if (setup_lut)
+	if (setup_lut) {
+		lut_flag = scaler3_cfg->lut_flag;
+		if (sde_hw_scaler3_lut_cached(c, scaler3_cfg))
+			scaler3_cfg->lut_flag = 0;
+
+		start = ktime_get();
 		setup_lut(c, scaler3_cfg, scaler_offset);
+		if (scaler3_cfg->lut_flag)
+			sde_hw_scaler3_lut_done(c, start);
+		scaler3_cfg->lut_flag = lut_flag;
+	}
 
 	if (scaler_version == 0x1002) {
 		phase_init =
@@ -459,18 +714,18 @@ void sde_hw_csc_matrix_coeff_setup(struct sde_hw_blk_reg_map *c,
 
 	val = ((data->csc_mv[0] >> shift_bit) & 0x1FFF) |
 		(((data->csc_mv[1] >> shift_bit) & 0x1FFF) << 16);
-	SDE_REG_WRITE(c, csc_reg_off, val);
+	SDE_REG_WRITE_CACHED(c, csc_reg_off, val);
 	val = ((data->csc_mv[2] >> shift_bit) & 0x1FFF) |
 		(((data->csc_mv[3] >> shift_bit) & 0x1FFF) << 16);
-	SDE_REG_WRITE(c, csc_reg_off + 0x4, val);
+	SDE_REG_WRITE_CACHED(c, csc_reg_off + 0x4, val);
 	val = ((data->csc_mv[4] >> shift_bit) & 0x1FFF) |
 		(((data->csc_mv[5] >> shift_bit) & 0x1FFF) << 16);
-	SDE_REG_WRITE(c, csc_reg_off + 0x8, val);
+	SDE_REG_WRITE_CACHED(c, csc_reg_off + 0x8, val);
 	val = ((data->csc_mv[6] >> shift_bit) & 0x1FFF) |
 		(((data->csc_mv[7] >> shift_bit) & 0x1FFF) << 16);
-	SDE_REG_WRITE(c, csc_reg_off + 0xc, val);
+	SDE_REG_WRITE_CACHED(c, csc_reg_off + 0xc, val);
 	val = (data->csc_mv[8] >> shift_bit) & 0x1FFF;
-	SDE_REG_WRITE(c, csc_reg_off + 0x10, val);
+	SDE_REG_WRITE_CACHED(c, csc_reg_off + 0x10, val);
 }
 
 void sde_hw_csc_setup(struct sde_hw_blk_reg_map *c,
@@ -488,29 +743,29 @@ void sde_hw_csc_setup(struct sde_hw_blk_reg_map *c,
 
 	/* Pre clamp */
 	val = (data->csc_pre_lv[0] << clamp_shift) | data->csc_pre_lv[1];
-	SDE_REG_WRITE(c, csc_reg_off + 0x14, val);
+	SDE_REG_WRITE_CACHED(c, csc_reg_off + 0x14, val);
 	val = (data->csc_pre_lv[2] << clamp_shift) | data->csc_pre_lv[3];
-	SDE_REG_WRITE(c, csc_reg_off + 0x18, val);
+	SDE_REG_WRITE_CACHED(c, csc_reg_off + 0x18, val);
 	val = (data->csc_pre_lv[4] << clamp_shift) | data->csc_pre_lv[5];
-	SDE_REG_WRITE(c, csc_reg_off + 0x1c, val);
+	SDE_REG_WRITE_CACHED(c, csc_reg_off + 0x1c, val);
 
 	/* Post clamp */
 	val = (data->csc_post_lv[0] << clamp_shift) | data->csc_post_lv[1];
-	SDE_REG_WRITE(c, csc_reg_off + 0x20, val);
+	SDE_REG_WRITE_CACHED(c, csc_reg_off + 0x20, val);
 	val = (data->csc_post_lv[2] << clamp_shift) | data->csc_post_lv[3];
-	SDE_REG_WRITE(c, csc_reg_off + 0x24, val);
+	SDE_REG_WRITE_CACHED(c, csc_reg_off + 0x24, val);
 	val = (data->csc_post_lv[4] << clamp_shift) | data->csc_post_lv[5];
-	SDE_REG_WRITE(c, csc_reg_off + 0x28, val);
+	SDE_REG_WRITE_CACHED(c, csc_reg_off + 0x28, val);
 
 	/* Pre-Bias */
-	SDE_REG_WRITE(c, csc_reg_off + 0x2c, data->csc_pre_bv[0]);
-	SDE_REG_WRITE(c, csc_reg_off + 0x30, data->csc_pre_bv[1]);
-	SDE_REG_WRITE(c, csc_reg_off + 0x34, data->csc_pre_bv[2]);
+	SDE_REG_WRITE_CACHED(c, csc_reg_off + 0x2c, data->csc_pre_bv[0]);
+	SDE_REG_WRITE_CACHED(c, csc_reg_off + 0x30, data->csc_pre_bv[1]);
+	SDE_REG_WRITE_CACHED(c, csc_reg_off + 0x34, data->csc_pre_bv[2]);
 
 	/* Post-Bias */
-	SDE_REG_WRITE(c, csc_reg_off + 0x38, data->csc_post_bv[0]);
-	SDE_REG_WRITE(c, csc_reg_off + 0x3c, data->csc_post_bv[1]);
-	SDE_REG_WRITE(c, csc_reg_off + 0x40, data->csc_post_bv[2]);
+	SDE_REG_WRITE_CACHED(c, csc_reg_off + 0x38, data->csc_post_bv[0]);
+	SDE_REG_WRITE_CACHED(c, csc_reg_off + 0x3c, data->csc_post_bv[1]);
+	SDE_REG_WRITE_CACHED(c, csc_reg_off + 0x40, data->csc_post_bv[2]);
 }
 
 /**
@@ -7,6 +7,7 @@
 #define _SDE_HW_UTIL_H
 
 #include <linux/io.h>
+#include <linux/ktime.h>
 #include <linux/slab.h>
 #include "sde_hw_mdss.h"
 #include "sde_hw_catalog.h"
@@ -18,6 +19,41 @@
 #define LP_DDR4_TYPE			0x7
 
 struct sde_format_extended;
+struct dentry;
+
+/**
+ * struct sde_hw_reg_shadow - last values written to the registers of a block
+ * @list: Node in the list of all register shadows
+ * @addr: Register address of the block, shared by all maps of the block
+ * @name: Name of the block
+ * @refcount: Number of register maps using this shadow
+ * @count: Number of shadowed registers, from the start of the block
+ * @val: Last value written to each register
+ * @valid: Registers whose last written value is known
+ * @hits: Number of cached writes skipped as redundant
+ * @misses: Number of cached writes sent to the hardware
+ * @lut_hash: Content hash of the scaler LUTs the block holds, 0 if unknown
+ * @lut_hits: Number of scaler LUT uploads skipped as identical
+ * @lut_misses: Number of scaler LUT uploads sent to the hardware
+ * @lut_time_us: Time spent programming the last scaler LUT upload
+ * @lut_time_max_us: Longest time spent programming a scaler LUT upload
+ */
+struct sde_hw_reg_shadow {
+	struct list_head list;
+	void __iomem *addr;
+	const char *name;
+	u32 refcount;
+	u32 count;
+	u32 *val;
+	unsigned long *valid;
+	u64 hits;
+	u64 misses;
+	u64 lut_hash;
+	u64 lut_hits;
+	u64 lut_misses;
+	u32 lut_time_us;
+	u32 lut_time_max_us;
+};
 
 /*
  * This is the common struct maintained by each sub block
@@ -28,6 +64,7 @@ struct sde_format_extended;
  * @length        length of register block offset
  * @xin_id        xin id
  * @hwversion     mdss hw version number
+ * @shadow        optional register shadow, see sde_hw_reg_shadow_init
  */
 struct sde_hw_blk_reg_map {
 	void __iomem *base_off;
@@ -36,6 +73,7 @@ struct sde_hw_blk_reg_map {
 	u32 xin_id;
 	u32 hwversion;
 	u32 log_mask;
+	struct sde_hw_reg_shadow *shadow;
 };
 
 /**
@@ -178,9 +216,64 @@ void sde_reg_write(struct sde_hw_blk_reg_map *c,
 		const char *name);
 int sde_reg_read(struct sde_hw_blk_reg_map *c, u32 reg_off);
 
+/**
+ * sde_reg_write_cached - write a register unless it already holds the value
+ *	Only use this for plain configuration registers, writes that trigger
+ *	a hardware action must always go through sde_reg_write. Registers
+ *	programmed by reg dma must not be written through this either, the
+ *	shadow doesn't see those updates.
+ * @c: Pointer to register map of the block
+ * @reg_off: Register offset within the block
+ * @val: Value to write
+ * @name: Register name for logging
+ */
+void sde_reg_write_cached(struct sde_hw_blk_reg_map *c,
+		u32 reg_off,
+		u32 val,
+		const char *name);
+
 #define SDE_REG_WRITE(c, off, val) sde_reg_write(c, off, val, #off)
+#define SDE_REG_WRITE_CACHED(c, off, val) \
+	sde_reg_write_cached(c, off, val, #off)
 #define SDE_REG_READ(c, off) sde_reg_read(c, off)
 
+/**
+ * sde_hw_reg_shadow_init - enable the register shadow of a block
+ *	Register maps of the same block, e.g. the maps of both rectangles of
+ *	a pipe, share a single shadow.
+ * @c: Pointer to register map of the block
+ * @name: Name of the block
+ * @size: Size of the shadowed register range in bytes
+ * Returns: Zero on success
+ */
+int sde_hw_reg_shadow_init(struct sde_hw_blk_reg_map *c, const char *name,
+		u32 size);
+
+/**
+ * sde_hw_reg_shadow_deinit - release the register shadow of a block
+ * @c: Pointer to register map of the block
+ */
+void sde_hw_reg_shadow_deinit(struct sde_hw_blk_reg_map *c);
+
+/**
+ * sde_hw_reg_shadow_invalidate - forget the shadowed values of a block
+ *	Must be called whenever the block registers may have been reset
+ *	behind the driver's back.
+ * @c: Pointer to register map of the block
+ */
+void sde_hw_reg_shadow_invalidate(struct sde_hw_blk_reg_map *c);
+
+/**
+ * sde_hw_reg_shadow_invalidate_all - forget the shadowed values of all blocks
+ */
+void sde_hw_reg_shadow_invalidate_all(void);
+
+/**
+ * sde_hw_reg_shadow_debugfs_init - create the register shadow debugfs nodes
+ * @root: Debugfs directory to create the nodes in
+ */
+void sde_hw_reg_shadow_debugfs_init(struct dentry *root);
+
 #define MISR_FRAME_COUNT_MASK		0xFF
 #define MISR_CTRL_ENABLE		BIT(8)
 #define MISR_CTRL_STATUS		BIT(9)
@@ -195,6 +288,26 @@ void sde_init_scaler_blk(struct sde_scaler_blk *blk, u32 version);
 void sde_set_scaler_v2(struct sde_hw_scaler3_cfg *cfg,
 		const struct sde_drm_scaler_v2 *scale_v2);
 
+/**
+ * sde_hw_scaler3_lut_cached - check whether the scaler LUTs of a block
+ *	already hold the LUTs selected by a scaler configuration, and record
+ *	the new LUT contents otherwise
+ *	The LUTs are double buffered, so an upload is only skipped as a whole,
+ *	swap included. The caller clears lut_flag for skipped uploads.
+ * @c: Pointer to register map of the block
+ * @scaler3_cfg: Pointer to scaler configuration
+ * Returns: true if the LUT upload can be skipped
+ */
+bool sde_hw_scaler3_lut_cached(struct sde_hw_blk_reg_map *c,
+		struct sde_hw_scaler3_cfg *scaler3_cfg);
+
+/**
+ * sde_hw_scaler3_lut_done - account the programming time of a LUT upload
+ * @c: Pointer to register map of the block
+ * @start: Time the upload started
+ */
+void sde_hw_scaler3_lut_done(struct sde_hw_blk_reg_map *c, ktime_t start);
+
 void sde_hw_setup_scaler3(struct sde_hw_blk_reg_map *c,
 		struct sde_hw_scaler3_cfg *scaler3_cfg, u32 scaler_version,
 		u32 scaler_offset, const struct sde_format *format);
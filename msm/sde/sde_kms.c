@@ -132,6 +132,31 @@ void *sde_debugfs_get_root(struct sde_kms *sde_kms)
 	return priv->debug_root;
 }
 
+static int _sde_debugfs_iova_cache_show(struct seq_file *s, void *data)
+{
+	struct sde_kms *sde_kms = s->private;
+	int i;
+
+	for (i = 0; i < MSM_SMMU_DOMAIN_MAX; i++)
+		msm_gem_map_cache_describe(sde_kms->aspace[i], s);
+
+	return 0;
+}
+
+static int _sde_debugfs_iova_cache_open(struct inode *inode,
+		struct file *file)
+{
+	return single_open(file, _sde_debugfs_iova_cache_show,
+			inode->i_private);
+}
+
+static const struct file_operations sde_debugfs_iova_cache_fops = {
+	.open = _sde_debugfs_iova_cache_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
 static int _sde_debugfs_init(struct sde_kms *sde_kms)
 {
 	void *p;
@@ -152,6 +177,11 @@ static int _sde_debugfs_init(struct sde_kms *sde_kms)
 
 	(void) sde_debugfs_vbif_init(sde_kms, debugfs_root);
 	(void) sde_debugfs_core_irq_init(sde_kms, debugfs_root);
+	(void) sde_reg_dma_debugfs_init(debugfs_root);
+	sde_hw_reg_shadow_debugfs_init(debugfs_root);
+	sde_format_debugfs_init(debugfs_root);
+	debugfs_create_file("iova_cache", 0400, debugfs_root, sde_kms,
+			&sde_debugfs_iova_cache_fops);
 
 	rc = sde_core_perf_debugfs_init(&sde_kms->perf, debugfs_root);
 	if (rc) {
@@ -177,6 +207,7 @@ static void sde_kms_debugfs_destroy(struct msm_kms *kms)
 	if (sde_kms) {
 		sde_debugfs_vbif_destroy(sde_kms);
 		sde_debugfs_core_irq_destroy(sde_kms);
+		sde_reg_dma_debugfs_destroy();
 	}
 }
 
@@ -1613,6 +1644,30 @@ static void sde_kms_prepare_fence(struct msm_kms *kms,
 	SDE_ATRACE_END("sde_kms_prepare_fence");
 }
 
+static int sde_kms_prewait_input_fences(struct msm_kms *kms,
+		struct drm_atomic_state *state)
+{
+	struct drm_crtc *crtc;
+	struct drm_crtc_state *new_crtc_state;
+	int i, rc;
+
+	if (!kms || !state) {
+		SDE_ERROR("invalid argument(s)\n");
+		return -EINVAL;
+	}
+
+	for_each_new_crtc_in_state(state, crtc, new_crtc_state, i) {
+		if (!new_crtc_state->active)
+			continue;
+
+		rc = sde_crtc_prewait_input_fences(crtc, new_crtc_state);
+		if (rc)
+			return rc;
+	}
+
+	return 0;
+}
+
 /**
  * _sde_kms_get_displays - query for underlying display handles and cache them
  * @sde_kms:    Pointer to sde kms structure
@@ -3811,6 +3866,9 @@ static void _sde_kms_pm_suspend_idle_helper(struct sde_kms *sde_kms,
 		if (priv->disp_thread[i].thread)
 			kthread_flush_worker(
 				&priv->disp_thread[i].worker);
+		if (priv->retire_thread[i].thread)
+			kthread_flush_worker(
+				&priv->retire_thread[i].worker);
 		if (priv->event_thread[i].thread)
 			kthread_flush_worker(
 				&priv->event_thread[i].worker);
@@ -4051,6 +4109,7 @@ static const struct msm_kms_funcs kms_funcs = {
 	.prepare_commit  = sde_kms_prepare_commit,
 	.commit          = sde_kms_commit,
 	.complete_commit = sde_kms_complete_commit,
+	.prewait_input_fences = sde_kms_prewait_input_fences,
 	.wait_for_crtc_commit_done = sde_kms_wait_for_commit_done,
 	.wait_for_tx_complete = sde_kms_wait_for_frame_transfer_complete,
 	.enable_vblank   = sde_kms_enable_vblank,
@@ -4321,6 +4380,9 @@ static void sde_kms_handle_power_event(u32 event_type, void *usr)
 		sde_irq_update(msm_kms, true);
 		sde_kms->first_kickoff = true;
 
+		/* register contents are lost across power collapse */
+		sde_hw_reg_shadow_invalidate_all();
+
 		/**
 		 * Rotator sid needs to be programmed since uefi doesn't
 		 * configure it during continuous splash
@@ -217,21 +217,66 @@ struct sde_irq_callback {
 	void *arg;
 };
 
+/* number of log2 microsecond buckets in the irq latency histogram */
+#define SDE_IRQ_LATENCY_BUCKETS 8
+
+/**
+ * struct sde_irq_latency - callback latency statistics of an irq_idx
+ * @total_ns: accumulated time spent in the registered callbacks
+ * @max_ns:   longest time spent in the registered callbacks
+ * @buckets:  histogram, bucket n counts latencies below 2^n us and the
+ *            last bucket counts all longer latencies
+ */
+struct sde_irq_latency {
+	u64 total_ns;
+	u32 max_ns;
+	u32 buckets[SDE_IRQ_LATENCY_BUCKETS];
+};
+
+/**
+ * struct sde_irq_fast - fast path handler of an irq_idx, called directly
+ *                       by the dispatcher without walking the callback list
+ * @cb:       installed callback, NULL if none
+ * @name:     name of the handler for debugfs
+ * @count:    number of handled interrupts
+ * @latency:  time from the top level interrupt to the handler return
+ */
+struct sde_irq_fast {
+	struct sde_irq_callback *cb;
+	const char *name;
+	u32 count;
+	struct sde_irq_latency latency;
+};
+
 /**
  * struct sde_irq: IRQ structure contains callback registration info
  * @total_irq:    total number of irq_idx obtained from HW interrupts mapping
- * @irq_cb_tbl:   array of IRQ callbacks setting
+ * @irq_cb_tbl:   array of rcu protected IRQ callback lists
+ * @irq_fast:     array of fast path handlers
  * @enable_counts array of IRQ enable counts
- * @cb_lock:      callback lock
+ * @irq_latency:  array of IRQ callback latency statistics
+ * @irq_ts:       time the top level interrupt being dispatched was taken
+ * @dispatch_cpu: cpu running the dispatcher, -1 when not dispatching
+ * @cb_lock:      serializes updates of the callback lists
  * @debugfs_file: debugfs file for irq statistics
+ * @debugfs_latency_file: debugfs file for irq latency histograms
+ * @debugfs_fast_file: debugfs file for fast path handler latencies
+ * @debugfs_stress_file: debugfs file running the callback list stress test
  */
 struct sde_irq {
 	u32 total_irqs;
 	struct list_head *irq_cb_tbl;
+	struct sde_irq_fast *irq_fast;
 	atomic_t *enable_counts;
 	atomic_t *irq_counts;
+	struct sde_irq_latency *irq_latency;
+	ktime_t irq_ts;
+	int dispatch_cpu;
 	spinlock_t cb_lock;
 	struct dentry *debugfs_file;
+	struct dentry *debugfs_latency_file;
+	struct dentry *debugfs_fast_file;
+	struct dentry *debugfs_stress_file;
 };
 
 /**
@@ -0,0 +1,201 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2021, The Linux Foundation. All rights reserved.
+ */
+
+#ifdef __KERNEL__
+#include <linux/errno.h>
+#include <linux/kernel.h>
+#include <linux/math64.h>
+#define PERF_DIV(a, b)	div64_u64((a), (b))
+#else
+#include <errno.h>
+#include <stddef.h>
+#define PERF_DIV(a, b)	((a) / (b))
+#endif
+
+#include "sde_perf_model.h"
+
+#define PERF_MAX(a, b)	((a) > (b) ? (a) : (b))
+
+static u32 _sde_perf_model_prefill_lines(const struct sde_perf_model_cfg *cfg,
+		const struct sde_perf_model_plane *plane)
+{
+	u32 lines = cfg->xtra_prefill_lines;
+
+	if (plane->tiled)
+		lines += cfg->macrotile_prefill_lines;
+	else if (plane->yuv)
+		lines += cfg->yuv_nv12_prefill_lines;
+	else
+		lines += cfg->linear_prefill_lines;
+
+	if (plane->src_w != plane->dst_w || plane->src_h != plane->dst_h)
+		lines += cfg->dest_scale_prefill_lines;
+
+	if (plane->src_h > plane->dst_h)
+		lines += cfg->downscaling_prefill_lines;
+
+	return PERF_MAX(lines, cfg->min_prefill_lines);
+}
+
+static void _sde_perf_model_calc_pipe(const struct sde_perf_model_cfg *cfg,
+		const struct sde_perf_model_timing *timing,
+		const struct sde_perf_model_plane *plane,
+		struct sde_perf_model_pipe *pipe)
+{
+	u64 line_rate = (u64)timing->vtotal * timing->fps;
+	u32 vblank = timing->vtotal - timing->height;
+	u32 comp = plane->comp_ratio ? plane->comp_ratio : SDE_PERF_MODEL_FP;
+	u64 line_bytes, prefill_ib;
+
+	/* bytes fetched per source line, bpp and comp scale cancel out */
+	line_bytes = PERF_DIV((u64)plane->src_w * plane->bpp, comp);
+
+	pipe->ab = line_bytes * plane->src_h * timing->fps;
+
+	/* source lines are fetched at the rate destination lines go out */
+	pipe->ib = PERF_DIV(line_bytes * plane->src_h * line_rate,
+			plane->dst_h);
+
+	/* prefill lines have to be fetched within the vertical blanking */
+	pipe->prefill_lines = _sde_perf_model_prefill_lines(cfg, plane);
+	prefill_ib = PERF_DIV(line_bytes * pipe->prefill_lines * line_rate,
+			vblank ? vblank : 1);
+	pipe->ib = PERF_MAX(pipe->ib, prefill_ib);
+
+	pipe->clk = (u64)plane->dst_w * line_rate;
+	if (plane->src_h > plane->dst_h)
+		pipe->clk = PERF_DIV(pipe->clk * plane->src_h, plane->dst_h);
+	if (plane->src_w > plane->dst_w)
+		pipe->clk = PERF_DIV(pipe->clk * plane->src_w, plane->dst_w);
+}
+
+int sde_perf_model_calc(const struct sde_perf_model_cfg *cfg,
+		const struct sde_perf_model_timing *timing,
+		const struct sde_perf_model_plane *planes, u32 count,
+		struct sde_perf_model_result *res)
+{
+	u64 ab = 0, max_ib = 0, clk;
+	u32 num_mixers, clk_ff, ib_ff;
+	u32 i;
+
+	if (!cfg || !timing || !res || (count && !planes) ||
+			count > SDE_PERF_MODEL_MAX_PLANES)
+		return -EINVAL;
+
+	if (!timing->width || !timing->height || !timing->fps ||
+			timing->vtotal < timing->height)
+		return -EINVAL;
+
+	for (i = 0; i < count; i++)
+		if (!planes[i].src_w || !planes[i].src_h ||
+				!planes[i].dst_w || !planes[i].dst_h ||
+				!planes[i].bpp)
+			return -EINVAL;
+
+	num_mixers = timing->num_mixers ? timing->num_mixers : 1;
+	clk_ff = cfg->core_clk_ff ? cfg->core_clk_ff : SDE_PERF_MODEL_FP;
+	ib_ff = cfg->core_ib_ff ? cfg->core_ib_ff : SDE_PERF_MODEL_FP;
+
+	/* every mixer outputs its share of the line at the line rate */
+	clk = (u64)(timing->width / num_mixers) * timing->vtotal * timing->fps;
+
+	for (i = 0; i < count; i++) {
+		struct sde_perf_model_pipe *pipe = &res->pipe[i];
+
+		_sde_perf_model_calc_pipe(cfg, timing, &planes[i], pipe);
+
+		ab += pipe->ab;
+		max_ib = PERF_MAX(max_ib, pipe->ib);
+		clk = PERF_MAX(clk, pipe->clk);
+	}
+
+	max_ib = PERF_MAX(max_ib, PERF_DIV(ab * ib_ff, SDE_PERF_MODEL_FP));
+	for (i = 0; i < SDE_PERF_MODEL_BUS_MAX; i++) {
+		res->ab[i] = ab;
+		res->ib[i] = PERF_MAX(max_ib, cfg->min_ib[i]);
+	}
+
+	res->core_clk = PERF_DIV(clk * clk_ff, SDE_PERF_MODEL_FP);
+	res->bw_fits = !cfg->max_bw || ab <= cfg->max_bw;
+	res->clk_fits = !cfg->max_core_clk_rate ||
+			res->core_clk <= cfg->max_core_clk_rate;
+
+	return 0;
+}
+
+static int _sde_perf_model_parse_fp(const char *str, const char *end,
+		u32 *val)
+{
+	u32 whole = 0, frac = 0, scale = SDE_PERF_MODEL_FP;
+	bool digits = false, dot = false;
+
+	for (; str != end && *str; str++) {
+		if (*str == '.' && !dot) {
+			dot = true;
+			continue;
+		}
+
+		if (*str < '0' || *str > '9')
+			return -EINVAL;
+
+		digits = true;
+		if (!dot) {
+			whole = whole * 10 + (*str - '0');
+		} else if (scale > 1) {
+			scale /= 10;
+			frac += (*str - '0') * scale;
+		}
+	}
+
+	if (!digits)
+		return -EINVAL;
+
+	*val = whole * SDE_PERF_MODEL_FP + frac;
+
+	return 0;
+}
+
+int sde_perf_model_parse_fp(const char *str, u32 *val)
+{
+	if (!str || !val)
+		return -EINVAL;
+
+	return _sde_perf_model_parse_fp(str, NULL, val);
+}
+
+int sde_perf_model_parse_comp_ratio(const char *str, u32 fourcc, u32 *ratio)
+{
+	const char *entry, *end, *sep;
+	u32 i;
+
+	if (!str || !ratio)
+		return -ENOENT;
+
+	for (entry = str; *entry; entry = end) {
+		while (*entry == ' ')
+			entry++;
+
+		for (end = entry; *end && *end != ' '; end++)
+			;
+
+		if (end - entry < 5 || entry[4] != '/')
+			continue;
+
+		for (i = 0; i < 4; i++)
+			if (entry[i] != (char)((fourcc >> (i * 8)) & 0xff))
+				break;
+		if (i < 4)
+			continue;
+
+		/* the ratio follows the last separator of the entry */
+		for (sep = end; sep[-1] != '/'; sep--)
+			;
+
+		if (!_sde_perf_model_parse_fp(sep, end, ratio))
+			return 0;
+	}
+
+	return -ENOENT;
+}
@@ -0,0 +1,175 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2021, The Linux Foundation. All rights reserved.
+ */
+
+#ifndef _SDE_PERF_MODEL_H_
+#define _SDE_PERF_MODEL_H_
+
+/*
+ * Bandwidth and clock model of the sde source pipes. The model has no
+ * kernel dependency so the same sources can be built on a host to sweep
+ * plane configurations offline.
+ */
+#ifdef __KERNEL__
+#include <linux/types.h>
+#else
+#include <stdbool.h>
+#include <stdint.h>
+typedef uint32_t u32;
+typedef uint64_t u64;
+#endif
+
+/* fudge factors, bytes per pixel and compression ratios are x1000 */
+#define SDE_PERF_MODEL_FP		1000
+
+#define SDE_PERF_MODEL_MAX_PLANES	16
+
+/**
+ * enum sde_perf_model_bus - data buses voted by the model, in the same
+ *                           order as the power handle data bus ids
+ * @SDE_PERF_MODEL_BUS_MNOC: display to mnoc
+ * @SDE_PERF_MODEL_BUS_LLCC: mnoc to llcc
+ * @SDE_PERF_MODEL_BUS_EBI: llcc to ebi
+ * @SDE_PERF_MODEL_BUS_MAX: number of buses
+ */
+enum sde_perf_model_bus {
+	SDE_PERF_MODEL_BUS_MNOC,
+	SDE_PERF_MODEL_BUS_LLCC,
+	SDE_PERF_MODEL_BUS_EBI,
+	SDE_PERF_MODEL_BUS_MAX,
+};
+
+/**
+ * struct sde_perf_model_cfg - target limits, taken from the catalog perf block
+ * @core_ib_ff: ratio of the ib vote to the ab vote
+ * @core_clk_ff: margin applied to the core clock
+ * @xtra_prefill_lines: prefill lines added to every pipe
+ * @dest_scale_prefill_lines: prefill lines added to scaled pipes
+ * @macrotile_prefill_lines: prefill lines of tiled/ubwc formats
+ * @yuv_nv12_prefill_lines: prefill lines of linear yuv formats
+ * @linear_prefill_lines: prefill lines of linear rgb formats
+ * @downscaling_prefill_lines: prefill lines added to downscaled pipes
+ * @min_prefill_lines: lower bound of the prefill lines of a pipe
+ * @max_bw: bandwidth limit in bytes per second
+ * @min_ib: lowest ib vote of each bus in bytes per second
+ * @max_core_clk_rate: highest core clock rate in Hz
+ */
+struct sde_perf_model_cfg {
+	u32 core_ib_ff;
+	u32 core_clk_ff;
+	u32 xtra_prefill_lines;
+	u32 dest_scale_prefill_lines;
+	u32 macrotile_prefill_lines;
+	u32 yuv_nv12_prefill_lines;
+	u32 linear_prefill_lines;
+	u32 downscaling_prefill_lines;
+	u32 min_prefill_lines;
+	u64 max_bw;
+	u64 min_ib[SDE_PERF_MODEL_BUS_MAX];
+	u64 max_core_clk_rate;
+};
+
+/**
+ * struct sde_perf_model_timing - display timing the planes are blended into
+ * @width: active width
+ * @height: active height
+ * @vtotal: total lines per frame, blanking included
+ * @fps: frame rate
+ * @num_mixers: layer mixers the width is split across
+ */
+struct sde_perf_model_timing {
+	u32 width;
+	u32 height;
+	u32 vtotal;
+	u32 fps;
+	u32 num_mixers;
+};
+
+/**
+ * struct sde_perf_model_plane - plane fetched by a source pipe
+ * @src_w: source width
+ * @src_h: source height
+ * @dst_w: destination width
+ * @dst_h: destination height
+ * @bpp: average bytes fetched per pixel
+ * @comp_ratio: ubwc compression ratio, SDE_PERF_MODEL_FP when uncompressed
+ * @yuv: format is yuv
+ * @tiled: format is tiled or ubwc
+ */
+struct sde_perf_model_plane {
+	u32 src_w;
+	u32 src_h;
+	u32 dst_w;
+	u32 dst_h;
+	u32 bpp;
+	u32 comp_ratio;
+	bool yuv;
+	bool tiled;
+};
+
+/**
+ * struct sde_perf_model_pipe - requirements of a single pipe
+ * @ab: average bandwidth in bytes per second
+ * @ib: instantaneous bandwidth in bytes per second, prefill included
+ * @clk: pixel clock the pipe needs in Hz
+ * @prefill_lines: lines fetched before the first active line
+ */
+struct sde_perf_model_pipe {
+	u64 ab;
+	u64 ib;
+	u64 clk;
+	u32 prefill_lines;
+};
+
+/**
+ * struct sde_perf_model_result - requirements of a plane configuration
+ * @pipe: requirements of each plane
+ * @ab: ab vote of each bus in bytes per second
+ * @ib: ib vote of each bus in bytes per second
+ * @core_clk: core clock rate in Hz
+ * @bw_fits: @ab is within the bandwidth limit
+ * @clk_fits: @core_clk is within the clock limit
+ */
+struct sde_perf_model_result {
+	struct sde_perf_model_pipe pipe[SDE_PERF_MODEL_MAX_PLANES];
+	u64 ab[SDE_PERF_MODEL_BUS_MAX];
+	u64 ib[SDE_PERF_MODEL_BUS_MAX];
+	u64 core_clk;
+	bool bw_fits;
+	bool clk_fits;
+};
+
+/**
+ * sde_perf_model_calc - compute the requirements of a plane configuration
+ * @cfg: target limits
+ * @timing: display timing
+ * @planes: planes blended into the display
+ * @count: number of planes, at most SDE_PERF_MODEL_MAX_PLANES
+ * @res: computed requirements
+ * return: zero if success, or -EINVAL on invalid input
+ */
+int sde_perf_model_calc(const struct sde_perf_model_cfg *cfg,
+		const struct sde_perf_model_timing *timing,
+		const struct sde_perf_model_plane *planes, u32 count,
+		struct sde_perf_model_result *res);
+
+/**
+ * sde_perf_model_parse_fp - parse a decimal string such as "1.23"
+ * @str: string to parse
+ * @val: parsed value, x SDE_PERF_MODEL_FP
+ * return: zero if success, or -EINVAL on malformed input
+ */
+int sde_perf_model_parse_fp(const char *str, u32 *val);
+
+/**
+ * sde_perf_model_parse_comp_ratio - look up the ubwc compression ratio of a
+ *                                   format in a catalog comp ratio string
+ * @str: space separated "FOURCC/version/mode/ratio" entries
+ * @fourcc: drm fourcc of the format
+ * @ratio: compression ratio, x SDE_PERF_MODEL_FP
+ * return: zero if found, or -ENOENT
+ */
+int sde_perf_model_parse_comp_ratio(const char *str, u32 fourcc, u32 *ratio);
+
+#endif /* _SDE_PERF_MODEL_H_ */
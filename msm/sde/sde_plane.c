@@ -95,6 +95,10 @@ enum sde_plane_qos {
  * @revalidate: force revalidation of all the plane properties
  * @xin_halt_forced_clk: whether or not clocks were forced on for xin halt
  * @blob_rot_caps: Pointer to rotator capability blob
+ * @dirty_props: Number of dirty properties of the last update
+ * @dirty_props_total: Number of dirty properties of all updates
+ * @update_count: Number of sspp updates
+ * @full_update_count: Number of sspp updates reprogramming everything
  */
 struct sde_plane {
 	struct drm_plane base;
@@ -137,6 +141,11 @@ struct sde_plane {
 	struct drm_property_blob *blob_info;
 	struct drm_property_blob *blob_rot_caps;
 
+	u32 dirty_props;
+	u64 dirty_props_total;
+	u64 update_count;
+	u64 full_update_count;
+
 	/* debugfs related stuff */
 	struct dentry *debugfs_root;
 	bool debugfs_default_scale;
@@ -3242,8 +3251,8 @@ static int sde_plane_sspp_atomic_update(struct drm_plane *plane,
 	struct sde_plane_state *old_pstate;
 	struct drm_crtc *crtc;
 	struct drm_framebuffer *fb;
-	int idx;
-	int dirty_prop_flag;
+	DECLARE_BITMAP(dirty_props, MSM_PROP_MAX_COUNT);
+	int idx, count;
 	bool is_rt;
 
 	if (!plane) {
@@ -3299,13 +3308,17 @@ static int sde_plane_sspp_atomic_update(struct drm_plane *plane,
 	}
 
 	/* determine what needs to be refreshed */
-	mutex_lock(&psde->property_info.property_lock);
-	while ((idx = msm_property_pop_dirty(&psde->property_info,
-				&pstate->property_state)) >= 0) {
-		dirty_prop_flag = plane_prop_array[idx];
-		pstate->dirty |= dirty_prop_flag;
-	}
-	mutex_unlock(&psde->property_info.property_lock);
+	count = msm_property_pop_all_dirty(&psde->property_info,
+			&pstate->property_state, dirty_props);
+	if (count > 0)
+		for_each_set_bit(idx, dirty_props, PLANE_PROP_COUNT)
+			pstate->dirty |= plane_prop_array[idx];
+
+	psde->dirty_props = max(count, 0);
+	psde->dirty_props_total += psde->dirty_props;
+	psde->update_count++;
+	if ((pstate->dirty & SDE_PLANE_DIRTY_ALL) == SDE_PLANE_DIRTY_ALL)
+		psde->full_update_count++;
 
 	/**
 	 * since plane_atomic_check is invoked before crtc_atomic_check
@@ -4562,6 +4575,23 @@ static int _sde_plane_init_debugfs(struct drm_plane *plane)
 			psde->debugfs_root,
 			kms, &sde_plane_danger_enable);
 
+	debugfs_create_u32("dirty_props",
+			0400,
+			psde->debugfs_root,
+			&psde->dirty_props);
+	debugfs_create_u64("dirty_props_total",
+			0400,
+			psde->debugfs_root,
+			&psde->dirty_props_total);
+	debugfs_create_u64("update_count",
+			0400,
+			psde->debugfs_root,
+			&psde->update_count);
+	debugfs_create_u64("full_update_count",
+			0400,
+			psde->debugfs_root,
+			&psde->full_update_count);
+
 	return 0;
 }
 
@@ -4,6 +4,8 @@
  */
 
 #define pr_fmt(fmt)	"[drm:%s:%d] " fmt, __func__, __LINE__
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
 #include "sde_reg_dma.h"
 #include "sde_hw_reg_dma_v1.h"
 #include "sde_dbg.h"
@@ -78,6 +80,11 @@ static void default_dump_reg(void)
 {
 }
 
+static int default_kick_off_pending(struct sde_hw_ctl *ctl)
+{
+	return 0;
+}
+
 static void set_default_dma_ops(struct sde_hw_reg_dma *reg_dma)
 {
 	const static struct sde_hw_reg_dma_ops ops = {
@@ -85,7 +92,7 @@ static void set_default_dma_ops(struct sde_hw_reg_dma *reg_dma)
 		default_kick_off, default_reset, default_alloc_reg_dma_buf,
 		default_dealloc_reg_dma, default_buf_reset_reg_dma,
 		default_last_command, default_last_command_sb,
-		default_dump_reg};
+		default_dump_reg, default_kick_off_pending};
 	memcpy(&reg_dma->ops, &ops, sizeof(ops));
 }
 
@@ -110,6 +117,7 @@ int sde_reg_dma_init(void __iomem *addr, struct sde_mdss_cfg *m,
 	reg_dma.drm_dev = dev;
 	reg_dma.addr = addr;
 	reg_dma.caps = &m->dma_cfg;
+	atomic_set(&reg_dma.shadow_gen, 1);
 
 	switch (reg_dma.caps->version) {
 	case REG_DMA_VER_1_0:
@@ -162,3 +170,155 @@ void sde_reg_dma_deinit(void)
 	memset(&reg_dma, 0, sizeof(reg_dma));
 	set_default_dma_ops(&reg_dma);
 }
+
+u32 sde_reg_dma_get_shadow_gen(void)
+{
+	return reg_dma.lut_delta_disable ? 0 : atomic_read(&reg_dma.shadow_gen);
+}
+
+void sde_reg_dma_invalidate_shadow(void)
+{
+	/*
+	 * Reset paths of any ctl can race with the commits of the others,
+	 * generation 0 is reserved for "no valid shadow".
+	 */
+	while (!atomic_inc_return(&reg_dma.shadow_gen))
+		;
+}
+
+void sde_reg_dma_update_lut_delta_stats(enum sde_reg_dma_features feature,
+		bool full, u32 runs, u32 full_bytes, u32 bytes)
+{
+	struct sde_reg_dma_lut_delta_stats *stats;
+
+	if (feature >= REG_DMA_FEATURES_MAX)
+		return;
+
+	stats = &reg_dma.lut_delta_stats[feature];
+	if (full)
+		stats->full_writes++;
+	else if (!runs)
+		stats->unchanged++;
+	else
+		stats->delta_writes++;
+	stats->runs += runs;
+	stats->full_bytes += full_bytes;
+	stats->bytes += bytes;
+}
+
+#ifdef CONFIG_DEBUG_FS
+static struct dentry *reg_dma_debugfs_root;
+
+#define DEFINE_SDE_DEBUGFS_SEQ_FOPS(__prefix)				\
+static int __prefix ## _open(struct inode *inode, struct file *file)	\
+{									\
+	return single_open(file, __prefix ## _show, inode->i_private);	\
+}									\
+static const struct file_operations __prefix ## _fops = {		\
+	.owner = THIS_MODULE,						\
+	.open = __prefix ## _open,					\
+	.release = single_release,					\
+	.read = seq_read,						\
+	.llseek = seq_lseek,						\
+}
+
+static int sde_reg_dma_coalesce_stats_show(struct seq_file *s, void *v)
+{
+	struct sde_reg_dma_coalesce_stats *stats;
+	int i;
+
+	seq_printf(s, "%-4s %10s %12s %12s %9s %13s %10s %9s\n", "ctl",
+			"frames", "kickoffs", "coalesced", "overflows",
+			"last_kickoffs", "last_bytes", "max_bytes");
+
+	for (i = 0; i < CTL_MAX - CTL_0; i++) {
+		stats = &reg_dma.coalesce_stats[i];
+		if (!stats->frames)
+			continue;
+
+		seq_printf(s, "%-4d %10u %12llu %12llu %9u %13u %10u %9u\n",
+				i, stats->frames, stats->kickoffs,
+				stats->coalesced, stats->overflows,
+				stats->last_kickoffs, stats->last_bytes,
+				stats->max_bytes);
+	}
+
+	return 0;
+}
+DEFINE_SDE_DEBUGFS_SEQ_FOPS(sde_reg_dma_coalesce_stats);
+
+static int sde_reg_dma_lut_delta_stats_show(struct seq_file *s, void *v)
+{
+	struct sde_reg_dma_lut_delta_stats *stats;
+	int i;
+
+	seq_printf(s, "%-7s %11s %12s %9s %10s %12s %12s %12s\n",
+			"feature", "full_writes", "delta_writes", "unchanged",
+			"runs", "full_bytes", "bytes", "bytes_saved");
+
+	for (i = 0; i < REG_DMA_FEATURES_MAX; i++) {
+		stats = &reg_dma.lut_delta_stats[i];
+		if (!stats->full_bytes)
+			continue;
+
+		seq_printf(s, "%-7d %11llu %12llu %9llu %10llu %12llu %12llu %12llu\n",
+				i, stats->full_writes, stats->delta_writes,
+				stats->unchanged, stats->runs,
+				stats->full_bytes, stats->bytes,
+				stats->full_bytes - stats->bytes);
+	}
+
+	return 0;
+}
+DEFINE_SDE_DEBUGFS_SEQ_FOPS(sde_reg_dma_lut_delta_stats);
+
+static int sde_reg_dma_arena_stats_show(struct seq_file *s, void *v)
+{
+	struct sde_reg_dma_arena_stats *stats = &reg_dma.arena_stats;
+
+	seq_printf(s, "chunks: %u\n", stats->chunks);
+	seq_printf(s, "buffers: %u\n", stats->buffers);
+	seq_printf(s, "used_bytes: %u\n", stats->used_bytes);
+	seq_printf(s, "peak_bytes: %u\n", stats->peak_bytes);
+
+	return 0;
+}
+DEFINE_SDE_DEBUGFS_SEQ_FOPS(sde_reg_dma_arena_stats);
+
+int sde_reg_dma_debugfs_init(struct dentry *debugfs_root)
+{
+	reg_dma_debugfs_root = debugfs_create_dir("reg_dma", debugfs_root);
+	if (IS_ERR_OR_NULL(reg_dma_debugfs_root)) {
+		reg_dma_debugfs_root = NULL;
+		return -EINVAL;
+	}
+
+	debugfs_create_u32("coalesce_disable", 0600, reg_dma_debugfs_root,
+			&reg_dma.coalesce_disable);
+	debugfs_create_file("coalesce_stats", 0400, reg_dma_debugfs_root,
+			NULL, &sde_reg_dma_coalesce_stats_fops);
+	debugfs_create_u32("lut_delta_disable", 0600, reg_dma_debugfs_root,
+			&reg_dma.lut_delta_disable);
+	debugfs_create_file("lut_delta_stats", 0400, reg_dma_debugfs_root,
+			NULL, &sde_reg_dma_lut_delta_stats_fops);
+	debugfs_create_file("arena_stats", 0400, reg_dma_debugfs_root,
+			NULL, &sde_reg_dma_arena_stats_fops);
+
+	return 0;
+}
+
+void sde_reg_dma_debugfs_destroy(void)
+{
+	debugfs_remove_recursive(reg_dma_debugfs_root);
+	reg_dma_debugfs_root = NULL;
+}
+#else
+int sde_reg_dma_debugfs_init(struct dentry *debugfs_root)
+{
+	return 0;
+}
+
+void sde_reg_dma_debugfs_destroy(void)
+{
+}
+#endif /* CONFIG_DEBUG_FS */
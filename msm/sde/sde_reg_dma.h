@@ -12,6 +12,8 @@
 #include "sde_hw_top.h"
 #include "sde_hw_util.h"
 
+struct sde_reg_dma_arena_chunk;
+
 /**
  * enum sde_reg_dma_op - defines operations supported by reg dma
  * @REG_DMA_READ: Read the histogram into buffer provided
@@ -232,6 +234,9 @@ enum sde_reg_dma_last_cmd_mode {
  * @vaddr: cpu address
  * @next_op_allowed: operation allowed on the buffer
  * @ops_completed: operations completed on buffer
+ * @chunk: arena chunk the buffer is carved out of, @buf is the chunk's
+ * @offset: offset of the buffer in its chunk
+ * @node: entry in the chunk buffer list
  */
 struct sde_reg_dma_buffer {
 	struct drm_gem_object *buf;
@@ -242,6 +247,9 @@ struct sde_reg_dma_buffer {
 	void *vaddr;
 	u32 next_op_allowed;
 	u32 ops_completed;
+	struct sde_reg_dma_arena_chunk *chunk;
+	u32 offset;
+	struct list_head node;
 };
 
 /**
@@ -324,6 +332,8 @@ struct sde_reg_dma_kickoff_cfg {
  * @last_command: notify control that last command is queued
  * @last_command_sb: notify control that last command for SB LUTDMA is queued
  * @dump_regs: dump reg dma registers
+ * @kick_off_pending: submit the DB queue0 writes coalesced on a ctl that does
+ *                    not receive its own last command
  */
 struct sde_hw_reg_dma_ops {
 	int (*check_support)(enum sde_reg_dma_features feature,
@@ -340,6 +350,59 @@ struct sde_hw_reg_dma_ops {
 	int (*last_command_sb)(struct sde_hw_ctl *ctl, enum sde_reg_dma_queue q,
 			enum sde_reg_dma_last_cmd_mode mode);
 	void (*dump_regs)(void);
+	int (*kick_off_pending)(struct sde_hw_ctl *ctl);
+};
+
+/**
+ * struct sde_reg_dma_coalesce_stats - per ctl accounting of queue submissions
+ * @frames: number of flushes issued on the ctl
+ * @kickoffs: total queue submissions, last command included
+ * @coalesced: feature buffers merged into the coalesced buffer
+ * @overflows: frames where the coalesced buffer ran out of space
+ * @last_kickoffs: queue submissions of the last flushed frame
+ * @last_bytes: coalesced payload bytes of the last flushed frame
+ * @max_bytes: largest coalesced payload seen in a frame
+ */
+struct sde_reg_dma_coalesce_stats {
+	u32 frames;
+	u64 kickoffs;
+	u64 coalesced;
+	u32 overflows;
+	u32 last_kickoffs;
+	u32 last_bytes;
+	u32 max_bytes;
+};
+
+/**
+ * struct sde_reg_dma_lut_delta_stats - per feature accounting of LUT updates
+ * @full_writes: LUT updates programmed in full
+ * @delta_writes: LUT updates programmed as changed runs only
+ * @unchanged: LUT updates where no entry changed
+ * @runs: changed runs emitted by delta writes
+ * @full_bytes: payload bytes a full write of every update would have taken
+ * @bytes: payload bytes actually emitted
+ */
+struct sde_reg_dma_lut_delta_stats {
+	u64 full_writes;
+	u64 delta_writes;
+	u64 unchanged;
+	u64 runs;
+	u64 full_bytes;
+	u64 bytes;
+};
+
+/**
+ * struct sde_reg_dma_arena_stats - reg dma buffer arena occupancy
+ * @chunks: pinned chunks currently mapped
+ * @buffers: buffers carved out of the chunks
+ * @used_bytes: bytes handed out, rounded up to the buffer alignment
+ * @peak_bytes: highest @used_bytes seen
+ */
+struct sde_reg_dma_arena_stats {
+	u32 chunks;
+	u32 buffers;
+	u32 used_bytes;
+	u32 peak_bytes;
 };
 
 /**
@@ -349,6 +412,12 @@ struct sde_hw_reg_dma_ops {
  * @caps: LUTDMA hw caps on the platform
  * @ops: reg dma ops supported on the platform
  * @addr: reg dma hw block base address
+ * @coalesce_disable: submit feature buffers individually when set
+ * @coalesce_stats: queue submission accounting for each ctl
+ * @lut_delta_disable: always program LUTs in full when set
+ * @shadow_gen: generation of the LUT shadow copies, bumped on hw state loss
+ * @lut_delta_stats: LUT delta programming accounting for each feature
+ * @arena_stats: occupancy of the buffer arena
  */
 struct sde_hw_reg_dma {
 	struct drm_device *drm_dev;
@@ -356,6 +425,12 @@ struct sde_hw_reg_dma {
 	const struct sde_reg_dma_cfg *caps;
 	struct sde_hw_reg_dma_ops ops;
 	void __iomem *addr;
+	u32 coalesce_disable;
+	struct sde_reg_dma_coalesce_stats coalesce_stats[CTL_MAX];
+	u32 lut_delta_disable;
+	atomic_t shadow_gen;
+	struct sde_reg_dma_lut_delta_stats lut_delta_stats[REG_DMA_FEATURES_MAX];
+	struct sde_reg_dma_arena_stats arena_stats;
 };
 
 /**
@@ -383,4 +458,40 @@ struct sde_hw_reg_dma_ops *sde_reg_dma_get_ops(void);
  * sde_reg_dma_deinit() - de-initialize the reg dma
  */
 void sde_reg_dma_deinit(void);
+
+/**
+ * sde_reg_dma_get_shadow_gen() - current generation of the LUT shadow copies.
+ *                                A shadow recorded in another generation no
+ *                                longer matches the hw. Returns 0 when LUT
+ *                                delta programming is disabled.
+ */
+u32 sde_reg_dma_get_shadow_gen(void);
+
+/**
+ * sde_reg_dma_invalidate_shadow() - drop all LUT shadow copies, called when
+ *                                   the programmed hw state may be lost
+ */
+void sde_reg_dma_invalidate_shadow(void);
+
+/**
+ * sde_reg_dma_update_lut_delta_stats() - account a LUT update
+ * @feature: feature the LUT belongs to
+ * @full: LUT was programmed in full
+ * @runs: changed runs emitted by a delta write
+ * @full_bytes: payload bytes of a full write
+ * @bytes: payload bytes emitted
+ */
+void sde_reg_dma_update_lut_delta_stats(enum sde_reg_dma_features feature,
+		bool full, u32 runs, u32 full_bytes, u32 bytes);
+
+/**
+ * sde_reg_dma_debugfs_init() - create the reg dma debugfs entries
+ * @debugfs_root: parent debugfs directory
+ */
+int sde_reg_dma_debugfs_init(struct dentry *debugfs_root);
+
+/**
+ * sde_reg_dma_debugfs_destroy() - remove the reg dma debugfs entries
+ */
+void sde_reg_dma_debugfs_destroy(void);
 #endif /* _SDE_REG_DMA_H */
@@ -38,6 +38,9 @@
 /* ~one vsync poll time for rsvp_nxt to cleared by modeset from commit thread */
 #define RM_NXT_CLEAR_POLL_TIMEOUT_US 16600
 
+/* upper bound of hw blocks a single reservation can hold */
+#define RM_CACHE_MAX_BLKS	32
+
 /**
  * toplogy information to be used when ctl path version does not
  * support driving more than one interface per ctl_path
@@ -146,6 +149,7 @@ struct sde_rm_rsvp {
  *		request. Will be swapped into rsvp if proposal is accepted
  * @type:	Type of hardware block this structure tracks
  * @id:		Hardware ID number, within it's own space, ie. LM_X
+ * @idx:	Index of this block in the resource manager array of its type
  * @catalog:	Pointer to the hardware catalog entry for this block
  * @hw:		Pointer to the hardware register access object for this block
  */
@@ -155,9 +159,52 @@ struct sde_rm_hw_blk {
 	struct sde_rm_rsvp *rsvp_nxt;
 	enum sde_hw_blk_type type;
 	uint32_t id;
+	uint32_t idx;
 	struct sde_hw_blk *hw;
 };
 
+/**
+ * struct sde_rm_cache_key - requirements a reservation solution depends on
+ * @top_name:	Selected topology
+ * @top_ctrl:	Topology control bits, reserve lock and clear excluded
+ * @intfs:	Interfaces requested by the encoder
+ * @wbs:	Writebacks requested by the encoder
+ * @needs_cdm:	Encoder requested a CDM
+ * @display_type: Primary/secondary type the mixer preference depends on
+ * @comp_type:	Compression type
+ * @native_yuv:	DSC runs in native 422/420 mode
+ * @cwb_requested_disp_type: Display type the CWB mixers are taken from
+ * @conn_lm_mask: Mixers of the display the CWB mixers are taken from
+ */
+struct sde_rm_cache_key {
+	enum sde_rm_topology_name top_name;
+	uint64_t top_ctrl;
+	enum sde_intf_mode intfs[INTF_MAX];
+	enum sde_intf_mode wbs[WB_MAX];
+	bool needs_cdm;
+	enum sde_connector_display display_type;
+	enum msm_display_compression_type comp_type;
+	bool native_yuv;
+	u32 cwb_requested_disp_type;
+	u32 conn_lm_mask;
+};
+
+/**
+ * struct sde_rm_cache - last reservation solution found for an encoder
+ * @list:	List head for list of all cached solutions
+ * @enc_id:	Encoder DRM object ID the solution was found for
+ * @key:	Requirements the solution was found for
+ * @num_blks:	Number of valid entries in @blks
+ * @blks:	Hardware blocks making up the solution
+ */
+struct sde_rm_cache {
+	struct list_head list;
+	uint32_t enc_id;
+	struct sde_rm_cache_key key;
+	u32 num_blks;
+	struct sde_rm_hw_blk *blks[RM_CACHE_MAX_BLKS];
+};
+
 /**
  * sde_rm_dbg_rsvp_stage - enum of steps in making reservation for event logging
  */
@@ -168,6 +215,62 @@ enum sde_rm_dbg_rsvp_stage {
 	SDE_RM_STAGE_FINAL
 };
 
+static void _sde_rm_blk_set_rsvp(struct sde_rm *rm,
+		struct sde_rm_hw_blk *blk, struct sde_rm_rsvp *rsvp)
+{
+	blk->rsvp = rsvp;
+	if (rsvp)
+		__set_bit(blk->idx, &rm->rsvp_mask[blk->type]);
+	else
+		__clear_bit(blk->idx, &rm->rsvp_mask[blk->type]);
+}
+
+static void _sde_rm_blk_set_rsvp_nxt(struct sde_rm *rm,
+		struct sde_rm_hw_blk *blk, struct sde_rm_rsvp *rsvp)
+{
+	blk->rsvp_nxt = rsvp;
+	if (rsvp)
+		__set_bit(blk->idx, &rm->rsvp_nxt_mask[blk->type]);
+	else
+		__clear_bit(blk->idx, &rm->rsvp_nxt_mask[blk->type]);
+}
+
+static int _sde_rm_blk_index(struct sde_rm *rm, struct sde_rm_hw_blk *blk)
+{
+	enum sde_hw_blk_type type = blk->type;
+
+	if (rm->num_blks[type] >= SDE_RM_MAX_TYPE_BLKS ||
+			blk->id >= SDE_RM_MAX_TYPE_BLKS ||
+			rm->blk_by_id[type][blk->id]) {
+		SDE_ERROR("cannot index blk type %d id %d, count %d\n",
+				type, blk->id, rm->num_blks[type]);
+		return -E2BIG;
+	}
+
+	blk->idx = rm->num_blks[type]++;
+	rm->blks[type][blk->idx] = blk;
+	rm->blk_by_id[type][blk->id] = blk;
+	_sde_rm_blk_set_rsvp(rm, blk, blk->rsvp);
+	_sde_rm_blk_set_rsvp_nxt(rm, blk, blk->rsvp_nxt);
+
+	return 0;
+}
+
+static void _sde_rm_blk_reindex(struct sde_rm *rm,
+		enum sde_hw_blk_type type)
+{
+	struct sde_rm_hw_blk *blk;
+
+	rm->num_blks[type] = 0;
+	rm->rsvp_mask[type] = 0;
+	rm->rsvp_nxt_mask[type] = 0;
+	memset(rm->blks[type], 0, sizeof(rm->blks[type]));
+	memset(rm->blk_by_id[type], 0, sizeof(rm->blk_by_id[type]));
+
+	list_for_each_entry(blk, &rm->hw_blks[type], list)
+		_sde_rm_blk_index(rm, blk);
+}
+
 static void _sde_rm_inc_resource_info_lm(struct sde_rm *rm,
 	struct msm_resource_caps_info *avail_res,
 	struct sde_rm_hw_blk *blk)
@@ -252,6 +355,7 @@ void sde_rm_get_resource_info(struct sde_rm *rm,
 	struct sde_rm_hw_blk *blk;
 	enum sde_hw_blk_type type;
 	struct sde_rm_rsvp rsvp;
+	unsigned long idx;
 
 	memcpy(avail_res, &rm->avail_res,
 			sizeof(rm->avail_res));
@@ -261,10 +365,14 @@ void sde_rm_get_resource_info(struct sde_rm *rm,
 
 	rsvp.enc_id = drm_enc->base.id;
 
-	for (type = 0; type < SDE_HW_BLK_MAX; type++)
-		list_for_each_entry(blk, &rm->hw_blks[type], list)
-			if (blk->rsvp && blk->rsvp->enc_id == rsvp.enc_id)
+	for (type = 0; type < SDE_HW_BLK_MAX; type++) {
+		for_each_set_bit(idx, &rm->rsvp_mask[type],
+				SDE_RM_MAX_TYPE_BLKS) {
+			blk = rm->blks[type][idx];
+			if (blk->rsvp->enc_id == rsvp.enc_id)
 				_sde_rm_inc_resource_info(rm, avail_res, blk);
+		}
+	}
 }
 
 static void _sde_rm_print_rsvps(
@@ -274,6 +382,7 @@ static void _sde_rm_print_rsvps(
 	struct sde_rm_rsvp *rsvp;
 	struct sde_rm_hw_blk *blk;
 	enum sde_hw_blk_type type;
+	unsigned long mask, idx;
 
 	SDE_DEBUG("%d\n", stage);
 
@@ -284,9 +393,9 @@ static void _sde_rm_print_rsvps(
 	}
 
 	for (type = 0; type < SDE_HW_BLK_MAX; type++) {
-		list_for_each_entry(blk, &rm->hw_blks[type], list) {
-			if (!blk->rsvp && !blk->rsvp_nxt)
-				continue;
+		mask = rm->rsvp_mask[type] | rm->rsvp_nxt_mask[type];
+		for_each_set_bit(idx, &mask, SDE_RM_MAX_TYPE_BLKS) {
+			blk = rm->blks[type][idx];
 
 			SDE_DEBUG("%d rsvp[s%ue%u->s%ue%u] %d %d\n", stage,
 				(blk->rsvp) ? blk->rsvp->seq : 0,
@@ -310,10 +419,11 @@ static void _sde_rm_print_rsvps_by_type(
 		enum sde_hw_blk_type type)
 {
 	struct sde_rm_hw_blk *blk;
+	unsigned long mask, idx;
 
-	list_for_each_entry(blk, &rm->hw_blks[type], list) {
-		if (!blk->rsvp && !blk->rsvp_nxt)
-			continue;
+	mask = rm->rsvp_mask[type] | rm->rsvp_nxt_mask[type];
+	for_each_set_bit(idx, &mask, SDE_RM_MAX_TYPE_BLKS) {
+		blk = rm->blks[type][idx];
 
 		SDE_ERROR("rsvp[s%ue%u->s%ue%u] %d %d\n",
 			(blk->rsvp) ? blk->rsvp->seq : 0,
@@ -360,7 +470,8 @@ enum sde_rm_topology_name sde_rm_get_topology_name(struct sde_rm *rm,
 
 static bool _sde_rm_get_hw_locked(struct sde_rm *rm, struct sde_rm_hw_iter *i)
 {
-	struct list_head *blk_list;
+	u32 num_blks;
+	unsigned long idx;
 
 	if (!rm || !i || i->type >= SDE_HW_BLK_MAX) {
 		SDE_ERROR("invalid rm\n");
@@ -368,41 +479,39 @@ static bool _sde_rm_get_hw_locked(struct sde_rm *rm, struct sde_rm_hw_iter *i)
 	}
 
 	i->hw = NULL;
-	blk_list = &rm->hw_blks[i->type];
+	num_blks = rm->num_blks[i->type];
+	idx = i->blk ? i->blk->idx + 1 : 0;
 
-	if (i->blk && (&i->blk->list == blk_list)) {
-		SDE_DEBUG("attempt resume iteration past last\n");
+	if (idx >= num_blks) {
+		SDE_DEBUG("no match, type %d for enc %d\n", i->type, i->enc_id);
 		return false;
 	}
 
-	i->blk = list_prepare_entry(i->blk, blk_list, list);
-
-	list_for_each_entry_continue(i->blk, blk_list, list) {
-		struct sde_rm_rsvp *rsvp = i->blk->rsvp;
-
-		if (i->blk->type != i->type) {
-			SDE_ERROR("found incorrect block type %d on %d list\n",
-					i->blk->type, i->type);
-			return false;
-		}
+	/* only blocks with a current reservation can match an encoder */
+	if (i->enc_id) {
+		for_each_set_bit_from(idx, &rm->rsvp_mask[i->type], num_blks)
+			if (rm->blks[i->type][idx]->rsvp->enc_id == i->enc_id)
+				break;
+	}
 
-		if ((i->enc_id == 0) || (rsvp && rsvp->enc_id == i->enc_id)) {
-			i->hw = i->blk->hw;
-			SDE_DEBUG("found type %d id %d for enc %d\n",
-					i->type, i->blk->id, i->enc_id);
-			return true;
-		}
+	if (idx >= num_blks) {
+		/* park on the last block so a resumed iteration ends too */
+		i->blk = rm->blks[i->type][num_blks - 1];
+		SDE_DEBUG("no match, type %d for enc %d\n", i->type, i->enc_id);
+		return false;
 	}
 
-	SDE_DEBUG("no match, type %d for enc %d\n", i->type, i->enc_id);
+	i->blk = rm->blks[i->type][idx];
+	i->hw = i->blk->hw;
+	SDE_DEBUG("found type %d id %d for enc %d\n",
+			i->type, i->blk->id, i->enc_id);
 
-	return false;
+	return true;
 }
 
 static bool _sde_rm_request_hw_blk_locked(struct sde_rm *rm,
 		struct sde_rm_hw_request *hw_blk_info)
 {
-	struct list_head *blk_list;
 	struct sde_rm_hw_blk *blk = NULL;
 
 	if (!rm || !hw_blk_info || hw_blk_info->type >= SDE_HW_BLK_MAX) {
@@ -411,23 +520,14 @@ static bool _sde_rm_request_hw_blk_locked(struct sde_rm *rm,
 	}
 
 	hw_blk_info->hw = NULL;
-	blk_list = &rm->hw_blks[hw_blk_info->type];
 
-	blk = list_prepare_entry(blk, blk_list, list);
-
-	list_for_each_entry_continue(blk, blk_list, list) {
-		if (blk->type != hw_blk_info->type) {
-			SDE_ERROR("found incorrect block type %d on %d list\n",
-					blk->type, hw_blk_info->type);
-			return false;
-		}
+	if (hw_blk_info->id >= 0 && hw_blk_info->id < SDE_RM_MAX_TYPE_BLKS)
+		blk = rm->blk_by_id[hw_blk_info->type][hw_blk_info->id];
 
-		if (blk->hw->id == hw_blk_info->id) {
-			hw_blk_info->hw = blk->hw;
-			SDE_DEBUG("found type %d id %d\n",
-					blk->type, blk->id);
-			return true;
-		}
+	if (blk) {
+		hw_blk_info->hw = blk->hw;
+		SDE_DEBUG("found type %d id %d\n", blk->type, blk->id);
+		return true;
 	}
 
 	SDE_DEBUG("no match, type %d id %d\n", hw_blk_info->type,
@@ -505,6 +605,16 @@ static void _sde_rm_hw_destroy(enum sde_hw_blk_type type, void *hw)
 	}
 }
 
+static void _sde_rm_cache_flush(struct sde_rm *rm)
+{
+	struct sde_rm_cache *cache, *cache_nxt;
+
+	list_for_each_entry_safe(cache, cache_nxt, &rm->rsvp_cache, list) {
+		list_del(&cache->list);
+		kfree(cache);
+	}
+}
+
 int sde_rm_destroy(struct sde_rm *rm)
 {
 
@@ -522,6 +632,8 @@ int sde_rm_destroy(struct sde_rm *rm)
 		kfree(rsvp_cur);
 	}
 
+	_sde_rm_cache_flush(rm);
+
 
 	for (type = 0; type < SDE_HW_BLK_MAX; type++) {
 		list_for_each_entry_safe(hw_cur, hw_nxt, &rm->hw_blks[type],
@@ -613,6 +725,11 @@ static int _sde_rm_hw_blk_create(
 	blk->type = type;
 	blk->id = id;
 	blk->hw = hw;
+	if (_sde_rm_blk_index(rm, blk)) {
+		kfree(blk);
+		_sde_rm_hw_destroy(type, hw);
+		return -E2BIG;
+	}
 	list_add_tail(&blk->list, &rm->hw_blks[type]);
 
 	_sde_rm_inc_resource_info(rm, &rm->avail_res, blk);
@@ -746,6 +863,7 @@ int sde_rm_init(struct sde_rm *rm,
 	mutex_init(&rm->rm_lock);
 
 	INIT_LIST_HEAD(&rm->rsvps);
+	INIT_LIST_HEAD(&rm->rsvp_cache);
 	for (type = 0; type < SDE_HW_BLK_MAX; type++)
 		INIT_LIST_HEAD(&rm->hw_blks[type]);
 
@@ -1189,13 +1307,13 @@ static int _sde_rm_reserve_lms(
 	}
 
 	for (i = 0; i < lm_count; i++) {
-		lm[i]->rsvp_nxt = rsvp;
-		pp[i]->rsvp_nxt = rsvp;
+		_sde_rm_blk_set_rsvp_nxt(rm, lm[i], rsvp);
+		_sde_rm_blk_set_rsvp_nxt(rm, pp[i], rsvp);
 		if (dspp[i])
-			dspp[i]->rsvp_nxt = rsvp;
+			_sde_rm_blk_set_rsvp_nxt(rm, dspp[i], rsvp);
 
 		if (ds[i])
-			ds[i]->rsvp_nxt = rsvp;
+			_sde_rm_blk_set_rsvp_nxt(rm, ds[i], rsvp);
 
 		SDE_EVT32(lm[i]->type, rsvp->enc_id, lm[i]->id, pp[i]->id,
 				dspp[i] ? dspp[i]->id : 0,
@@ -1216,7 +1334,7 @@ static int _sde_rm_reserve_lms(
 			if (RESERVED_BY_OTHER(iter_i.blk, rsvp))
 				continue;
 
-			iter_i.blk->rsvp_nxt = rsvp;
+			_sde_rm_blk_set_rsvp_nxt(rm, iter_i.blk, rsvp);
 			rc = 0;
 			break;
 		}
@@ -1305,7 +1423,7 @@ static int _sde_rm_reserve_ctls(
 		return -ENAVAIL;
 
 	for (i = 0; i < ARRAY_SIZE(ctls) && i < top->num_ctl; i++) {
-		ctls[i]->rsvp_nxt = rsvp;
+		_sde_rm_blk_set_rsvp_nxt(rm, ctls[i], rsvp);
 		SDE_EVT32(ctls[i]->type, rsvp->enc_id, ctls[i]->id);
 	}
 
@@ -1490,7 +1608,7 @@ static int _sde_rm_reserve_dsc(
 		if (!dsc[i])
 			break;
 
-		dsc[i]->rsvp_nxt = rsvp;
+		_sde_rm_blk_set_rsvp_nxt(rm, dsc[i], rsvp);
 
 		SDE_EVT32(dsc[i]->type, rsvp->enc_id, dsc[i]->id);
 	}
@@ -1550,7 +1668,7 @@ static int _sde_rm_reserve_vdc(
 		if (!vdc[i])
 			break;
 
-		vdc[i]->rsvp_nxt = rsvp;
+		_sde_rm_blk_set_rsvp_nxt(rm, vdc[i], rsvp);
 
 		SDE_EVT32(vdc[i]->type, rsvp->enc_id, vdc[i]->id);
 	}
@@ -1582,7 +1700,7 @@ static int _sde_rm_reserve_qdss(
 
 		SDE_DEBUG("blk id = %d\n", iter.blk->id);
 
-		iter.blk->rsvp_nxt = rsvp;
+		_sde_rm_blk_set_rsvp_nxt(rm, iter.blk, rsvp);
 		SDE_EVT32(iter.blk->type, rsvp->enc_id, iter.blk->id);
 		return 0;
 	}
@@ -1625,7 +1743,7 @@ static int _sde_rm_reserve_cdm(
 		if (!match)
 			continue;
 
-		iter.blk->rsvp_nxt = rsvp;
+		_sde_rm_blk_set_rsvp_nxt(rm, iter.blk, rsvp);
 		SDE_EVT32(iter.blk->type, rsvp->enc_id, iter.blk->id);
 		break;
 	}
@@ -1659,7 +1777,7 @@ static int _sde_rm_reserve_intf_or_wb(
 			return -ENAVAIL;
 		}
 
-		iter.blk->rsvp_nxt = rsvp;
+		_sde_rm_blk_set_rsvp_nxt(rm, iter.blk, rsvp);
 		SDE_EVT32(iter.blk->type, rsvp->enc_id, iter.blk->id);
 		break;
 	}
@@ -1824,6 +1942,118 @@ static int _sde_rm_make_vdc_rsvp(struct sde_rm *rm, struct sde_rm_rsvp *rsvp,
 	return ret;
 }
 
+static void _sde_rm_cache_make_key(struct sde_rm_requirements *reqs,
+		struct sde_rm_cache_key *key)
+{
+	struct msm_compression_info *comp_info = reqs->hw_res.comp_info;
+
+	memset(key, 0, sizeof(*key));
+	key->top_name = reqs->topology->top_name;
+	key->top_ctrl = reqs->top_ctrl & ~(BIT(SDE_RM_TOPCTL_RESERVE_LOCK) |
+			BIT(SDE_RM_TOPCTL_RESERVE_CLEAR));
+	memcpy(key->intfs, reqs->hw_res.intfs, sizeof(key->intfs));
+	memcpy(key->wbs, reqs->hw_res.wbs, sizeof(key->wbs));
+	key->needs_cdm = reqs->hw_res.needs_cdm;
+	key->display_type = reqs->hw_res.display_type;
+	key->comp_type = comp_info->comp_type;
+	if (comp_info->comp_type == MSM_DISPLAY_COMPRESSION_DSC)
+		key->native_yuv = comp_info->dsc_info.config.native_422 ||
+				comp_info->dsc_info.config.native_420;
+	key->cwb_requested_disp_type = reqs->cwb_requested_disp_type;
+	key->conn_lm_mask = reqs->conn_lm_mask;
+}
+
+static struct sde_rm_cache *_sde_rm_cache_get(struct sde_rm *rm,
+		uint32_t enc_id)
+{
+	struct sde_rm_cache *cache;
+
+	list_for_each_entry(cache, &rm->rsvp_cache, list)
+		if (cache->enc_id == enc_id)
+			return cache;
+
+	return NULL;
+}
+
+/**
+ * _sde_rm_cache_reserve - tag the blocks of the cached solution of an
+ *	encoder with the rsvp if its requirements did not change and none of
+ *	its blocks got reserved by another encoder since
+ * @rm:		KMS handle
+ * @rsvp:	Next reservation of the encoder
+ * @key:	Requirements of the next reservation
+ * Return: true if the next reservation is fully made from the cache
+ */
+static bool _sde_rm_cache_reserve(struct sde_rm *rm,
+		struct sde_rm_rsvp *rsvp,
+		const struct sde_rm_cache_key *key)
+{
+	struct sde_rm_cache *cache;
+	u32 i;
+
+	cache = _sde_rm_cache_get(rm, rsvp->enc_id);
+	if (!cache || !cache->num_blks ||
+			memcmp(&cache->key, key, sizeof(*key)))
+		goto miss;
+
+	for (i = 0; i < cache->num_blks; i++)
+		if (RESERVED_BY_OTHER(cache->blks[i], rsvp))
+			goto miss;
+
+	for (i = 0; i < cache->num_blks; i++)
+		_sde_rm_blk_set_rsvp_nxt(rm, cache->blks[i], rsvp);
+
+	rm->cache_hits++;
+	SDE_DEBUG("rsvp[s%de%d] reused %d cached blks\n", rsvp->seq,
+			rsvp->enc_id, cache->num_blks);
+	SDE_EVT32(rsvp->enc_id, cache->num_blks, rm->cache_hits,
+			rm->cache_misses);
+
+	return true;
+
+miss:
+	rm->cache_misses++;
+	SDE_EVT32(rsvp->enc_id, key->top_name, rm->cache_hits,
+			rm->cache_misses);
+
+	return false;
+}
+
+static void _sde_rm_cache_store(struct sde_rm *rm,
+		struct sde_rm_rsvp *rsvp,
+		const struct sde_rm_cache_key *key)
+{
+	struct sde_rm_cache *cache;
+	struct sde_rm_hw_blk *blk;
+	enum sde_hw_blk_type type;
+
+	cache = _sde_rm_cache_get(rm, rsvp->enc_id);
+	if (!cache) {
+		cache = kzalloc(sizeof(*cache), GFP_KERNEL);
+		if (!cache)
+			return;
+
+		cache->enc_id = rsvp->enc_id;
+		list_add_tail(&cache->list, &rm->rsvp_cache);
+	}
+
+	cache->key = *key;
+	cache->num_blks = 0;
+	for (type = 0; type < SDE_HW_BLK_MAX; type++) {
+		list_for_each_entry(blk, &rm->hw_blks[type], list) {
+			if (blk->rsvp_nxt != rsvp)
+				continue;
+
+			if (cache->num_blks == RM_CACHE_MAX_BLKS) {
+				cache->num_blks = 0;
+				return;
+			}
+
+			cache->blks[cache->num_blks++] = blk;
+		}
+	}
+}
+
 static int _sde_rm_make_next_rsvp(struct sde_rm *rm, struct drm_encoder *enc,
 		struct drm_crtc_state *crtc_state,
 		struct drm_connector_state *conn_state,
@@ -1834,6 +2064,7 @@ static int _sde_rm_make_next_rsvp(struct sde_rm *rm, struct drm_encoder *enc,
 	struct sde_kms *sde_kms;
 	struct sde_splash_display *splash_display = NULL;
 	struct sde_splash_data *splash_data;
+	struct sde_rm_cache_key key;
 	int i, ret;
 
 	priv = enc->dev->dev_private;
@@ -1859,6 +2090,11 @@ static int _sde_rm_make_next_rsvp(struct sde_rm *rm, struct drm_encoder *enc,
 	rsvp->pending = true;
 	list_add_tail(&rsvp->list, &rm->rsvps);
 
+	/* splash dictates its own blocks, never serve it from the cache */
+	_sde_rm_cache_make_key(reqs, &key);
+	if (!splash_display && _sde_rm_cache_reserve(rm, rsvp, &key))
+		return 0;
+
 	ret = _sde_rm_make_lm_rsvp(rm, rsvp, reqs, splash_display);
 	if (ret) {
 		SDE_ERROR("unable to find appropriate mixers\n");
@@ -1889,6 +2125,9 @@ static int _sde_rm_make_next_rsvp(struct sde_rm *rm, struct drm_encoder *enc,
 	if (ret)
 		return ret;
 
+	if (!splash_display)
+		_sde_rm_cache_store(rm, rsvp, &key);
+
 	return ret;
 }
 
@@ -2294,6 +2533,7 @@ static void _sde_rm_release_rsvp(
 	struct sde_rm_rsvp *rsvp_c, *rsvp_n;
 	struct sde_rm_hw_blk *blk;
 	enum sde_hw_blk_type type;
+	unsigned long mask, idx;
 
 	if (!rsvp)
 		return;
@@ -2308,9 +2548,11 @@ static void _sde_rm_release_rsvp(
 	}
 
 	for (type = 0; type < SDE_HW_BLK_MAX; type++) {
-		list_for_each_entry(blk, &rm->hw_blks[type], list) {
+		mask = rm->rsvp_mask[type] | rm->rsvp_nxt_mask[type];
+		for_each_set_bit(idx, &mask, SDE_RM_MAX_TYPE_BLKS) {
+			blk = rm->blks[type][idx];
 			if (blk->rsvp == rsvp) {
-				blk->rsvp = NULL;
+				_sde_rm_blk_set_rsvp(rm, blk, NULL);
 				SDE_DEBUG("rel rsvp %d enc %d %d %d\n",
 						rsvp->seq, rsvp->enc_id,
 						blk->type, blk->id);
@@ -2318,7 +2560,7 @@ static void _sde_rm_release_rsvp(
 						&rm->avail_res, blk);
 			}
 			if (blk->rsvp_nxt == rsvp) {
-				blk->rsvp_nxt = NULL;
+				_sde_rm_blk_set_rsvp_nxt(rm, blk, NULL);
 				SDE_DEBUG("rel rsvp_nxt %d enc %d %d %d\n",
 						rsvp->seq, rsvp->enc_id,
 						blk->type, blk->id);
@@ -2396,14 +2638,17 @@ static void _sde_rm_commit_rsvp(
 {
 	struct sde_rm_hw_blk *blk;
 	enum sde_hw_blk_type type;
+	unsigned long mask, idx;
 
 	/* Swap next rsvp to be the active */
 	for (type = 0; type < SDE_HW_BLK_MAX; type++) {
-		list_for_each_entry(blk, &rm->hw_blks[type], list) {
-			if (blk->rsvp_nxt && conn_state->best_encoder->base.id
+		mask = rm->rsvp_nxt_mask[type];
+		for_each_set_bit(idx, &mask, SDE_RM_MAX_TYPE_BLKS) {
+			blk = rm->blks[type][idx];
+			if (conn_state->best_encoder->base.id
 					 == blk->rsvp_nxt->enc_id) {
-				blk->rsvp = blk->rsvp_nxt;
-				blk->rsvp_nxt = NULL;
+				_sde_rm_blk_set_rsvp(rm, blk, blk->rsvp_nxt);
+				_sde_rm_blk_set_rsvp_nxt(rm, blk, NULL);
 				_sde_rm_dec_resource_info(rm,
 						&rm->avail_res, blk);
 			}
@@ -2635,6 +2880,11 @@ int sde_rm_ext_blk_create_reserve(struct sde_rm *rm,
 	blk->id = hw->id;
 	blk->hw = hw;
 	blk->rsvp = rsvp;
+	ret = _sde_rm_blk_index(rm, blk);
+	if (ret) {
+		kfree(blk);
+		goto end;
+	}
 	list_add_tail(&blk->list, &rm->hw_blks[hw->type]);
 
 	SDE_DEBUG("create blk %d %d for rsvp %d enc %d\n", blk->type, blk->id,
@@ -2677,11 +2927,15 @@ int sde_rm_ext_blk_destroy(struct sde_rm *rm,
 				kfree(blk);
 			}
 		}
+		_sde_rm_blk_reindex(rm, type);
 	}
 
 	SDE_DEBUG("del rsvp %d\n", rsvp->seq);
 	list_del(&rsvp->list);
 	kfree(rsvp);
+
+	/* cached solutions may point at the blocks just freed */
+	_sde_rm_cache_flush(rm);
 end:
 	mutex_unlock(&rm->rm_lock);
 	return ret;
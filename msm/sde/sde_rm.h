@@ -14,6 +14,9 @@
 #define SINGLE_CTL	1
 #define DUAL_CTL	2
 
+/* upper bound of hw blocks, and of hw block ids, of a single type */
+#define SDE_RM_MAX_TYPE_BLKS	32
+
 #define TOPOLOGY_SINGLEPIPE_MODE(x) \
 	(x == SDE_RM_TOPOLOGY_SINGLEPIPE ||\
 		x == SDE_RM_TOPOLOGY_SINGLEPIPE_DSC ||\
@@ -148,6 +151,12 @@ struct sde_rm_topology_def {
 	enum msm_display_compression_type comp_type;
 };
 
+/**
+ *  struct sde_rm_hw_blk - resource manager internal structure
+ *	forward declaration for single iterator definition without void pointer
+ */
+struct sde_rm_hw_blk;
+
 /**
  * struct sde_rm - SDE dynamic hardware resource manager
  * @dev: device handle for event logging purposes
@@ -159,6 +168,14 @@ struct sde_rm_topology_def {
  * @rsvp_next_seq: sequence number for next reservation for debugging purposes
  * @rm_lock: resource manager mutex
  * @avail_res: Pointer with curr available resources
+ * @rsvp_cache: list of the last reservation solution of each encoder
+ * @cache_hits: number of reservations served from @rsvp_cache
+ * @cache_misses: number of reservations needing a full search
+ * @blks: hw blocks of each type, in the same order as @hw_blks
+ * @num_blks: number of valid entries in @blks of each type
+ * @blk_by_id: hw blocks of each type indexed by their hw block id
+ * @rsvp_mask: per type bitmap of @blks entries with a current reservation
+ * @rsvp_nxt_mask: per type bitmap of @blks entries with a next reservation
  */
 struct sde_rm {
 	struct drm_device *dev;
@@ -170,14 +187,16 @@ struct sde_rm {
 	struct mutex rm_lock;
 	const struct sde_rm_topology_def *topology_tbl;
 	struct msm_resource_caps_info avail_res;
+	struct list_head rsvp_cache;
+	u32 cache_hits;
+	u32 cache_misses;
+	struct sde_rm_hw_blk *blks[SDE_HW_BLK_MAX][SDE_RM_MAX_TYPE_BLKS];
+	u32 num_blks[SDE_HW_BLK_MAX];
+	struct sde_rm_hw_blk *blk_by_id[SDE_HW_BLK_MAX][SDE_RM_MAX_TYPE_BLKS];
+	unsigned long rsvp_mask[SDE_HW_BLK_MAX];
+	unsigned long rsvp_nxt_mask[SDE_HW_BLK_MAX];
 };
 
-/**
- *  struct sde_rm_hw_blk - resource manager internal structure
- *	forward declaration for single iterator definition without void pointer
- */
-struct sde_rm_hw_blk;
-
 /**
  * struct sde_rm_hw_iter - iterator for use with sde_rm
  * @hw: sde_hw object requested, or NULL on failure
@@ -1324,9 +1324,7 @@ static int sde_dbg_debugfs_open(struct inode *inode, struct file *file)
 	file->private_data = inode->i_private;
 	mutex_lock(&sde_dbg_base.mutex);
 	sde_dbg_base.cur_evt_index = 0;
-	sde_dbg_base.evtlog->first = sde_dbg_base.evtlog->curr + 1;
-	sde_dbg_base.evtlog->last =
-		sde_dbg_base.evtlog->first + SDE_EVTLOG_ENTRY;
+	sde_evtlog_reset_dump_range(sde_dbg_base.evtlog);
 	mutex_unlock(&sde_dbg_base.mutex);
 	return 0;
 }
@@ -1497,6 +1495,41 @@ static const struct file_operations sde_dbg_ctrl_fops = {
 	.write = sde_dbg_ctrl_write,
 };
 
+static ssize_t sde_evtlog_pcpu_read(struct file *file, char __user *buff,
+		size_t count, loff_t *ppos)
+{
+	char buf[32];
+	int len;
+
+	len = snprintf(buf, sizeof(buf), "%u torn:%u\n",
+			READ_ONCE(sde_dbg_base.evtlog->pcpu_enable),
+			READ_ONCE(sde_dbg_base.evtlog->pcpu_torn));
+
+	return simple_read_from_buffer(buff, count, ppos, buf, len);
+}
+
+static ssize_t sde_evtlog_pcpu_write(struct file *file,
+	const char __user *user_buf, size_t count, loff_t *ppos)
+{
+	u32 enable = 0;
+	int rc;
+
+	if (kstrtouint_from_user(user_buf, count, 0, &enable))
+		return -EINVAL;
+
+	rc = sde_evtlog_pcpu_set_enable(sde_dbg_base.evtlog, !!enable);
+	if (rc)
+		return rc;
+
+	return count;
+}
+
+static const struct file_operations sde_evtlog_pcpu_fops = {
+	.open = simple_open,
+	.read = sde_evtlog_pcpu_read,
+	.write = sde_evtlog_pcpu_write,
+};
+
 static int sde_recovery_regdump_open(struct inode *inode, struct file *file)
 {
 	if (!inode || !file)
@@ -2240,6 +2273,8 @@ int sde_dbg_debugfs_register(struct device *dev)
 			&sde_evtlog_fops);
 	debugfs_create_u32("enable", 0600, debugfs_root,
 			&(sde_dbg_base.evtlog->enable));
+	debugfs_create_file("evtlog_pcpu", 0600, debugfs_root, NULL,
+			&sde_evtlog_pcpu_fops);
 	debugfs_create_u32("panic", 0600, debugfs_root,
 			&sde_dbg_base.panic_on_err);
 	debugfs_create_u32("reg_dump", 0600, debugfs_root,
@@ -100,6 +100,21 @@ enum sde_dbg_dump_context {
 #define SDE_EVTLOG_BUF_MAX 512
 #define SDE_EVTLOG_BUF_ALIGN 32
 
+/*
+ * per-cpu evtlog keeps this number of entries per cpu. Each cpu ring must
+ * hold at least print entry number of logs so that a partial dump of a
+ * single busy cpu is not truncated.
+ */
+#define SDE_EVTLOG_PCPU_ENTRY	(SDE_EVTLOG_PRINT_ENTRY * 4)
+
+/*
+ * number of function name pointers cached by the evtlog filter. Must be a
+ * power of two, lookups fall back to the filter list if the table is full.
+ */
+#define SDE_EVTLOG_FILTER_HASH_BITS	9
+#define SDE_EVTLOG_FILTER_HASH_SIZE	(1 << SDE_EVTLOG_FILTER_HASH_BITS)
+#define SDE_EVTLOG_FILTER_HASH_PROBE	8
+
 struct sde_dbg_power_ctrl {
 	void *handle;
 	void *client;
@@ -114,11 +129,43 @@ struct sde_dbg_evtlog_log {
 	u32 data_cnt;
 	int pid;
 	u8 cpu;
+	/* per-cpu rings only: ring sequence plus one, 0 while being written */
+	u32 seq;
+};
+
+/**
+ * struct sde_dbg_evtlog_pcpu - per-cpu event log ring, written without locks
+ * @logs: fixed size log records, validated through their seq when dumped
+ * @curr: monotonic count of records written on this cpu
+ * @dump_next: sequence of the next record to be output during dumps
+ * @dump_last: sequence snapshot of the last record to be output during dumps
+ */
+struct sde_dbg_evtlog_pcpu {
+	struct sde_dbg_evtlog_log logs[SDE_EVTLOG_PCPU_ENTRY];
+	u32 curr;
+	u32 dump_next;
+	u32 dump_last;
+} ____cacheline_aligned;
+
+/**
+ * struct sde_dbg_evtlog_filter_hash - cached filter result of a call site
+ * @name: __func__ pointer of the call site, NULL for an empty slot
+ * @filtered: true if the call site is filtered by the current filter list
+ */
+struct sde_dbg_evtlog_filter_hash {
+	const char *name;
+	bool filtered;
 };
 
 /**
  * @last_dump: Index of last entry to be output during evtlog dumps
  * @filter_list: Linked list of currently active filter strings
+ * @filter_cnt: Number of entries in filter_list
+ * @filter_hash: Open addressed cache of per call site filter results
+ * @pcpu_enable: Log into the per-cpu rings instead of the global log
+ * @pcpu_logs: Per-cpu rings, indexed by cpu id, allocated on first enable
+ * @pcpu_torn: Per-cpu records skipped by dumps as they were being rewritten
+ * @pcpu_prev_time: Timestamp of the previously dumped per-cpu record
  */
 struct sde_dbg_evtlog {
 	struct sde_dbg_evtlog_log logs[SDE_EVTLOG_ENTRY];
@@ -130,6 +177,13 @@ struct sde_dbg_evtlog {
 	u32 enable;
 	spinlock_t spin_lock;
 	struct list_head filter_list;
+	u32 filter_cnt;
+	struct sde_dbg_evtlog_filter_hash
+			filter_hash[SDE_EVTLOG_FILTER_HASH_SIZE];
+	u32 pcpu_enable;
+	struct sde_dbg_evtlog_pcpu **pcpu_logs;
+	s64 pcpu_prev_time;
+	u32 pcpu_torn;
 };
 
 extern struct sde_dbg_evtlog *sde_dbg_base_evtlog;
@@ -258,6 +312,15 @@ u32 sde_mini_dump_add_region(const char *name, u32 size, void *virt_addr);
  */
 struct sde_dbg_evtlog *sde_evtlog_init(void);
 
+/**
+ * sde_evtlog_pcpu_set_enable - switch logging to the per-cpu rings, the
+ *	rings are allocated on the first enable
+ * @evtlog:	pointer to evtlog
+ * @enable:	log into the per-cpu rings instead of the global log
+ * Returns:	zero on success, -ENOMEM if the rings can't be allocated
+ */
+int sde_evtlog_pcpu_set_enable(struct sde_dbg_evtlog *evtlog, bool enable);
+
 /**
  * sde_reglog_init - allocate a new reg log object
  * Returns:	reglog or -ERROR
@@ -329,6 +392,14 @@ ssize_t sde_evtlog_dump_to_buffer(struct sde_dbg_evtlog *evtlog,
 		char *evtlog_buf, ssize_t evtlog_buf_size,
 		bool update_last_entry, bool full_dump);
 
+/**
+ * sde_evtlog_reset_dump_range - mark all entries in the event log as not
+ *	yet dumped, so the next dump restarts from the oldest entry
+ * @evtlog:		pointer to evtlog
+ * Returns:		none
+ */
+void sde_evtlog_reset_dump_range(struct sde_dbg_evtlog *evtlog);
+
 /**
  * sde_dbg_init_dbg_buses - initialize debug bus dumping support for the chipset
  * @hwversion:		Chipset revision
@@ -13,7 +13,9 @@
 #include <linux/uaccess.h>
 #include <linux/dma-buf.h>
 #include <linux/slab.h>
+#include <linux/mm.h>
 #include <linux/sched/clock.h>
+#include <linux/hash.h>
 
 #include "sde_dbg.h"
 #include "sde_trace.h"
@@ -51,31 +53,80 @@ static bool _sde_evtlog_is_filtered_no_lock(
 	return rc;
 }
 
-bool sde_evtlog_is_enabled(struct sde_dbg_evtlog *evtlog, u32 flag)
+static void _sde_evtlog_filter_hash_reset_no_lock(struct sde_dbg_evtlog *evtlog)
 {
-	return evtlog && (evtlog->enable & flag);
+	int i;
+
+	for (i = 0; i < SDE_EVTLOG_FILTER_HASH_SIZE; i++)
+		WRITE_ONCE(evtlog->filter_hash[i].name, NULL);
 }
 
-void sde_evtlog_log(struct sde_dbg_evtlog *evtlog, const char *name, int line,
-		int flag, ...)
+static void _sde_evtlog_filter_hash_add_no_lock(struct sde_dbg_evtlog *evtlog,
+		const char *str, bool filtered)
+{
+	struct sde_dbg_evtlog_filter_hash *slot;
+	u32 i, idx;
+
+	idx = hash_ptr((void *)str, SDE_EVTLOG_FILTER_HASH_BITS);
+	for (i = 0; i < SDE_EVTLOG_FILTER_HASH_PROBE; i++) {
+		slot = &evtlog->filter_hash[(idx + i) &
+				(SDE_EVTLOG_FILTER_HASH_SIZE - 1)];
+		if (slot->name == str)
+			return;
+
+		if (!slot->name) {
+			WRITE_ONCE(slot->filtered, filtered);
+			/* publish the result before the key for lockless readers */
+			smp_store_release(&slot->name, str);
+			return;
+		}
+	}
+}
+
+/*
+ * Call sites always pass __func__, so the filter result is cached per name
+ * pointer and the filter list is only walked once per call site after each
+ * filter update.
+ */
+static bool _sde_evtlog_is_filtered(struct sde_dbg_evtlog *evtlog,
+		const char *str)
 {
+	struct sde_dbg_evtlog_filter_hash *slot;
 	unsigned long flags;
-	int i, val = 0;
-	va_list args;
-	struct sde_dbg_evtlog_log *log;
+	const char *name;
+	u32 i, idx;
+	bool rc;
 
-	if (!evtlog)
-		return;
+	if (!str)
+		return true;
 
-	if (!sde_evtlog_is_enabled(evtlog, flag))
-		return;
+	if (!READ_ONCE(evtlog->filter_cnt))
+		return false;
+
+	idx = hash_ptr((void *)str, SDE_EVTLOG_FILTER_HASH_BITS);
+	for (i = 0; i < SDE_EVTLOG_FILTER_HASH_PROBE; i++) {
+		slot = &evtlog->filter_hash[(idx + i) &
+				(SDE_EVTLOG_FILTER_HASH_SIZE - 1)];
+		name = smp_load_acquire(&slot->name);
+		if (name == str)
+			return READ_ONCE(slot->filtered);
+		else if (!name)
+			break;
+	}
 
 	spin_lock_irqsave(&evtlog->spin_lock, flags);
+	rc = _sde_evtlog_is_filtered_no_lock(evtlog, str);
+	_sde_evtlog_filter_hash_add_no_lock(evtlog, str, rc);
+	spin_unlock_irqrestore(&evtlog->spin_lock, flags);
 
-	if (_sde_evtlog_is_filtered_no_lock(evtlog, name))
-		goto exit;
+	return rc;
+}
+
+static void _sde_evtlog_fill_log(struct sde_dbg_evtlog_log *log,
+		const char *name, int line, va_list args)
+{
+	int i, val = 0;
 
-	log = &evtlog->logs[evtlog->curr];
 	log->time = local_clock();
 	log->name = name;
 	log->line = line;
@@ -83,7 +134,6 @@ void sde_evtlog_log(struct sde_dbg_evtlog *evtlog, const char *name, int line,
 	log->pid = current->pid;
 	log->cpu = raw_smp_processor_id();
 
-	va_start(args, flag);
 	for (i = 0; i < SDE_EVTLOG_MAX_DATA; i++) {
 
 		val = va_arg(args, int);
@@ -92,14 +142,60 @@ void sde_evtlog_log(struct sde_dbg_evtlog *evtlog, const char *name, int line,
 
 		log->data[i] = val;
 	}
-	va_end(args);
 	log->data_cnt = i;
-	evtlog->curr = (evtlog->curr + 1) % SDE_EVTLOG_ENTRY;
-	evtlog->last++;
+}
 
-	trace_sde_evtlog(name, line, log->data_cnt, log->data);
-exit:
-	spin_unlock_irqrestore(&evtlog->spin_lock, flags);
+bool sde_evtlog_is_enabled(struct sde_dbg_evtlog *evtlog, u32 flag)
+{
+	return evtlog && (evtlog->enable & flag);
+}
+
+void sde_evtlog_log(struct sde_dbg_evtlog *evtlog, const char *name, int line,
+		int flag, ...)
+{
+	unsigned long flags;
+	va_list args;
+	struct sde_dbg_evtlog_log *log;
+	struct sde_dbg_evtlog_pcpu *ring;
+	u32 seq;
+
+	if (!evtlog)
+		return;
+
+	if (!sde_evtlog_is_enabled(evtlog, flag))
+		return;
+
+	if (_sde_evtlog_is_filtered(evtlog, name))
+		return;
+
+	va_start(args, flag);
+	if (smp_load_acquire(&evtlog->pcpu_enable)) {
+		/* only local irqs can race with the writer of this cpu ring */
+		local_irq_save(flags);
+		ring = evtlog->pcpu_logs[raw_smp_processor_id()];
+		seq = ring->curr;
+		log = &ring->logs[seq % SDE_EVTLOG_PCPU_ENTRY];
+
+		/* dumps on other cpus drop the record if seq changes under them */
+		WRITE_ONCE(log->seq, 0);
+		smp_wmb();
+		_sde_evtlog_fill_log(log, name, line, args);
+		smp_store_release(&log->seq, seq + 1);
+		smp_store_release(&ring->curr, seq + 1);
+
+		trace_sde_evtlog(name, line, log->data_cnt, log->data);
+		local_irq_restore(flags);
+	} else {
+		spin_lock_irqsave(&evtlog->spin_lock, flags);
+		log = &evtlog->logs[evtlog->curr];
+		_sde_evtlog_fill_log(log, name, line, args);
+		evtlog->curr = (evtlog->curr + 1) % SDE_EVTLOG_ENTRY;
+		evtlog->last++;
+
+		trace_sde_evtlog(name, line, log->data_cnt, log->data);
+		spin_unlock_irqrestore(&evtlog->spin_lock, flags);
+	}
+	va_end(args);
 }
 
 void sde_reglog_log(u8 blk_id, u32 val, u32 addr)
@@ -156,27 +252,93 @@ static bool _sde_evtlog_dump_calc_range(struct sde_dbg_evtlog *evtlog,
 	return true;
 }
 
-ssize_t sde_evtlog_dump_to_buffer(struct sde_dbg_evtlog *evtlog,
-		char *evtlog_buf, ssize_t evtlog_buf_size,
-		bool update_last_entry, bool full_dump)
+/*
+ * copy record seq of a ring, fails if the writer of the ring has started to
+ * rewrite the slot before or while it was copied
+ */
+static bool _sde_evtlog_pcpu_read(struct sde_dbg_evtlog_pcpu *ring, u32 seq,
+		struct sde_dbg_evtlog_log *out)
 {
-	int i;
-	ssize_t off = 0;
-	struct sde_dbg_evtlog_log *log, *prev_log;
-	unsigned long flags;
+	struct sde_dbg_evtlog_log *log = &ring->logs[seq % SDE_EVTLOG_PCPU_ENTRY];
 
-	if (!evtlog || !evtlog_buf)
-		return 0;
+	if (smp_load_acquire(&log->seq) != seq + 1)
+		return false;
 
-	spin_lock_irqsave(&evtlog->spin_lock, flags);
+	memcpy(out, log, sizeof(*out));
+	smp_rmb();
 
-	/* update markers, exit if nothing to print */
-	if (!_sde_evtlog_dump_calc_range(evtlog, update_last_entry, full_dump))
-		goto exit;
+	return READ_ONCE(log->seq) == seq + 1;
+}
 
-	log = &evtlog->logs[evtlog->first % SDE_EVTLOG_ENTRY];
+/* pop the oldest not yet dumped record across all cpu rings */
+static bool _sde_evtlog_pcpu_pop(struct sde_dbg_evtlog *evtlog,
+		struct sde_dbg_evtlog_log *out, u32 *seq)
+{
+	struct sde_dbg_evtlog_pcpu *ring, *oldest_ring = NULL;
+	struct sde_dbg_evtlog_log log;
+	int cpu;
 
-	prev_log = &evtlog->logs[(evtlog->first - 1) % SDE_EVTLOG_ENTRY];
+	for_each_possible_cpu(cpu) {
+		ring = evtlog->pcpu_logs[cpu];
+
+		for (; ring->dump_next != ring->dump_last; ring->dump_next++) {
+			if (_sde_evtlog_pcpu_read(ring, ring->dump_next, &log))
+				break;
+			evtlog->pcpu_torn++;
+		}
+
+		if (ring->dump_next == ring->dump_last)
+			continue;
+
+		if (!oldest_ring || log.time < out->time) {
+			memcpy(out, &log, sizeof(*out));
+			oldest_ring = ring;
+		}
+	}
+
+	if (!oldest_ring)
+		return false;
+
+	*seq = oldest_ring->dump_next;
+	oldest_ring->dump_next++;
+
+	return true;
+}
+
+/* snapshot the end of every cpu ring and drop entries beyond the print limit */
+static void _sde_evtlog_pcpu_dump_calc_range(struct sde_dbg_evtlog *evtlog,
+		bool full_dump)
+{
+	u32 max_entries = full_dump ? SDE_EVTLOG_ENTRY : SDE_EVTLOG_PRINT_ENTRY;
+	struct sde_dbg_evtlog_pcpu *ring;
+	struct sde_dbg_evtlog_log log;
+	u32 total = 0, skip, seq;
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		ring = evtlog->pcpu_logs[cpu];
+		ring->dump_last = smp_load_acquire(&ring->curr);
+		if (ring->dump_last - ring->dump_next > SDE_EVTLOG_PCPU_ENTRY)
+			ring->dump_next = ring->dump_last -
+					SDE_EVTLOG_PCPU_ENTRY;
+		total += ring->dump_last - ring->dump_next;
+	}
+
+	if (total <= max_entries)
+		return;
+
+	skip = total - max_entries;
+	pr_info("evtlog skipping %d per-cpu entries\n", skip);
+	while (skip-- && _sde_evtlog_pcpu_pop(evtlog, &log, &seq))
+		;
+}
+
+static ssize_t _sde_evtlog_print_log(struct sde_dbg_evtlog_log *log,
+		u32 index, s64 prev_time, char *evtlog_buf,
+		ssize_t evtlog_buf_size)
+{
+	ssize_t off = 0;
+	int i;
 
 	off = snprintf((evtlog_buf + off), (evtlog_buf_size - off), "%s:%-4d",
 		log->name, log->line);
@@ -187,20 +349,100 @@ ssize_t sde_evtlog_dump_to_buffer(struct sde_dbg_evtlog *evtlog,
 	}
 
 	off += snprintf((evtlog_buf + off), (evtlog_buf_size - off),
-		"=>[%-8d:%-11llu:%9llu][%-4d]:[%-4d]:", evtlog->first,
-		log->time, (log->time - prev_log->time), log->pid, log->cpu);
+		"=>[%-8d:%-11llu:%9llu][%-4d]:[%-4d]:", index,
+		log->time, (log->time - prev_time), log->pid, log->cpu);
 
 	for (i = 0; i < log->data_cnt; i++)
 		off += snprintf((evtlog_buf + off), (evtlog_buf_size - off),
 			"%x ", log->data[i]);
 
 	off += snprintf((evtlog_buf + off), (evtlog_buf_size - off), "\n");
+
+	return off;
+}
+
+static ssize_t _sde_evtlog_pcpu_dump_to_buffer(struct sde_dbg_evtlog *evtlog,
+		char *evtlog_buf, ssize_t evtlog_buf_size,
+		bool update_last_entry, bool full_dump)
+{
+	struct sde_dbg_evtlog_log log;
+	ssize_t off = 0;
+	u32 seq = 0;
+
+	if (update_last_entry)
+		_sde_evtlog_pcpu_dump_calc_range(evtlog, full_dump);
+
+	if (!_sde_evtlog_pcpu_pop(evtlog, &log, &seq))
+		return 0;
+
+	off = _sde_evtlog_print_log(&log, seq,
+			update_last_entry ? log.time : evtlog->pcpu_prev_time,
+			evtlog_buf, evtlog_buf_size);
+	evtlog->pcpu_prev_time = log.time;
+
+	return off;
+}
+
+ssize_t sde_evtlog_dump_to_buffer(struct sde_dbg_evtlog *evtlog,
+		char *evtlog_buf, ssize_t evtlog_buf_size,
+		bool update_last_entry, bool full_dump)
+{
+	ssize_t off = 0;
+	struct sde_dbg_evtlog_log *log, *prev_log;
+	unsigned long flags;
+
+	if (!evtlog || !evtlog_buf)
+		return 0;
+
+	spin_lock_irqsave(&evtlog->spin_lock, flags);
+
+	if (smp_load_acquire(&evtlog->pcpu_enable)) {
+		off = _sde_evtlog_pcpu_dump_to_buffer(evtlog, evtlog_buf,
+				evtlog_buf_size, update_last_entry, full_dump);
+		goto exit;
+	}
+
+	/* update markers, exit if nothing to print */
+	if (!_sde_evtlog_dump_calc_range(evtlog, update_last_entry, full_dump))
+		goto exit;
+
+	log = &evtlog->logs[evtlog->first % SDE_EVTLOG_ENTRY];
+
+	prev_log = &evtlog->logs[(evtlog->first - 1) % SDE_EVTLOG_ENTRY];
+
+	off = _sde_evtlog_print_log(log, evtlog->first, prev_log->time,
+			evtlog_buf, evtlog_buf_size);
 exit:
 	spin_unlock_irqrestore(&evtlog->spin_lock, flags);
 
 	return off;
 }
 
+void sde_evtlog_reset_dump_range(struct sde_dbg_evtlog *evtlog)
+{
+	struct sde_dbg_evtlog_pcpu *ring;
+	unsigned long flags;
+	u32 seq;
+	int cpu;
+
+	if (!evtlog)
+		return;
+
+	spin_lock_irqsave(&evtlog->spin_lock, flags);
+	evtlog->first = evtlog->curr + 1;
+	evtlog->last = evtlog->first + SDE_EVTLOG_ENTRY;
+
+	if (evtlog->pcpu_logs) {
+		for_each_possible_cpu(cpu) {
+			ring = evtlog->pcpu_logs[cpu];
+			seq = READ_ONCE(ring->curr);
+			ring->dump_next = seq > SDE_EVTLOG_PCPU_ENTRY ?
+					seq - SDE_EVTLOG_PCPU_ENTRY : 0;
+		}
+	}
+	spin_unlock_irqrestore(&evtlog->spin_lock, flags);
+}
+
 void sde_evtlog_dump_all(struct sde_dbg_evtlog *evtlog)
 {
 	char buf[SDE_EVTLOG_BUF_MAX];
@@ -216,6 +458,95 @@ void sde_evtlog_dump_all(struct sde_dbg_evtlog *evtlog)
 	}
 }
 
+static void _sde_evtlog_pcpu_free(struct sde_dbg_evtlog_pcpu **logs)
+{
+	int cpu;
+
+	if (!logs)
+		return;
+
+	for_each_possible_cpu(cpu)
+		if (logs[cpu])
+			free_pages_exact(logs[cpu], sizeof(*logs[cpu]));
+	kfree(logs);
+}
+
+/*
+ * Each ring is a separate page allocation in the linear map, so that every
+ * ring can be added to the minidump like the global log.
+ */
+static struct sde_dbg_evtlog_pcpu **_sde_evtlog_pcpu_alloc(void)
+{
+	struct sde_dbg_evtlog_pcpu **logs;
+	int cpu;
+
+	logs = kcalloc(nr_cpu_ids, sizeof(*logs), GFP_KERNEL);
+	if (!logs)
+		return NULL;
+
+	for_each_possible_cpu(cpu) {
+		logs[cpu] = alloc_pages_exact(sizeof(*logs[cpu]),
+				GFP_KERNEL | __GFP_ZERO);
+		if (!logs[cpu]) {
+			_sde_evtlog_pcpu_free(logs);
+			return NULL;
+		}
+	}
+
+	return logs;
+}
+
+static void _sde_evtlog_pcpu_add_minidump(struct sde_dbg_evtlog_pcpu **logs)
+{
+	char name[16];
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		snprintf(name, sizeof(name), "evt_log_cpu%d", cpu);
+		if (sde_mini_dump_add_region(name, sizeof(*logs[cpu]),
+				logs[cpu]) < 0)
+			pr_err("minidump add region failed for %s\n", name);
+	}
+}
+
+int sde_evtlog_pcpu_set_enable(struct sde_dbg_evtlog *evtlog, bool enable)
+{
+	struct sde_dbg_evtlog_pcpu **logs;
+	unsigned long flags;
+
+	if (!evtlog)
+		return -EINVAL;
+
+	if (!enable) {
+		WRITE_ONCE(evtlog->pcpu_enable, 0);
+		return 0;
+	}
+
+	/* the rings are large, only allocate them once they are used */
+	if (!evtlog->pcpu_logs) {
+		logs = _sde_evtlog_pcpu_alloc();
+		if (!logs)
+			return -ENOMEM;
+
+		spin_lock_irqsave(&evtlog->spin_lock, flags);
+		if (!evtlog->pcpu_logs) {
+			evtlog->pcpu_logs = logs;
+			logs = NULL;
+		}
+		spin_unlock_irqrestore(&evtlog->spin_lock, flags);
+
+		if (logs)
+			_sde_evtlog_pcpu_free(logs);
+		else
+			_sde_evtlog_pcpu_add_minidump(evtlog->pcpu_logs);
+	}
+
+	/* publish the rings before writers can see the mode */
+	smp_store_release(&evtlog->pcpu_enable, 1);
+
+	return 0;
+}
+
 struct sde_dbg_evtlog *sde_evtlog_init(void)
 {
 	struct sde_dbg_evtlog *evtlog;
@@ -298,6 +629,8 @@ void sde_evtlog_set_filter(struct sde_dbg_evtlog *evtlog, char *filter)
 		list_del_init(&filter_node->list);
 		list_add_tail(&filter_node->list, &free_list);
 	}
+	WRITE_ONCE(evtlog->filter_cnt, 0);
+	_sde_evtlog_filter_hash_reset_no_lock(evtlog);
 	spin_unlock_irqrestore(&evtlog->spin_lock, flags);
 
 	/*
@@ -328,6 +661,8 @@ void sde_evtlog_set_filter(struct sde_dbg_evtlog *evtlog, char *filter)
 
 		spin_lock_irqsave(&evtlog->spin_lock, flags);
 		list_add_tail(&filter_node->list, &evtlog->filter_list);
+		WRITE_ONCE(evtlog->filter_cnt, evtlog->filter_cnt + 1);
+		_sde_evtlog_filter_hash_reset_no_lock(evtlog);
 		spin_unlock_irqrestore(&evtlog->spin_lock, flags);
 	}
 
@@ -351,6 +686,7 @@ void sde_evtlog_destroy(struct sde_dbg_evtlog *evtlog)
 		list_del(&filter_node->list);
 		kfree(filter_node);
 	}
+	_sde_evtlog_pcpu_free(evtlog->pcpu_logs);
 	kfree(evtlog);
 }
 
@@ -3,10 +3,12 @@
  * Copyright (c) 2012, 2015-2019, The Linux Foundation. All rights reserved.
  */
 
+#include <linux/once.h>
 #include <media/msm_sde_rotator.h>
 
 #include "sde_rotator_formats.h"
 #include "sde_rotator_util.h"
+#include "sde_format_lut.h"
 
 #define FMT_RGB_565(fmt, desc, frame_fmt, flag_arg, e0, e1, e2, isubwc)	\
 	{							\
@@ -779,38 +781,51 @@ static struct sde_mdp_format_params sde_mdp_format_map[] = {
 		SDE_MDP_COMPRESS_NONE),
 };
 
+/* lookup table classes of the two format maps */
+#define SDE_ROT_FORMAT_CLASS_MAP	0
+#define SDE_ROT_FORMAT_CLASS_UBWC	1
+
+static struct sde_format_lut sde_rot_format_lut;
+
+static void _sde_rot_format_lut_init(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(sde_mdp_format_map); i++)
+		sde_format_lut_insert(&sde_rot_format_lut,
+				sde_mdp_format_map[i].format,
+				SDE_ROT_FORMAT_CLASS_MAP, i);
+
+	for (i = 0; i < ARRAY_SIZE(sde_mdp_format_ubwc_map); i++)
+		sde_format_lut_insert(&sde_rot_format_lut,
+				sde_mdp_format_ubwc_map[i].mdp_format.format,
+				SDE_ROT_FORMAT_CLASS_UBWC, i);
+
+	WARN_ON(sde_rot_format_lut.count > SDE_FORMAT_LUT_SIZE / 2);
+}
+
 /*
  * sde_get_format_params - return format parameter of the given format
  * @format: format to lookup
  */
 struct sde_mdp_format_params *sde_get_format_params(u32 format)
 {
-	struct sde_mdp_format_params *fmt = NULL;
 	int i;
-	bool fmt_found = false;
-
-	for (i = 0; i < ARRAY_SIZE(sde_mdp_format_map); i++) {
-		fmt = &sde_mdp_format_map[i];
-		if (format == fmt->format) {
-			fmt_found = true;
-			break;
-		}
-	}
 
-	if (!fmt_found) {
-		for (i = 0; i < ARRAY_SIZE(sde_mdp_format_ubwc_map); i++) {
-			fmt = &sde_mdp_format_ubwc_map[i].mdp_format;
-			if (format == fmt->format) {
-				fmt_found = true;
-				break;
-			}
-		}
-	}
-	/* If format not supported than return NULL */
-	if (!fmt_found)
-		fmt = NULL;
+	DO_ONCE(_sde_rot_format_lut_init);
 
-	return fmt;
+	i = sde_format_lut_find(&sde_rot_format_lut, format,
+			SDE_ROT_FORMAT_CLASS_MAP);
+	if (i >= 0)
+		return &sde_mdp_format_map[i];
+
+	i = sde_format_lut_find(&sde_rot_format_lut, format,
+			SDE_ROT_FORMAT_CLASS_UBWC);
+	if (i >= 0)
+		return &sde_mdp_format_ubwc_map[i].mdp_format;
+
+	/* If format not supported than return NULL */
+	return NULL;
 }
 
 /*
@@ -821,21 +836,17 @@ struct sde_mdp_format_params *sde_get_format_params(u32 format)
  */
 int sde_rot_get_ubwc_micro_dim(u32 format, u16 *w, u16 *h)
 {
-	struct sde_mdp_format_params_ubwc *fmt = NULL;
-	bool fmt_found = false;
+	struct sde_mdp_format_params_ubwc *fmt;
 	int i;
 
-	for (i = 0; i < ARRAY_SIZE(sde_mdp_format_ubwc_map); i++) {
-		fmt = &sde_mdp_format_ubwc_map[i];
-		if (format == fmt->mdp_format.format) {
-			fmt_found = true;
-			break;
-		}
-	}
+	DO_ONCE(_sde_rot_format_lut_init);
 
-	if (!fmt_found)
+	i = sde_format_lut_find(&sde_rot_format_lut, format,
+			SDE_ROT_FORMAT_CLASS_UBWC);
+	if (i < 0)
 		return -EINVAL;
 
+	fmt = &sde_mdp_format_ubwc_map[i];
 	*w = fmt->micro.tile_width;
 	*h = fmt->micro.tile_height;
 
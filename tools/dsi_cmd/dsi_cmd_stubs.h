@@ -0,0 +1,63 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2021, The Linux Foundation. All rights reserved.
+ */
+
+/*
+ * Host stand-ins for the mipi dsi types and helpers that the command set
+ * code of dsi_panel.c and dsi_ctrl.c uses. The flags follow the msm copy
+ * of drm_mipi_dsi.h, which dsi_panel.h extends.
+ */
+
+#ifndef _DSI_CMD_STUBS_H_
+#define _DSI_CMD_STUBS_H_
+
+#include <linux/kernel.h>
+
+#define DSI_ERR(fmt, ...)	fprintf(stderr, "[dsi] " fmt, ##__VA_ARGS__)
+
+#define MIPI_DSI_MSG_USE_LPM		BIT(0)
+#define MIPI_DSI_MSG_REQ_ACK		BIT(1)
+#define MIPI_DSI_MSG_UNICAST		BIT(2)
+#define MIPI_DSI_MSG_LASTCOMMAND	BIT(3)
+
+enum {
+	MIPI_DSI_GENERIC_READ_REQUEST_0_PARAM	= 0x04,
+	MIPI_DSI_DCS_READ			= 0x06,
+	MIPI_DSI_NULL_PACKET			= 0x09,
+	MIPI_DSI_PICTURE_PARAMETER_SET		= 0x0a,
+	MIPI_DSI_COMPRESSED_PIXEL_STREAM	= 0x0b,
+	MIPI_DSI_GENERIC_READ_REQUEST_1_PARAM	= 0x14,
+	MIPI_DSI_BLANKING_PACKET		= 0x19,
+	MIPI_DSI_GENERIC_READ_REQUEST_2_PARAM	= 0x24,
+	MIPI_DSI_GENERIC_LONG_WRITE		= 0x29,
+	MIPI_DSI_DCS_LONG_WRITE			= 0x39,
+};
+
+struct mipi_dsi_msg {
+	u8 channel;
+	u8 type;
+	u16 flags;
+	u32 ctrl;
+	u32 wait_ms;
+
+	size_t tx_len;
+	const void *tx_buf;
+
+	size_t rx_len;
+	void *rx_buf;
+};
+
+struct mipi_dsi_packet {
+	size_t size;
+	u8 header[4];
+	size_t payload_length;
+	const u8 *payload;
+};
+
+bool mipi_dsi_packet_format_is_long(u8 type);
+
+int mipi_dsi_create_packet(struct mipi_dsi_packet *packet,
+		const struct mipi_dsi_msg *msg);
+
+#endif /* _DSI_CMD_STUBS_H_ */
@@ -0,0 +1,794 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2021, The Linux Foundation. All rights reserved.
+ */
+
+/*
+ * Replay the command sets of panel device tree sources on the host and
+ * print where the time of each set goes. The command set parsing and
+ * packing of dsi_panel.c and the packet serialization of dsi_ctrl.c are
+ * extracted from the driver sources at build time. The controller is a
+ * stand-in that stages packets in a command buffer like the embedded DMA
+ * path of dsi_message_tx and records every kickoff.
+ *
+ * Per command set the host time to parse the DT bytes, to pack the set and
+ * to build the DMA buffer of one transmission, unpacked and packed, is
+ * measured. The link time is estimated from the bytes of each kickoff and
+ * the post command waits are summed from the DT, neither is slept. Both
+ * transmission paths have to kick off the same bytes at the same points.
+ *
+ * usage: dsi_cmd_replay [-n rounds] [-l lanes] [-r lane_mbps] <dts>...
+ */
+
+#define _GNU_SOURCE
+#include <ctype.h>
+#include <getopt.h>
+
+#include "dsi_cmd_stubs.h"
+#include "dsi_cmd_sources.c"
+
+#include "tools_test.h"
+
+/* escape mode rate of the lp transfers, on a single lane */
+#define REPLAY_LP_MBPS		10
+#define REPLAY_MAX_DEPTH	16
+#define REPLAY_NAME_LEN		64
+
+static u32 replay_rounds = 1000;
+static u32 replay_lanes = 4;
+static u32 replay_lane_mbps = 1000;
+
+/**
+ * struct replay_prop - command set or command set state property of a node
+ * @node:     name of the node holding the property
+ * @node_id:  index of the node in the source, unique per node
+ * @type:     command set the property belongs to
+ * @is_state: true for the state property of the set
+ * @value:    value as written in the source, not terminated
+ * @len:      length of @value
+ * @line:     line of the property in the source
+ */
+struct replay_prop {
+	char node[REPLAY_NAME_LEN];
+	u32 node_id;
+	enum dsi_cmd_set_type type;
+	bool is_state;
+	const char *value;
+	u32 len;
+	u32 line;
+};
+
+/**
+ * struct replay_ctrl - stand-in for the command DMA path of the controller
+ * @cmd_buf:   packets staged for the next kickoff
+ * @cmd_len:   bytes staged in @cmd_buf
+ * @cmd_size:  size of @cmd_buf
+ * @pad_buf:   serialized packet of an unpacked command
+ * @pad_size:  size of @pad_buf
+ * @out:       every kicked off byte in order, only kept while @record
+ * @out_len:   bytes in @out
+ * @out_size:  size of @out
+ * @record:    keep the kicked off bytes in @out
+ * @kickoffs:  number of kickoffs
+ * @link_ns:   estimated time on the link of all kickoffs
+ * @wait_ms:   post command waits of the transmitted commands
+ */
+struct replay_ctrl {
+	u8 *cmd_buf;
+	u32 cmd_len;
+	u32 cmd_size;
+	u8 *pad_buf;
+	u32 pad_size;
+	u8 *out;
+	u32 out_len;
+	u32 out_size;
+	bool record;
+	u32 kickoffs;
+	unsigned long long link_ns;
+	u32 wait_ms;
+};
+
+/**
+ * struct replay_total - totals over all replayed command sets
+ * @sets:      number of command sets
+ * @cmds:      number of commands
+ * @bytes:     bytes of the DT command set properties
+ * @parse_ns:  time to parse all sets once
+ * @pack_ns:   time to pack all sets once
+ * @tx_ns:     time to build the DMA buffers of all sets once, unpacked
+ * @tx_pk_ns:  time to build the DMA buffers of all sets once, packed
+ * @wait_ms:   post command waits of all sets
+ */
+struct replay_total {
+	u32 sets;
+	u32 cmds;
+	u32 bytes;
+	double parse_ns;
+	double pack_ns;
+	double tx_ns;
+	double tx_pk_ns;
+	u32 wait_ms;
+};
+
+static int replay_reserve(u8 **buf, u32 *size, u32 len)
+{
+	u32 new_size = *size ? *size : 256;
+	u8 *new_buf;
+
+	if (len <= *size)
+		return 0;
+
+	while (new_size < len)
+		new_size *= 2;
+
+	new_buf = realloc(*buf, new_size);
+	if (!new_buf)
+		return -ENOMEM;
+
+	*buf = new_buf;
+	*size = new_size;
+	return 0;
+}
+
+static int replay_kickoff(struct replay_ctrl *ctrl, bool lpm)
+{
+	u32 mbps = lpm ? REPLAY_LP_MBPS : replay_lanes * replay_lane_mbps;
+	int rc;
+
+	ctrl->kickoffs++;
+	ctrl->link_ns += ctrl->cmd_len * 8000ull / mbps;
+
+	if (ctrl->record) {
+		rc = replay_reserve(&ctrl->out, &ctrl->out_size,
+				ctrl->out_len + ctrl->cmd_len);
+		if (rc)
+			return rc;
+
+		memcpy(ctrl->out + ctrl->out_len, ctrl->cmd_buf, ctrl->cmd_len);
+		ctrl->out_len += ctrl->cmd_len;
+	}
+
+	ctrl->cmd_len = 0;
+	return 0;
+}
+
+/* the embedded mode path of dsi_message_tx */
+static int replay_tx(struct replay_ctrl *ctrl, const struct mipi_dsi_msg *msg)
+{
+	struct mipi_dsi_packet packet;
+	const u8 *buffer;
+	u32 length;
+	u8 *tail;
+	int rc;
+
+	if (msg->flags & MIPI_DSI_MSG_PACKED) {
+		buffer = msg->tx_buf;
+		length = msg->tx_len;
+	} else {
+		rc = mipi_dsi_create_packet(&packet, msg);
+		if (rc)
+			return rc;
+
+		rc = replay_reserve(&ctrl->pad_buf, &ctrl->pad_size,
+				ALIGN(packet.size, 4));
+		if (rc)
+			return rc;
+
+		length = dsi_ctrl_pack_cmd_packet(&packet, ctrl->pad_buf);
+		if (msg->flags & MIPI_DSI_MSG_LASTCOMMAND)
+			ctrl->pad_buf[3] |= BIT(7);
+		buffer = ctrl->pad_buf;
+	}
+
+	rc = replay_reserve(&ctrl->cmd_buf, &ctrl->cmd_size,
+			ctrl->cmd_len + length);
+	if (rc)
+		return rc;
+
+	tail = ctrl->cmd_buf + ctrl->cmd_len;
+	memcpy(tail, buffer, length);
+	ctrl->cmd_len += length;
+
+	if (!(msg->flags & MIPI_DSI_MSG_LASTCOMMAND))
+		return 0;
+
+	if (msg->flags & MIPI_DSI_MSG_PACKED)
+		dsi_ctrl_mark_packed_last_cmd(tail, length);
+
+	return replay_kickoff(ctrl, msg->flags & MIPI_DSI_MSG_USE_LPM);
+}
+
+/* dsi_panel_tx_cmd_msg without the sleep */
+static int replay_tx_msg(struct replay_ctrl *ctrl,
+		const struct dsi_panel_cmd_set *set,
+		const struct mipi_dsi_msg *cmd_msg, bool last_command,
+		u32 post_wait_ms)
+{
+	struct mipi_dsi_msg msg = *cmd_msg;
+
+	if (set->state == DSI_CMD_SET_STATE_LP)
+		msg.flags |= MIPI_DSI_MSG_USE_LPM;
+
+	if (last_command)
+		msg.flags |= MIPI_DSI_MSG_LASTCOMMAND;
+
+	ctrl->wait_ms += post_wait_ms;
+	return replay_tx(ctrl, &msg);
+}
+
+/* dsi_panel_tx_cmd_set and dsi_panel_tx_cmd_batch */
+static int replay_tx_set(struct replay_ctrl *ctrl,
+		const struct dsi_panel_cmd_set *set, bool packed)
+{
+	const struct dsi_cmd_desc *cmd, *first, *last;
+	const struct dsi_cmd_batch *batch;
+	struct mipi_dsi_msg msg;
+	int rc = 0;
+	u32 i;
+
+	if (packed && set->batch_count) {
+		for (i = 0; i < set->batch_count && !rc; i++) {
+			batch = &set->batches[i];
+			first = &set->cmds[batch->first];
+			if (!batch->count) {
+				rc = replay_tx_msg(ctrl, set, &first->msg,
+						first->last_command,
+						first->post_wait_ms);
+				continue;
+			}
+
+			last = first + batch->count - 1;
+			msg = (struct mipi_dsi_msg) {
+				.channel = last->msg.channel,
+				.type = last->msg.type,
+				.flags = first->msg.flags | MIPI_DSI_MSG_PACKED,
+				.ctrl = first->msg.ctrl,
+				.wait_ms = last->msg.wait_ms,
+				.tx_len = batch->len,
+				.tx_buf = set->packed_buf + batch->offset,
+			};
+			rc = replay_tx_msg(ctrl, set, &msg, last->last_command,
+					last->post_wait_ms);
+		}
+		return rc;
+	}
+
+	for (i = 0; i < set->count && !rc; i++) {
+		cmd = &set->cmds[i];
+		rc = replay_tx_msg(ctrl, set, &cmd->msg, cmd->last_command,
+				cmd->post_wait_ms);
+	}
+
+	return rc;
+}
+
+/*
+ * Transmit the set once with the kicked off bytes recorded, then time the
+ * given number of transmissions. Bytes left staged at the end of the set
+ * are added to the recorded bytes, the driver sends them with the next set.
+ */
+static int replay_run(struct replay_ctrl *ctrl,
+		const struct dsi_panel_cmd_set *set, bool packed, double *ns)
+{
+	struct replay_ctrl once;
+	unsigned long long t0;
+	u32 r;
+	int rc;
+
+	ctrl->record = true;
+	rc = replay_tx_set(ctrl, set, packed);
+	if (!rc && ctrl->cmd_len) {
+		rc = replay_reserve(&ctrl->out, &ctrl->out_size,
+				ctrl->out_len + ctrl->cmd_len);
+		if (!rc) {
+			memcpy(ctrl->out + ctrl->out_len, ctrl->cmd_buf,
+					ctrl->cmd_len);
+			ctrl->out_len += ctrl->cmd_len;
+		}
+	}
+	ctrl->record = false;
+	if (rc)
+		return rc;
+
+	once = *ctrl;
+	t0 = test_now_ns();
+	for (r = 0; r < replay_rounds && !rc; r++) {
+		ctrl->cmd_len = 0;
+		rc = replay_tx_set(ctrl, set, packed);
+	}
+	*ns = (double)(test_now_ns() - t0) / replay_rounds;
+
+	/* report the counts of a single transmission */
+	ctrl->kickoffs = once.kickoffs;
+	ctrl->link_ns = once.link_ns;
+	ctrl->wait_ms = once.wait_ms;
+
+	return rc;
+}
+
+static void replay_ctrl_free(struct replay_ctrl *ctrl)
+{
+	free(ctrl->cmd_buf);
+	free(ctrl->pad_buf);
+	free(ctrl->out);
+}
+
+/* dsi_panel_parse_cmd_sets_sub without the DT lookups */
+static int replay_build(struct dsi_panel_cmd_set *set,
+		enum dsi_cmd_set_type type, enum dsi_cmd_set_state state,
+		const char *data, u32 length)
+{
+	u32 count = 0;
+	int rc;
+
+	memset(set, 0, sizeof(*set));
+	set->type = type;
+	set->state = state;
+
+	rc = dsi_panel_get_cmd_pkt_count(data, length, &count);
+	if (rc)
+		return rc;
+
+	rc = dsi_panel_alloc_cmd_packets(set, count);
+	if (rc)
+		return rc;
+
+	rc = dsi_panel_create_cmd_packets(data, length, count, set->cmds);
+	if (rc) {
+		kfree(set->cmds);
+		set->cmds = NULL;
+		set->count = 0;
+	}
+
+	return rc;
+}
+
+static void replay_free(struct dsi_panel_cmd_set *set)
+{
+	dsi_panel_destroy_cmd_packets(set);
+	dsi_panel_dealloc_cmd_packets(set);
+	memset(set, 0, sizeof(*set));
+}
+
+static int replay_set(const struct replay_prop *prop,
+		enum dsi_cmd_set_state state, const char *data, u32 length,
+		struct replay_total *total)
+{
+	struct replay_ctrl ctrl = { 0 }, ctrl_pk = { 0 };
+	struct dsi_panel_cmd_set set = { 0 };
+	unsigned long long t0, t_parse = 0, t_pack = 0;
+	double tx_ns, tx_pk_ns;
+	const char *name;
+	u32 r;
+	int rc;
+
+	for (r = 0; r < replay_rounds; r++) {
+		t0 = test_now_ns();
+		rc = replay_build(&set, prop->type, state, data, length);
+		t_parse += test_now_ns() - t0;
+		if (rc)
+			return rc;
+
+		t0 = test_now_ns();
+		rc = dsi_panel_pack_cmd_set(&set);
+		t_pack += test_now_ns() - t0;
+		if (r + 1 < replay_rounds || rc)
+			replay_free(&set);
+		if (rc)
+			return rc;
+	}
+
+	rc = replay_run(&ctrl, &set, false, &tx_ns);
+	if (!rc)
+		rc = replay_run(&ctrl_pk, &set, true, &tx_pk_ns);
+	if (rc)
+		goto out;
+
+	if (ctrl.out_len != ctrl_pk.out_len ||
+			ctrl.kickoffs != ctrl_pk.kickoffs ||
+			memcmp(ctrl.out, ctrl_pk.out, ctrl.out_len)) {
+		fprintf(stderr, "line %u: packed %s differs from unpacked\n",
+				prop->line, cmd_set_prop_map[prop->type]);
+		rc = -EINVAL;
+		goto out;
+	}
+
+	name = cmd_set_prop_map[prop->type];
+	if (!strncmp(name, "qcom,", strlen("qcom,")))
+		name += strlen("qcom,");
+
+	printf("%-20.20s %-34.34s %2s %4u %5u %4u %5u %8.0f %8.0f %8.0f %8.0f %8llu %7u\n",
+			prop->node, name,
+			state == DSI_CMD_SET_STATE_LP ? "lp" : "hs",
+			set.count, length, set.batch_count, ctrl.kickoffs,
+			(double)t_parse / replay_rounds,
+			(double)t_pack / replay_rounds, tx_ns, tx_pk_ns,
+			ctrl.link_ns, ctrl.wait_ms);
+
+	if (ctrl.cmd_len)
+		printf("%-20.20s %u bytes left staged without a last command\n",
+				"", ctrl.cmd_len);
+
+	total->sets++;
+	total->cmds += set.count;
+	total->bytes += length;
+	total->parse_ns += (double)t_parse / replay_rounds;
+	total->pack_ns += (double)t_pack / replay_rounds;
+	total->tx_ns += tx_ns;
+	total->tx_pk_ns += tx_pk_ns;
+	total->wait_ms += ctrl.wait_ms;
+out:
+	replay_ctrl_free(&ctrl);
+	replay_ctrl_free(&ctrl_pk);
+	replay_free(&set);
+	return rc;
+}
+
+/* a DT byte string, "[ 05 01 00 ... ]" */
+static int replay_parse_bytes(const struct replay_prop *prop, char **data,
+		u32 *length)
+{
+	const char *s = prop->value, *end = prop->value + prop->len;
+	char *buf;
+	u32 len = 0, nibbles = 0;
+	int v;
+
+	if (s == end || *s != '[' || end[-1] != ']')
+		goto error;
+
+	buf = malloc(prop->len / 2 + 1);
+	if (!buf)
+		return -ENOMEM;
+
+	for (s++, end--; s < end; s++) {
+		if (isspace((unsigned char)*s))
+			continue;
+		if (!isxdigit((unsigned char)*s)) {
+			free(buf);
+			goto error;
+		}
+
+		v = isdigit((unsigned char)*s) ? *s - '0' : tolower(*s) - 'a' + 10;
+		if (nibbles++ & 1)
+			buf[len++] |= v;
+		else
+			buf[len] = v << 4;
+	}
+
+	if (nibbles & 1) {
+		free(buf);
+		goto error;
+	}
+
+	*data = buf;
+	*length = len;
+	return 0;
+error:
+	fprintf(stderr, "line %u: %s is not a byte string\n", prop->line,
+			cmd_set_prop_map[prop->type]);
+	return -EINVAL;
+}
+
+/* the state property of the set in the same node, lp mode if there is none */
+static int replay_parse_state(const struct replay_prop *props, u32 count,
+		const struct replay_prop *prop, enum dsi_cmd_set_state *state)
+{
+	const struct replay_prop *p;
+	u32 i;
+
+	*state = DSI_CMD_SET_STATE_LP;
+	for (i = 0; i < count; i++) {
+		p = &props[i];
+		if (!p->is_state || p->node_id != prop->node_id ||
+				p->type != prop->type)
+			continue;
+
+		if (p->len == strlen("\"dsi_hs_mode\"") &&
+				!strncmp(p->value, "\"dsi_hs_mode\"", p->len)) {
+			*state = DSI_CMD_SET_STATE_HS;
+		} else if (p->len != strlen("\"dsi_lp_mode\"") ||
+				strncmp(p->value, "\"dsi_lp_mode\"", p->len)) {
+			fprintf(stderr, "line %u: %s unrecognized\n", p->line,
+					cmd_set_state_map[p->type]);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+static u32 replay_line(const char *buf, const char *p)
+{
+	u32 line = 1;
+
+	for (; buf < p; buf++)
+		line += *buf == '\n';
+
+	return line;
+}
+
+static char *replay_skip(char *p)
+{
+	char *q;
+
+	for (;;) {
+		while (isspace((unsigned char)*p))
+			p++;
+
+		if (p[0] == '/' && p[1] == '/') {
+			p = strchrnul(p, '\n');
+		} else if (p[0] == '/' && p[1] == '*') {
+			q = strstr(p + 2, "*/");
+			p = q ? q + 2 : p + strlen(p);
+		} else if (!strncmp(p, "#include", strlen("#include")) ||
+				!strncmp(p, "#define", strlen("#define"))) {
+			p = strchrnul(p, '\n');
+		} else {
+			return p;
+		}
+	}
+}
+
+static bool replay_name_char(char c)
+{
+	return c && (isalnum((unsigned char)c) || strchr(",._+-@#&/", c));
+}
+
+static int replay_add_prop(struct replay_prop **props, u32 *count,
+		const char *name, u32 name_len, const char *node, u32 node_id,
+		const char *value, u32 len, u32 line)
+{
+	struct replay_prop *prop;
+	bool is_state;
+	u32 i;
+
+	for (i = 0; i < DSI_CMD_SET_MAX; i++) {
+		if (strlen(cmd_set_prop_map[i]) == name_len &&
+				!strncmp(cmd_set_prop_map[i], name, name_len)) {
+			is_state = false;
+			break;
+		}
+		if (strlen(cmd_set_state_map[i]) == name_len &&
+				!strncmp(cmd_set_state_map[i], name, name_len)) {
+			is_state = true;
+			break;
+		}
+	}
+
+	if (i == DSI_CMD_SET_MAX)
+		return 0;
+
+	prop = realloc(*props, (*count + 1) * sizeof(*prop));
+	if (!prop)
+		return -ENOMEM;
+
+	*props = prop;
+	prop += (*count)++;
+	snprintf(prop->node, sizeof(prop->node), "%s", node);
+	prop->node_id = node_id;
+	prop->type = i;
+	prop->is_state = is_state;
+	prop->value = value;
+	prop->len = len;
+	prop->line = line;
+
+	return 0;
+}
+
+/*
+ * Collect the command set properties of a device tree source. Only the
+ * structure of the source is followed, labels, references and directives
+ * are skipped and the values of other properties are not looked at.
+ */
+static int replay_parse_dts(char *buf, struct replay_prop **props,
+		u32 *count)
+{
+	char nodes[REPLAY_MAX_DEPTH][REPLAY_NAME_LEN];
+	u32 ids[REPLAY_MAX_DEPTH];
+	u32 depth = 0, node_ids = 0, len;
+	char *p = buf, *name, *q;
+	int rc;
+
+	while (*(p = replay_skip(p))) {
+		if (*p == '}') {
+			if (!depth)
+				goto error;
+			depth--;
+			p = replay_skip(p + 1);
+			if (*p == ';')
+				p++;
+			continue;
+		}
+
+		name = p;
+		while (replay_name_char(*p))
+			p++;
+		len = p - name;
+		if (!len)
+			goto error;
+
+		p = replay_skip(p);
+
+		/* directives such as /delete-node/ run up to their semicolon */
+		if (len > 1 && name[0] == '/' && name[len - 1] == '/') {
+			p = strchrnul(p, ';');
+			if (*p)
+				p++;
+			continue;
+		}
+
+		if (*p == ':' || *p == ';') {
+			p++;
+			continue;
+		}
+
+		if (*p == '{') {
+			if (depth == REPLAY_MAX_DEPTH)
+				goto error;
+			snprintf(nodes[depth], sizeof(nodes[depth]), "%.*s",
+					(int)len, name);
+			ids[depth++] = ++node_ids;
+			p++;
+			continue;
+		}
+
+		if (*p != '=' || !depth)
+			goto error;
+
+		p = replay_skip(p + 1);
+		for (q = p; *q && *q != ';'; q++) {
+			if (*q == '"' && !(q = strchr(q + 1, '"')))
+				goto error;
+		}
+		if (!*q)
+			goto error;
+
+		while (q > p && isspace((unsigned char)q[-1]))
+			q--;
+
+		rc = replay_add_prop(props, count, name, len,
+				nodes[depth - 1], ids[depth - 1], p, q - p,
+				replay_line(buf, name));
+		if (rc)
+			return rc;
+
+		p = strchr(q, ';') + 1;
+	}
+
+	return 0;
+error:
+	fprintf(stderr, "line %u: cannot parse the source\n",
+			replay_line(buf, p));
+	return -EINVAL;
+}
+
+static char *replay_read(const char *path)
+{
+	char *buf = NULL;
+	size_t len = 0, n;
+	FILE *f;
+
+	f = fopen(path, "r");
+	if (!f)
+		return NULL;
+
+	do {
+		char *new_buf = realloc(buf, len + 4096 + 1);
+
+		if (!new_buf) {
+			free(buf);
+			fclose(f);
+			return NULL;
+		}
+		buf = new_buf;
+		n = fread(buf + len, 1, 4096, f);
+		len += n;
+	} while (n == 4096);
+
+	buf[len] = '\0';
+	fclose(f);
+	return buf;
+}
+
+static int replay_file(const char *path, struct replay_total *total)
+{
+	struct replay_prop *props = NULL, *prop;
+	enum dsi_cmd_set_state state;
+	u32 count = 0, length, i;
+	char *buf, *data;
+	int rc;
+
+	buf = replay_read(path);
+	if (!buf) {
+		fprintf(stderr, "%s: cannot read\n", path);
+		return -EIO;
+	}
+
+	printf("%s\n%-20s %-34s %2s %4s %5s %4s %5s %8s %8s %8s %8s %8s %7s\n",
+			path, "node", "cmd set", "st", "cmds", "bytes", "runs",
+			"kicks", "parse", "pack", "tx", "tx_pk", "link",
+			"wait_ms");
+	rc = replay_parse_dts(buf, &props, &count);
+
+	for (i = 0; i < count && !rc; i++) {
+		prop = &props[i];
+		if (prop->is_state)
+			continue;
+
+		rc = replay_parse_state(props, count, prop, &state);
+		if (!rc)
+			rc = replay_parse_bytes(prop, &data, &length);
+		if (rc)
+			break;
+
+		rc = replay_set(prop, state, data, length, total);
+		if (rc)
+			fprintf(stderr, "line %u: %s failed, rc=%d\n",
+					prop->line, cmd_set_prop_map[prop->type],
+					rc);
+		free(data);
+	}
+
+	if (rc)
+		fprintf(stderr, "%s: replay failed\n", path);
+
+	free(props);
+	free(buf);
+	return rc;
+}
+
+static void replay_usage(const char *prog)
+{
+	fprintf(stderr, "usage: %s [-n rounds] [-l lanes] [-r lane_mbps] <dts>...\n",
+			prog);
+}
+
+int main(int argc, char **argv)
+{
+	struct replay_total total = { 0 };
+	int opt, i, rc = 0;
+
+	while ((opt = getopt(argc, argv, "n:l:r:")) != -1) {
+		switch (opt) {
+		case 'n':
+			replay_rounds = strtoul(optarg, NULL, 0);
+			break;
+		case 'l':
+			replay_lanes = strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			replay_lane_mbps = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			replay_usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (optind == argc || !replay_rounds || !replay_lanes ||
+			!replay_lane_mbps || replay_lanes > 4) {
+		replay_usage(argv[0]);
+		return 1;
+	}
+
+	printf("times in ns per set over %u rounds, link at %u x %u Mbps hs, %u Mbps lp\n",
+			replay_rounds, replay_lanes, replay_lane_mbps,
+			REPLAY_LP_MBPS);
+
+	for (i = optind; i < argc; i++)
+		if (replay_file(argv[i], &total))
+			rc = 1;
+
+	if (!total.sets)
+		return rc;
+
+	printf("%u sets, %u cmds, %u bytes: parse %.1f MB/s, pack %.1f MB/s, tx %.1f MB/s, tx packed %.1f MB/s, %u ms of waits\n",
+			total.sets, total.cmds, total.bytes,
+			total.bytes * 1000.0 / total.parse_ns,
+			total.bytes * 1000.0 / total.pack_ns,
+			total.bytes * 1000.0 / total.tx_ns,
+			total.bytes * 1000.0 / total.tx_pk_ns,
+			total.wait_ms);
+
+	return rc;
+}
@@ -0,0 +1,29 @@
+#!/bin/sh
+# SPDX-License-Identifier: GPL-2.0-only
+#
+# Print the definitions of a source file whose first line matches an
+# extended regular expression, in file order. A definition ends at the
+# first line starting with a closing brace, a #define is a single line.
+#
+# usage: extract_blocks.sh <source file> <regex>
+
+src="$1"
+re="$2"
+
+echo "/* generated by extract_blocks.sh from $src, do not edit */"
+awk -v re="$re" '
+!copy && $0 ~ re {
+	if ($0 ~ /^#define/) {
+		print
+		next
+	}
+	copy = 1
+}
+copy {
+	print
+}
+copy && /^}/ {
+	copy = 0
+	print ""
+}
+' "$src"
@@ -0,0 +1,42 @@
+#!/bin/sh
+# SPDX-License-Identifier: GPL-2.0-only
+#
+# Print the pixel format of every entry of the format tables of a source
+# file as a u32 array per table, in table order. The format is the first
+# argument of the entry macro, with an optional prefix prepended.
+#
+# usage: format_tables.sh <struct type> <source file> [prefix]
+
+type="$1"
+src="$2"
+prefix="$3"
+
+echo "/* generated by format_tables.sh from $src, do not edit */"
+awk -v type="$type" -v prefix="$prefix" '
+$0 ~ "^static (const )?struct " type " [a-z0-9_]+\\[\\] = {" {
+	name = $0
+	sub(/\[\].*/, "", name)
+	sub(/.* /, "", name)
+	printf "static const u32 %s[] = {\n", name
+	want = 0
+	next
+}
+name && /^};/ {
+	print "};"
+	name = ""
+	next
+}
+name && /(^|[^A-Za-z0-9_])[A-Z0-9_]*FMT[A-Z0-9_]*\(/ {
+	want = 1
+	sub(/.*(^|[^A-Za-z0-9_])[A-Z0-9_]*FMT[A-Z0-9_]*\(/, "")
+}
+name && want && /[A-Za-z0-9_]/ {
+	tok = $0
+	sub(/^[ \t]*/, "", tok)
+	sub(/[^A-Za-z0-9_].*/, "", tok)
+	if (tok == "")
+		next
+	printf "\t%s%s,\n", prefix, tok
+	want = 0
+}
+' "$src"
@@ -0,0 +1,78 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * Host stand-in for the subset of include/uapi/drm/drm_fourcc.h used by the
+ * sde format tables, with the same values.
+ */
+
+#ifndef _TOOLS_DRM_FOURCC_H_
+#define _TOOLS_DRM_FOURCC_H_
+
+#define fourcc_code(a, b, c, d) ((__u32)(a) | ((__u32)(b) << 8) | \
+				 ((__u32)(c) << 16) | ((__u32)(d) << 24))
+
+/* 16 bpp RGB */
+#define DRM_FORMAT_XRGB4444	fourcc_code('X', 'R', '1', '2')
+#define DRM_FORMAT_XBGR4444	fourcc_code('X', 'B', '1', '2')
+#define DRM_FORMAT_RGBX4444	fourcc_code('R', 'X', '1', '2')
+#define DRM_FORMAT_BGRX4444	fourcc_code('B', 'X', '1', '2')
+
+#define DRM_FORMAT_ARGB4444	fourcc_code('A', 'R', '1', '2')
+#define DRM_FORMAT_ABGR4444	fourcc_code('A', 'B', '1', '2')
+#define DRM_FORMAT_RGBA4444	fourcc_code('R', 'A', '1', '2')
+#define DRM_FORMAT_BGRA4444	fourcc_code('B', 'A', '1', '2')
+
+#define DRM_FORMAT_XRGB1555	fourcc_code('X', 'R', '1', '5')
+#define DRM_FORMAT_XBGR1555	fourcc_code('X', 'B', '1', '5')
+#define DRM_FORMAT_RGBX5551	fourcc_code('R', 'X', '1', '5')
+#define DRM_FORMAT_BGRX5551	fourcc_code('B', 'X', '1', '5')
+
+#define DRM_FORMAT_ARGB1555	fourcc_code('A', 'R', '1', '5')
+#define DRM_FORMAT_ABGR1555	fourcc_code('A', 'B', '1', '5')
+#define DRM_FORMAT_RGBA5551	fourcc_code('R', 'A', '1', '5')
+#define DRM_FORMAT_BGRA5551	fourcc_code('B', 'A', '1', '5')
+
+#define DRM_FORMAT_RGB565	fourcc_code('R', 'G', '1', '6')
+#define DRM_FORMAT_BGR565	fourcc_code('B', 'G', '1', '6')
+
+/* 24 bpp RGB */
+#define DRM_FORMAT_RGB888	fourcc_code('R', 'G', '2', '4')
+#define DRM_FORMAT_BGR888	fourcc_code('B', 'G', '2', '4')
+
+/* 32 bpp RGB */
+#define DRM_FORMAT_XRGB8888	fourcc_code('X', 'R', '2', '4')
+#define DRM_FORMAT_XBGR8888	fourcc_code('X', 'B', '2', '4')
+#define DRM_FORMAT_RGBX8888	fourcc_code('R', 'X', '2', '4')
+#define DRM_FORMAT_BGRX8888	fourcc_code('B', 'X', '2', '4')
+
+#define DRM_FORMAT_ARGB8888	fourcc_code('A', 'R', '2', '4')
+#define DRM_FORMAT_ABGR8888	fourcc_code('A', 'B', '2', '4')
+#define DRM_FORMAT_RGBA8888	fourcc_code('R', 'A', '2', '4')
+#define DRM_FORMAT_BGRA8888	fourcc_code('B', 'A', '2', '4')
+
+#define DRM_FORMAT_XRGB2101010	fourcc_code('X', 'R', '3', '0')
+#define DRM_FORMAT_XBGR2101010	fourcc_code('X', 'B', '3', '0')
+#define DRM_FORMAT_RGBX1010102	fourcc_code('R', 'X', '3', '0')
+#define DRM_FORMAT_BGRX1010102	fourcc_code('B', 'X', '3', '0')
+
+#define DRM_FORMAT_ARGB2101010	fourcc_code('A', 'R', '3', '0')
+#define DRM_FORMAT_ABGR2101010	fourcc_code('A', 'B', '3', '0')
+#define DRM_FORMAT_RGBA1010102	fourcc_code('R', 'A', '3', '0')
+#define DRM_FORMAT_BGRA1010102	fourcc_code('B', 'A', '3', '0')
+
+/* packed YCbCr */
+#define DRM_FORMAT_YUYV		fourcc_code('Y', 'U', 'Y', 'V')
+#define DRM_FORMAT_YVYU		fourcc_code('Y', 'V', 'Y', 'U')
+#define DRM_FORMAT_UYVY		fourcc_code('U', 'Y', 'V', 'Y')
+#define DRM_FORMAT_VYUY		fourcc_code('V', 'Y', 'U', 'Y')
+
+/* 2 plane YCbCr */
+#define DRM_FORMAT_NV12		fourcc_code('N', 'V', '1', '2')
+#define DRM_FORMAT_NV21		fourcc_code('N', 'V', '2', '1')
+#define DRM_FORMAT_NV16		fourcc_code('N', 'V', '1', '6')
+#define DRM_FORMAT_NV61		fourcc_code('N', 'V', '6', '1')
+
+/* 3 plane YCbCr */
+#define DRM_FORMAT_YUV420	fourcc_code('Y', 'U', '1', '2')
+#define DRM_FORMAT_YVU420	fourcc_code('Y', 'V', '1', '2')
+
+#endif /* _TOOLS_DRM_FOURCC_H_ */
@@ -0,0 +1,224 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2021, The Linux Foundation. All rights reserved.
+ */
+
+/*
+ * Host test of the format lookup table. The pixel formats of the sde and
+ * rotator format tables are extracted from the driver sources at build
+ * time, in table order, and every lookup through the hash is checked
+ * against the linear scan the driver used before. A small benchmark of
+ * both lookups is printed at the end.
+ *
+ * The scan here walks dense u32 arrays while the driver walks the format
+ * structures, so the printed scan times are a lower bound.
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <linux/types.h>
+
+#include "sde_format_lut.h"
+
+typedef uint8_t u8;
+#define BIT(n)		(1u << (n))
+#define ARRAY_SIZE(a)	(sizeof(a) / sizeof((a)[0]))
+
+#include <drm/drm_fourcc.h>
+#include "sde_rotator_formats.h"
+
+#include "sde_format_tables.h"
+#include "sde_rotator_format_tables.h"
+
+#include "tools_test.h"
+
+#define BENCH_ROUNDS	20000
+
+struct test_class {
+	const char *name;
+	const u32 *map;
+	u32 size;
+};
+
+#define TEST_CLASS(m)	{ #m, m, ARRAY_SIZE(m) }
+
+/* same order as enum sde_format_class in sde_formats.c */
+static const struct test_class sde_classes[] = {
+	TEST_CLASS(sde_format_map),
+	TEST_CLASS(sde_format_map_ubwc),
+	TEST_CLASS(sde_format_map_p010),
+	TEST_CLASS(sde_format_map_p010_ubwc),
+	TEST_CLASS(sde_format_map_tp10_ubwc),
+	TEST_CLASS(sde_format_map_tile),
+	TEST_CLASS(sde_format_map_p010_tile),
+	TEST_CLASS(sde_format_map_tp10_tile),
+};
+
+/* SDE_ROT_FORMAT_CLASS_MAP and SDE_ROT_FORMAT_CLASS_UBWC */
+static const struct test_class rot_classes[] = {
+	TEST_CLASS(sde_mdp_format_map),
+	TEST_CLASS(sde_mdp_format_ubwc_map),
+};
+
+static struct sde_format_lut sde_lut, rot_lut;
+
+static int scan(const struct test_class *c, u32 fourcc)
+{
+	u32 i;
+
+	for (i = 0; i < c->size; i++)
+		if (c->map[i] == fourcc)
+			return i;
+
+	return -ENOENT;
+}
+
+static void fill(struct sde_format_lut *lut, const struct test_class *classes,
+		u32 count)
+{
+	const struct test_class *c;
+	u32 class, i;
+	int rc;
+
+	for (class = 0; class < count; class++) {
+		c = &classes[class];
+		TEST_EXPECT(c->size > 0);
+
+		for (i = 0; i < c->size; i++) {
+			rc = sde_format_lut_insert(lut, c->map[i], class, i);
+			/* only a repeated format may be refused */
+			if (rc == -EEXIST)
+				TEST_EXPECT(scan(c, c->map[i]) < (int)i);
+			else
+				TEST_EXPECT_EQ(rc, 0);
+		}
+	}
+
+	TEST_EXPECT(lut->count <= SDE_FORMAT_LUT_SIZE / 2);
+}
+
+/* every format of every table, looked up in every class */
+static void check(const struct sde_format_lut *lut,
+		const struct test_class *classes, u32 count,
+		const struct test_class *all, u32 all_count)
+{
+	static const u32 unknown[] = {
+		0, 0xffffffff, fourcc_code('Z', 'Z', 'Z', 'Z'),
+	};
+	u32 class, t, i;
+	int idx, want;
+
+	for (class = 0; class < count; class++) {
+		for (t = 0; t < all_count; t++) {
+			for (i = 0; i < all[t].size; i++) {
+				idx = sde_format_lut_find(lut, all[t].map[i],
+						class);
+				want = scan(&classes[class], all[t].map[i]);
+				if (idx != want)
+					fprintf(stderr, "%s: %4.4s of %s\n",
+						classes[class].name,
+						(char *)&all[t].map[i],
+						all[t].name);
+				TEST_EXPECT_EQ(idx, want);
+			}
+		}
+
+		for (i = 0; i < ARRAY_SIZE(unknown); i++)
+			TEST_EXPECT_EQ(sde_format_lut_find(lut, unknown[i],
+					class), -ENOENT);
+	}
+}
+
+static void test_tables(void)
+{
+	struct test_class all[ARRAY_SIZE(sde_classes) +
+			ARRAY_SIZE(rot_classes)];
+
+	memcpy(all, sde_classes, sizeof(sde_classes));
+	memcpy(all + ARRAY_SIZE(sde_classes), rot_classes,
+			sizeof(rot_classes));
+
+	fill(&sde_lut, sde_classes, ARRAY_SIZE(sde_classes));
+	fill(&rot_lut, rot_classes, ARRAY_SIZE(rot_classes));
+
+	check(&sde_lut, sde_classes, ARRAY_SIZE(sde_classes),
+			all, ARRAY_SIZE(all));
+	check(&rot_lut, rot_classes, ARRAY_SIZE(rot_classes),
+			all, ARRAY_SIZE(all));
+
+	printf("sde: %u formats hashed, rotator: %u formats hashed, %u slots\n",
+			sde_lut.count, rot_lut.count, SDE_FORMAT_LUT_SIZE);
+}
+
+static void test_lut(void)
+{
+	static struct sde_format_lut lut;
+	u32 i;
+
+	TEST_EXPECT_EQ(sde_format_lut_insert(NULL, 1, 0, 0), -EINVAL);
+	TEST_EXPECT_EQ(sde_format_lut_insert(&lut, 0, 0, 0), -EINVAL);
+	TEST_EXPECT_EQ(sde_format_lut_insert(&lut, 1, 0x10000, 0), -EINVAL);
+	TEST_EXPECT_EQ(sde_format_lut_find(NULL, 1, 0), -ENOENT);
+
+	/* the class keeps the same format of two tables apart */
+	TEST_EXPECT_EQ(sde_format_lut_insert(&lut, DRM_FORMAT_NV12, 0, 3), 0);
+	TEST_EXPECT_EQ(sde_format_lut_insert(&lut, DRM_FORMAT_NV12, 1, 5), 0);
+	TEST_EXPECT_EQ(sde_format_lut_insert(&lut, DRM_FORMAT_NV12, 1, 7),
+			-EEXIST);
+	TEST_EXPECT_EQ(sde_format_lut_find(&lut, DRM_FORMAT_NV12, 0), 3);
+	TEST_EXPECT_EQ(sde_format_lut_find(&lut, DRM_FORMAT_NV12, 1), 5);
+	TEST_EXPECT_EQ(sde_format_lut_find(&lut, DRM_FORMAT_NV12, 2), -ENOENT);
+
+	/* a full table still terminates its probes */
+	memset(&lut, 0, sizeof(lut));
+	for (i = 0; i < SDE_FORMAT_LUT_SIZE; i++)
+		TEST_EXPECT_EQ(sde_format_lut_insert(&lut, i + 1, 0, i), 0);
+	TEST_EXPECT_EQ(sde_format_lut_insert(&lut, i + 1, 0, i), -ENOSPC);
+	for (i = 0; i < SDE_FORMAT_LUT_SIZE; i++)
+		TEST_EXPECT_EQ(sde_format_lut_find(&lut, i + 1, 0), i);
+	TEST_EXPECT_EQ(sde_format_lut_find(&lut, i + 1, 0), -ENOENT);
+}
+
+static void bench(const char *name, const struct sde_format_lut *lut,
+		const struct test_class *classes, u32 count)
+{
+	unsigned long long t0, t_lut, t_scan, n = 0;
+	volatile int sink = 0;
+	u32 r, class, i;
+
+	t0 = test_now_ns();
+	for (r = 0; r < BENCH_ROUNDS; r++)
+		for (class = 0; class < count; class++)
+			for (i = 0; i < classes[class].size; i++, n++)
+				sink += sde_format_lut_find(lut,
+						classes[class].map[i], class);
+	t_lut = test_now_ns() - t0;
+
+	t0 = test_now_ns();
+	for (r = 0; r < BENCH_ROUNDS; r++)
+		for (class = 0; class < count; class++)
+			for (i = 0; i < classes[class].size; i++)
+				sink += scan(&classes[class],
+						classes[class].map[i]);
+	t_scan = test_now_ns() - t0;
+
+	(void)sink;
+	printf("%s: %llu lookups, hash %.1f ns, scan %.1f ns per lookup\n",
+			name, n, (double)t_lut / n, (double)t_scan / n);
+}
+
+int main(void)
+{
+	test_lut();
+	test_tables();
+
+	if (!test_failures) {
+		bench("sde", &sde_lut, sde_classes, ARRAY_SIZE(sde_classes));
+		bench("rotator", &rot_lut, rot_classes,
+				ARRAY_SIZE(rot_classes));
+	}
+
+	return test_report("sde_format_lut_test");
+}
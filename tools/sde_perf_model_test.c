@@ -0,0 +1,214 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2021, The Linux Foundation. All rights reserved.
+ */
+
+/*
+ * Host test of the sde perf model. The expected values are worked out by
+ * hand from a 1080p60 timing with 1125 total lines, a line rate of 67500
+ * lines per second.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "sde_perf_model.h"
+#include "tools_test.h"
+
+#define FOURCC(a, b, c, d) \
+	((u32)(a) | ((u32)(b) << 8) | ((u32)(c) << 16) | ((u32)(d) << 24))
+
+static const struct sde_perf_model_cfg test_cfg = {
+	.core_ib_ff = 1000,
+	.core_clk_ff = 1100,
+	.xtra_prefill_lines = 2,
+	.dest_scale_prefill_lines = 3,
+	.macrotile_prefill_lines = 8,
+	.yuv_nv12_prefill_lines = 4,
+	.linear_prefill_lines = 2,
+	.downscaling_prefill_lines = 5,
+	.max_bw = 1000000000ull,
+	.min_ib = { 0, 0, 600000000ull },
+	.max_core_clk_rate = 460000000ull,
+};
+
+static const struct sde_perf_model_timing test_1080p = {
+	.width = 1920,
+	.height = 1080,
+	.vtotal = 1125,
+	.fps = 60,
+	.num_mixers = 1,
+};
+
+/* full screen linear argb, 7680 bytes per line */
+static const struct sde_perf_model_plane test_linear = {
+	.src_w = 1920, .src_h = 1080, .dst_w = 1920, .dst_h = 1080,
+	.bpp = 4000,
+};
+
+/* 4k ubwc argb at 2:1 downscaled to full screen, also 7680 bytes per line */
+static const struct sde_perf_model_plane test_ubwc_down = {
+	.src_w = 3840, .src_h = 2160, .dst_w = 1920, .dst_h = 1080,
+	.bpp = 4000, .comp_ratio = 2000, .tiled = true,
+};
+
+static void test_invalid(void)
+{
+	struct sde_perf_model_result res;
+	struct sde_perf_model_timing timing = test_1080p;
+	struct sde_perf_model_plane plane = test_linear;
+
+	TEST_EXPECT_EQ(sde_perf_model_calc(NULL, &timing, &plane, 1, &res),
+			-EINVAL);
+	TEST_EXPECT_EQ(sde_perf_model_calc(&test_cfg, &timing, NULL, 1, &res),
+			-EINVAL);
+	TEST_EXPECT_EQ(sde_perf_model_calc(&test_cfg, &timing, &plane,
+			SDE_PERF_MODEL_MAX_PLANES + 1, &res), -EINVAL);
+
+	timing.vtotal = timing.height - 1;
+	TEST_EXPECT_EQ(sde_perf_model_calc(&test_cfg, &timing, &plane, 1,
+			&res), -EINVAL);
+
+	timing = test_1080p;
+	timing.fps = 0;
+	TEST_EXPECT_EQ(sde_perf_model_calc(&test_cfg, &timing, &plane, 1,
+			&res), -EINVAL);
+
+	plane.bpp = 0;
+	TEST_EXPECT_EQ(sde_perf_model_calc(&test_cfg, &test_1080p, &plane, 1,
+			&res), -EINVAL);
+}
+
+static void test_linear_plane(void)
+{
+	struct sde_perf_model_result res;
+
+	memset(&res, 0, sizeof(res));
+	TEST_EXPECT_EQ(sde_perf_model_calc(&test_cfg, &test_1080p,
+			&test_linear, 1, &res), 0);
+
+	/* 7680 bytes x 1080 lines x 60 fps */
+	TEST_EXPECT_EQ(res.pipe[0].ab, 497664000);
+	/* 7680 bytes x 67500 lines per second */
+	TEST_EXPECT_EQ(res.pipe[0].ib, 518400000);
+	TEST_EXPECT_EQ(res.pipe[0].prefill_lines, 4);
+	TEST_EXPECT_EQ(res.pipe[0].clk, 129600000);
+
+	TEST_EXPECT_EQ(res.ab[SDE_PERF_MODEL_BUS_MNOC], 497664000);
+	TEST_EXPECT_EQ(res.ib[SDE_PERF_MODEL_BUS_MNOC], 518400000);
+	TEST_EXPECT_EQ(res.ib[SDE_PERF_MODEL_BUS_LLCC], 518400000);
+	/* raised to the bus floor */
+	TEST_EXPECT_EQ(res.ib[SDE_PERF_MODEL_BUS_EBI], 600000000);
+	TEST_EXPECT_EQ(res.core_clk, 142560000);
+	TEST_EXPECT(res.bw_fits);
+	TEST_EXPECT(res.clk_fits);
+}
+
+static void test_ubwc_downscale(void)
+{
+	struct sde_perf_model_result res;
+
+	TEST_EXPECT_EQ(sde_perf_model_calc(&test_cfg, &test_1080p,
+			&test_ubwc_down, 1, &res), 0);
+
+	/* compression halves the bytes, 2160 source lines */
+	TEST_EXPECT_EQ(res.pipe[0].ab, 995328000);
+	TEST_EXPECT_EQ(res.pipe[0].ib, 1036800000);
+	/* xtra + macrotile + dest scale + downscaling */
+	TEST_EXPECT_EQ(res.pipe[0].prefill_lines, 18);
+	/* 2x vertical and 2x horizontal decimation */
+	TEST_EXPECT_EQ(res.pipe[0].clk, 518400000);
+	TEST_EXPECT_EQ(res.core_clk, 570240000);
+	TEST_EXPECT(res.bw_fits);
+	TEST_EXPECT(!res.clk_fits);
+}
+
+static void test_multi_plane(void)
+{
+	struct sde_perf_model_plane planes[2] = { test_linear, test_ubwc_down };
+	struct sde_perf_model_result res;
+
+	TEST_EXPECT_EQ(sde_perf_model_calc(&test_cfg, &test_1080p, planes, 2,
+			&res), 0);
+
+	TEST_EXPECT_EQ(res.ab[SDE_PERF_MODEL_BUS_MNOC], 1492992000);
+	/* the summed ab exceeds every pipe ib at an ib fudge factor of 1 */
+	TEST_EXPECT_EQ(res.ib[SDE_PERF_MODEL_BUS_MNOC], 1492992000);
+	TEST_EXPECT_EQ(res.core_clk, 570240000);
+	TEST_EXPECT(!res.bw_fits);
+}
+
+static void test_prefill(void)
+{
+	struct sde_perf_model_cfg cfg = test_cfg;
+	struct sde_perf_model_timing timing = test_1080p;
+	struct sde_perf_model_result res;
+
+	cfg.min_prefill_lines = 24;
+	TEST_EXPECT_EQ(sde_perf_model_calc(&cfg, &timing, &test_linear, 1,
+			&res), 0);
+	TEST_EXPECT_EQ(res.pipe[0].prefill_lines, 24);
+	TEST_EXPECT_EQ(res.pipe[0].ib, 518400000);
+
+	/* two blanking lines, the 4 prefill lines dominate the ib */
+	timing.vtotal = 1082;
+	TEST_EXPECT_EQ(sde_perf_model_calc(&test_cfg, &timing, &test_linear, 1,
+			&res), 0);
+	TEST_EXPECT_EQ(res.pipe[0].ib, 997171200);
+}
+
+static void test_mixer_split(void)
+{
+	struct sde_perf_model_timing timing = test_1080p;
+	struct sde_perf_model_result res;
+
+	timing.width = 3840;
+	timing.num_mixers = 2;
+	TEST_EXPECT_EQ(sde_perf_model_calc(&test_cfg, &timing, NULL, 0, &res),
+			0);
+
+	/* each mixer outputs 1920 pixels per line */
+	TEST_EXPECT_EQ(res.core_clk, 142560000);
+	TEST_EXPECT_EQ(res.ab[SDE_PERF_MODEL_BUS_MNOC], 0);
+	TEST_EXPECT_EQ(res.ib[SDE_PERF_MODEL_BUS_EBI], 600000000);
+}
+
+static void test_parse(void)
+{
+	const char *ratios = "NV12/5/1/1.43 AB24/5/1/1.56 XB24/5/1/2";
+	u32 val = 0;
+
+	TEST_EXPECT_EQ(sde_perf_model_parse_fp("1.23", &val), 0);
+	TEST_EXPECT_EQ(val, 1230);
+	TEST_EXPECT_EQ(sde_perf_model_parse_fp("2", &val), 0);
+	TEST_EXPECT_EQ(val, 2000);
+	TEST_EXPECT_EQ(sde_perf_model_parse_fp("0.0625", &val), 0);
+	TEST_EXPECT_EQ(val, 62);
+	TEST_EXPECT_EQ(sde_perf_model_parse_fp("", &val), -EINVAL);
+	TEST_EXPECT_EQ(sde_perf_model_parse_fp("1.2.3", &val), -EINVAL);
+	TEST_EXPECT_EQ(sde_perf_model_parse_fp("x", &val), -EINVAL);
+
+	TEST_EXPECT_EQ(sde_perf_model_parse_comp_ratio(ratios,
+			FOURCC('A', 'B', '2', '4'), &val), 0);
+	TEST_EXPECT_EQ(val, 1560);
+	TEST_EXPECT_EQ(sde_perf_model_parse_comp_ratio(ratios,
+			FOURCC('X', 'B', '2', '4'), &val), 0);
+	TEST_EXPECT_EQ(val, 2000);
+	TEST_EXPECT_EQ(sde_perf_model_parse_comp_ratio(ratios,
+			FOURCC('N', 'V', '2', '1'), &val), -ENOENT);
+	TEST_EXPECT_EQ(sde_perf_model_parse_comp_ratio(NULL,
+			FOURCC('N', 'V', '1', '2'), &val), -ENOENT);
+}
+
+int main(void)
+{
+	test_invalid();
+	test_linear_plane();
+	test_ubwc_downscale();
+	test_multi_plane();
+	test_prefill();
+	test_mixer_split();
+	test_parse();
+
+	return test_report("sde_perf_model_test");
+}
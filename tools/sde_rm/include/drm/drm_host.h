@@ -0,0 +1,136 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2021, The Linux Foundation. All rights reserved.
+ */
+
+/*
+ * Host stand-in for the drm core. The objects only carry the members the
+ * resource manager reads.
+ */
+
+#ifndef _HOST_DRM_H_
+#define _HOST_DRM_H_
+#include <linux/kernel.h>
+
+#define DRM_MODE_CONNECTOR_DisplayPort	10
+#define DRM_MODE_CONNECTOR_VIRTUAL	15
+#define DRM_MODE_CONNECTOR_DSI		16
+
+struct drm_file;
+struct drm_framebuffer;
+struct drm_plane;
+struct drm_plane_state;
+struct drm_property;
+struct drm_minor;
+struct drm_gem_object;
+struct drm_mode_fb_cmd2;
+
+struct drm_prop_enum_list {
+	int type;
+	const char *name;
+};
+
+struct drm_mode_object {
+	u32 id;
+};
+
+struct drm_device {
+	void *dev_private;
+	struct drm_encoder **encoders;
+	u32 num_encoders;
+	struct drm_connector **connectors;
+	u32 num_connectors;
+};
+
+struct drm_display_mode {
+	int hdisplay;
+	int vdisplay;
+};
+
+struct drm_crtc {
+	struct drm_mode_object base;
+	struct drm_device *dev;
+};
+
+struct drm_crtc_state {
+	struct drm_crtc *crtc;
+	bool mode_changed;
+	bool active_changed;
+	bool connectors_changed;
+	u32 encoder_mask;
+	struct drm_display_mode mode;
+	struct drm_atomic_state *state;
+};
+
+struct drm_encoder {
+	struct drm_mode_object base;
+	struct drm_device *dev;
+	u32 index;
+};
+
+struct drm_connector_state {
+	struct drm_connector *connector;
+	struct drm_encoder *best_encoder;
+};
+
+struct drm_connector {
+	struct drm_mode_object base;
+	struct drm_device *dev;
+	const char *name;
+	int connector_type;
+	struct drm_connector_state *state;
+};
+
+struct drm_atomic_state;
+
+struct drm_connector_list_iter {
+	struct drm_device *dev;
+	u32 i;
+};
+
+static inline void drm_connector_list_iter_begin(struct drm_device *dev,
+		struct drm_connector_list_iter *iter)
+{
+	iter->dev = dev;
+	iter->i = 0;
+}
+
+static inline void drm_connector_list_iter_end(
+		struct drm_connector_list_iter *iter)
+{
+}
+
+static inline struct drm_connector *drm_connector_list_iter_next(
+		struct drm_connector_list_iter *iter)
+{
+	if (iter->i >= iter->dev->num_connectors)
+		return NULL;
+	return iter->dev->connectors[iter->i++];
+}
+
+#define drm_for_each_connector_iter(connector, iter) \
+	while ((connector = drm_connector_list_iter_next(iter)))
+
+static inline u32 drm_encoder_mask(const struct drm_encoder *encoder)
+{
+	return 1 << encoder->index;
+}
+
+#define drm_for_each_encoder_mask(encoder, dev, encoder_mask) \
+	for (u32 _i = 0; _i < (dev)->num_encoders; _i++) \
+		if (((encoder) = (dev)->encoders[_i]), \
+				!((encoder_mask) & drm_encoder_mask(encoder))) \
+			continue; \
+		else
+
+static inline bool drm_atomic_crtc_needs_modeset(
+		const struct drm_crtc_state *state)
+{
+	return state->mode_changed || state->active_changed ||
+		state->connectors_changed;
+}
+
+struct drm_connector_state *drm_atomic_get_new_connector_state(
+		struct drm_atomic_state *state, struct drm_connector *connector);
+
+#endif /* _HOST_DRM_H_ */
@@ -0,0 +1,190 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2021, The Linux Foundation. All rights reserved.
+ */
+
+/*
+ * Host stand-in for the kernel headers sde_rm.c pulls in. Only what the
+ * resource manager and the hw headers it includes use is provided.
+ */
+
+#ifndef _HOST_LINUX_KERNEL_H_
+#define _HOST_LINUX_KERNEL_H_
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef unsigned long long u64;
+typedef int8_t s8;
+typedef int16_t s16;
+typedef int32_t s32;
+typedef long long s64;
+typedef u8 __u8;
+typedef u16 __u16;
+typedef u32 __u32;
+typedef u64 __u64;
+typedef s32 __s32;
+typedef s64 __s64;
+typedef s64 ktime_t;
+typedef u64 dma_addr_t;
+typedef u64 phys_addr_t;
+typedef struct { int counter; } atomic_t;
+typedef struct { int dummy; } spinlock_t;
+
+#define __iomem
+#define __user
+#define __packed	__attribute__((packed))
+#define __maybe_unused	__attribute__((unused))
+#define BIT(n)		(1UL << (n))
+#define BIT_ULL(n)	(1ULL << (n))
+#define BITS_PER_LONG	(sizeof(long) * 8)
+#define BITS_TO_LONGS(n)	(((n) + BITS_PER_LONG - 1) / BITS_PER_LONG)
+#define DECLARE_BITMAP(name, bits)	unsigned long name[BITS_TO_LONGS(bits)]
+#define GENMASK(h, l)	(((~0UL) << (l)) & (~0UL >> (BITS_PER_LONG - 1 - (h))))
+#define ARRAY_SIZE(a)	(sizeof(a) / sizeof((a)[0]))
+#define container_of(p, t, m)	((t *)((char *)(p) - offsetof(t, m)))
+#define min(a, b)	((a) < (b) ? (a) : (b))
+#define max(a, b)	((a) > (b) ? (a) : (b))
+#define min_t(t, a, b)	min((t)(a), (t)(b))
+#define max_t(t, a, b)	max((t)(a), (t)(b))
+#define DIV_ROUND_UP(n, d)	(((n) + (d) - 1) / (d))
+#define ALIGN(x, a)	(((x) + (a) - 1) & ~((typeof(x))(a) - 1))
+#define WARN_ON(c)	(!!(c))
+#define BUG_ON(c)	do { if (c) abort(); } while (0)
+#define likely(x)	(x)
+#define unlikely(x)	(x)
+#define MAX_ERRNO	4095
+
+static inline void *ERR_PTR(long err) { return (void *)err; }
+static inline long PTR_ERR(const void *p) { return (long)p; }
+static inline bool IS_ERR(const void *p)
+{
+	return (unsigned long)p >= (unsigned long)-MAX_ERRNO;
+}
+static inline bool IS_ERR_OR_NULL(const void *p) { return !p || IS_ERR(p); }
+
+/* bitops */
+static inline bool test_bit(long nr, const volatile unsigned long *addr)
+{
+	return (addr[nr / BITS_PER_LONG] >> (nr % BITS_PER_LONG)) & 1;
+}
+static inline void __set_bit(long nr, volatile unsigned long *addr)
+{
+	addr[nr / BITS_PER_LONG] |= 1UL << (nr % BITS_PER_LONG);
+}
+static inline void __clear_bit(long nr, volatile unsigned long *addr)
+{
+	addr[nr / BITS_PER_LONG] &= ~(1UL << (nr % BITS_PER_LONG));
+}
+#define set_bit		__set_bit
+#define clear_bit	__clear_bit
+/* a word at a time like the kernel, the bitmaps are walked on hot paths */
+static inline unsigned long find_next_bit(const unsigned long *addr,
+		unsigned long size, unsigned long offset)
+{
+	unsigned long word;
+
+	if (offset >= size)
+		return size;
+
+	word = addr[offset / BITS_PER_LONG] &
+			(~0UL << (offset % BITS_PER_LONG));
+	while (!word) {
+		offset = (offset | (BITS_PER_LONG - 1)) + 1;
+		if (offset >= size)
+			return size;
+		word = addr[offset / BITS_PER_LONG];
+	}
+
+	offset = (offset & ~(BITS_PER_LONG - 1)) + __builtin_ctzl(word);
+	return min(offset, size);
+}
+static inline int fls(unsigned int x)
+{
+	return x ? 32 - __builtin_clz(x) : 0;
+}
+#define find_first_bit(addr, size)	find_next_bit(addr, size, 0)
+#define for_each_set_bit(bit, addr, size) \
+	for ((bit) = find_next_bit((addr), (size), 0); (bit) < (size); \
+	     (bit) = find_next_bit((addr), (size), (bit) + 1))
+#define for_each_set_bit_from(bit, addr, size) \
+	for ((bit) = find_next_bit((addr), (size), (bit)); (bit) < (size); \
+	     (bit) = find_next_bit((addr), (size), (bit) + 1))
+
+/* lists */
+struct list_head {
+	struct list_head *next, *prev;
+};
+#define LIST_HEAD_INIT(name)	{ &(name), &(name) }
+static inline void INIT_LIST_HEAD(struct list_head *l)
+{
+	l->next = l;
+	l->prev = l;
+}
+static inline void list_add_tail(struct list_head *n, struct list_head *h)
+{
+	n->prev = h->prev;
+	n->next = h;
+	h->prev->next = n;
+	h->prev = n;
+}
+static inline void list_del(struct list_head *e)
+{
+	e->prev->next = e->next;
+	e->next->prev = e->prev;
+	e->next = e->prev = NULL;
+}
+static inline int list_empty(const struct list_head *h)
+{
+	return h->next == h;
+}
+#define list_entry(p, t, m)	container_of(p, t, m)
+#define list_first_entry(p, t, m)	list_entry((p)->next, t, m)
+#define list_for_each_entry(pos, head, member) \
+	for (pos = list_entry((head)->next, typeof(*pos), member); \
+	     &pos->member != (head); \
+	     pos = list_entry(pos->member.next, typeof(*pos), member))
+#define list_for_each_entry_safe(pos, n, head, member) \
+	for (pos = list_entry((head)->next, typeof(*pos), member), \
+	     n = list_entry(pos->member.next, typeof(*pos), member); \
+	     &pos->member != (head); \
+	     pos = n, n = list_entry(n->member.next, typeof(*n), member))
+
+/* locking is a no-op, the host tests are single threaded */
+struct mutex {
+	int locked;
+};
+#define mutex_init(m)		((m)->locked = 0)
+#define mutex_destroy(m)	do { } while (0)
+#define mutex_lock(m)		((m)->locked++)
+#define mutex_unlock(m)		((m)->locked--)
+
+/* memory */
+#define GFP_KERNEL	0
+#define kzalloc(s, f)		calloc(1, (s))
+#define kcalloc(n, s, f)	calloc((n), (s))
+#define kfree(p)		free((void *)(p))
+
+/* printing */
+#define pr_err(fmt, ...)	fprintf(stderr, fmt, ##__VA_ARGS__)
+#define pr_warn(fmt, ...)	fprintf(stderr, fmt, ##__VA_ARGS__)
+#define pr_info(fmt, ...)	do { } while (0)
+#define pr_debug(fmt, ...)	do { } while (0)
+
+static inline void usleep_range(unsigned long min, unsigned long max) { }
+
+struct device;
+struct device_node;
+struct platform_device;
+struct dentry;
+
+#endif /* _HOST_LINUX_KERNEL_H_ */
@@ -0,0 +1,3 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/* host stand-in, see linux/kernel.h */
+#include <linux/kernel.h>
@@ -0,0 +1,275 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2021, The Linux Foundation. All rights reserved.
+ */
+
+/*
+ * Host stand-ins for what sde_rm.c calls outside of itself. The hw block
+ * objects only carry their id and catalog entry, no registers are mapped.
+ * The encoder reports the resources the test put in sde_rm_test_hw_res.
+ */
+
+#include "sde_kms.h"
+#include "sde_hw_lm.h"
+#include "sde_hw_ctl.h"
+#include "sde_hw_cdm.h"
+#include "sde_hw_dspp.h"
+#include "sde_hw_ds.h"
+#include "sde_hw_pingpong.h"
+#include "sde_hw_intf.h"
+#include "sde_hw_wb.h"
+#include "sde_hw_dsc.h"
+#include "sde_hw_vdc.h"
+#include "sde_hw_qdss.h"
+#include "sde_encoder.h"
+#include "sde_connector.h"
+#include "sde_crtc.h"
+
+#include "sde_rm_stubs.h"
+
+int sde_host_verbose;
+struct sde_encoder_hw_resources sde_rm_test_hw_res;
+
+/* catalog entry of the block with the given id, the id is the first member */
+#define TEST_CFG(array, count, idx) \
+	((typeof(&(array)[0]))_test_cfg((array), sizeof((array)[0]), \
+			(count), (idx)))
+
+static void *_test_cfg(void *array, size_t size, u32 count, u32 idx)
+{
+	const struct { SDE_HW_BLK_INFO; } *cfg;
+	u32 i;
+
+	for (i = 0; i < count; i++) {
+		cfg = array + i * size;
+		if (cfg->id == idx)
+			return (void *)cfg;
+	}
+
+	return NULL;
+}
+
+#define TEST_HW_INIT(name, hw_type, blk_type, idx_type, cfg_array, \
+		cfg_count, cap_member) \
+hw_type *name(idx_type idx, void __iomem *addr, \
+		struct sde_mdss_cfg *m) \
+{ \
+	hw_type *c; \
+\
+	c = kzalloc(sizeof(*c), GFP_KERNEL); \
+	if (!c) \
+		return ERR_PTR(-ENOMEM); \
+\
+	c->cap_member = TEST_CFG(m->cfg_array, m->cfg_count, idx); \
+	if (!c->cap_member) { \
+		kfree(c); \
+		return ERR_PTR(-EINVAL); \
+	} \
+\
+	c->idx = idx; \
+	c->base.type = blk_type; \
+	c->base.id = idx; \
+	return c; \
+}
+
+TEST_HW_INIT(sde_hw_lm_init, struct sde_hw_mixer, SDE_HW_BLK_LM,
+		enum sde_lm, mixer, mixer_count, cap)
+TEST_HW_INIT(sde_hw_dspp_init, struct sde_hw_dspp, SDE_HW_BLK_DSPP,
+		enum sde_dspp, dspp, dspp_count, cap)
+TEST_HW_INIT(sde_hw_ds_init, struct sde_hw_ds, SDE_HW_BLK_DS,
+		enum sde_ds, ds, ds_count, scl)
+TEST_HW_INIT(sde_hw_ctl_init, struct sde_hw_ctl, SDE_HW_BLK_CTL,
+		enum sde_ctl, ctl, ctl_count, caps)
+TEST_HW_INIT(sde_hw_pingpong_init, struct sde_hw_pingpong,
+		SDE_HW_BLK_PINGPONG, enum sde_pingpong, pingpong,
+		pingpong_count, caps)
+TEST_HW_INIT(sde_hw_intf_init, struct sde_hw_intf, SDE_HW_BLK_INTF,
+		enum sde_intf, intf, intf_count, cap)
+TEST_HW_INIT(sde_hw_dsc_init, struct sde_hw_dsc, SDE_HW_BLK_DSC,
+		enum sde_dsc, dsc, dsc_count, caps)
+TEST_HW_INIT(sde_hw_vdc_init, struct sde_hw_vdc, SDE_HW_BLK_VDC,
+		enum sde_vdc, vdc, vdc_count, caps)
+TEST_HW_INIT(sde_hw_qdss_init, struct sde_hw_qdss, SDE_HW_BLK_QDSS,
+		enum sde_qdss, qdss, qdss_count, caps)
+
+struct sde_hw_cdm *sde_hw_cdm_init(enum sde_cdm idx, void __iomem *addr,
+		struct sde_mdss_cfg *m, struct sde_hw_mdp *hw_mdp)
+{
+	struct sde_hw_cdm *c;
+
+	c = kzalloc(sizeof(*c), GFP_KERNEL);
+	if (!c)
+		return ERR_PTR(-ENOMEM);
+
+	c->caps = TEST_CFG(m->cdm, m->cdm_count, idx);
+	if (!c->caps) {
+		kfree(c);
+		return ERR_PTR(-EINVAL);
+	}
+
+	c->idx = idx;
+	c->hw_mdp = hw_mdp;
+	c->base.type = SDE_HW_BLK_CDM;
+	c->base.id = idx;
+	return c;
+}
+
+struct sde_hw_wb *sde_hw_wb_init(enum sde_wb idx, void __iomem *addr,
+		struct sde_mdss_cfg *m, struct sde_hw_mdp *hw_mdp)
+{
+	struct sde_hw_wb *c;
+
+	c = kzalloc(sizeof(*c), GFP_KERNEL);
+	if (!c)
+		return ERR_PTR(-ENOMEM);
+
+	c->caps = TEST_CFG(m->wb, m->wb_count, idx);
+	if (!c->caps) {
+		kfree(c);
+		return ERR_PTR(-EINVAL);
+	}
+
+	c->idx = idx;
+	c->catalog = m;
+	c->hw_mdp = hw_mdp;
+	c->base.type = SDE_HW_BLK_WB;
+	c->base.id = idx;
+	return c;
+}
+
+struct sde_hw_mdp *sde_hw_mdptop_init(enum sde_mdp idx, void __iomem *addr,
+		const struct sde_mdss_cfg *m)
+{
+	struct sde_hw_mdp *c;
+
+	c = kzalloc(sizeof(*c), GFP_KERNEL);
+	if (!c)
+		return ERR_PTR(-ENOMEM);
+
+	c->idx = idx;
+	c->caps = &m->mdp[0];
+	c->base.type = SDE_HW_BLK_TOP;
+	c->base.id = idx;
+	return c;
+}
+
+void sde_hw_lm_destroy(struct sde_hw_mixer *lm)
+{
+	kfree(lm);
+}
+
+void sde_hw_dspp_destroy(struct sde_hw_dspp *dspp)
+{
+	kfree(dspp);
+}
+
+void sde_hw_ds_destroy(struct sde_hw_ds *hw_ds)
+{
+	kfree(hw_ds);
+}
+
+void sde_hw_ctl_destroy(struct sde_hw_ctl *ctx)
+{
+	kfree(ctx);
+}
+
+void sde_hw_cdm_destroy(struct sde_hw_cdm *cdm)
+{
+	kfree(cdm);
+}
+
+void sde_hw_pingpong_destroy(struct sde_hw_pingpong *pp)
+{
+	kfree(pp);
+}
+
+void sde_hw_intf_destroy(struct sde_hw_intf *intf)
+{
+	kfree(intf);
+}
+
+void sde_hw_wb_destroy(struct sde_hw_wb *hw_wb)
+{
+	kfree(hw_wb);
+}
+
+void sde_hw_dsc_destroy(struct sde_hw_dsc *dsc)
+{
+	kfree(dsc);
+}
+
+void sde_hw_vdc_destroy(struct sde_hw_vdc *vdc)
+{
+	kfree(vdc);
+}
+
+void sde_hw_qdss_destroy(struct sde_hw_qdss *qdss)
+{
+	kfree(qdss);
+}
+
+void sde_hw_mdp_destroy(struct sde_hw_mdp *mdp)
+{
+	kfree(mdp);
+}
+
+void sde_encoder_get_hw_resources(struct drm_encoder *encoder,
+		struct sde_encoder_hw_resources *hw_res,
+		struct drm_connector_state *conn_state)
+{
+	struct msm_compression_info *comp_info = hw_res->comp_info;
+
+	*hw_res = sde_rm_test_hw_res;
+	hw_res->comp_info = comp_info;
+	if (comp_info)
+		comp_info->comp_type = hw_res->topology.comp_type;
+}
+
+enum sde_connector_display sde_encoder_get_display_type(
+		struct drm_encoder *enc)
+{
+	return sde_rm_test_hw_res.display_type;
+}
+
+bool sde_crtc_state_in_clone_mode(struct drm_encoder *encoder,
+		struct drm_crtc_state *state)
+{
+	return false;
+}
+
+int sde_crtc_get_num_datapath(struct drm_crtc *crtc,
+		struct drm_connector *connector,
+		struct drm_crtc_state *crtc_state)
+{
+	return 0;
+}
+
+struct drm_connector_state *drm_atomic_get_new_connector_state(
+		struct drm_atomic_state *state, struct drm_connector *connector)
+{
+	return connector->state;
+}
+
+int msm_property_set_property(struct msm_property_info *info,
+		struct msm_property_state *property_state,
+		uint32_t property_idx, uint64_t val)
+{
+	struct sde_connector_state *c_state;
+
+	c_state = (struct sde_connector_state *)property_state;
+	if (property_idx >= CONNECTOR_PROP_COUNT)
+		return -EINVAL;
+
+	c_state->property_values[property_idx] = val;
+	return 0;
+}
+
+int sde_connector_state_get_topology(struct drm_connector_state *conn_state,
+		struct msm_display_topology *topology)
+{
+	if (!conn_state || !topology)
+		return -EINVAL;
+
+	*topology = to_sde_connector_state(conn_state)->topology;
+	return 0;
+}
@@ -0,0 +1,17 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2021, The Linux Foundation. All rights reserved.
+ */
+
+#ifndef _SDE_RM_STUBS_H_
+#define _SDE_RM_STUBS_H_
+
+#include "sde_encoder.h"
+
+/*
+ * Resources every encoder reports to the resource manager, the compression
+ * type is taken from the topology.
+ */
+extern struct sde_encoder_hw_resources sde_rm_test_hw_res;
+
+#endif /* _SDE_RM_STUBS_H_ */
@@ -0,0 +1,76 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2021, The Linux Foundation. All rights reserved.
+ */
+
+/* host stand-in for msm_drv.h, the types sde_rm.c and its headers use */
+
+#ifndef __MSM_DRV_H__
+#define __MSM_DRV_H__
+
+#include <linux/kernel.h>
+#include <drm/drmP.h>
+
+#define MAX_CRTCS	16
+#define MAX_PLANES	20
+#define MAX_ENCODERS	16
+#define MAX_CONNECTORS	16
+#define MAX_H_TILES_PER_DISPLAY	2
+
+enum msm_display_compression_type {
+	MSM_DISPLAY_COMPRESSION_NONE,
+	MSM_DISPLAY_COMPRESSION_DSC,
+	MSM_DISPLAY_COMPRESSION_VDC
+};
+
+struct drm_dsc_config {
+	bool native_422;
+	bool native_420;
+};
+
+struct msm_display_dsc_info {
+	struct drm_dsc_config config;
+};
+
+struct msm_display_vdc_info {
+	u32 dummy;
+};
+
+struct msm_compression_info {
+	enum msm_display_compression_type comp_type;
+	u32 comp_ratio;
+
+	union {
+		struct msm_display_dsc_info dsc_info;
+		struct msm_display_vdc_info vdc_info;
+	};
+};
+
+struct msm_display_topology {
+	u32 num_lm;
+	u32 num_enc;
+	u32 num_intf;
+	enum msm_display_compression_type comp_type;
+};
+
+struct msm_resource_caps_info {
+	uint32_t num_lm;
+	uint32_t num_dsc;
+	uint32_t num_vdc;
+	uint32_t num_ctl;
+	uint32_t num_3dmux;
+	uint32_t max_mixer_width;
+};
+
+struct msm_format {
+	uint32_t pixel_format;
+};
+
+struct msm_kms;
+struct sde_drm_scaler_v2;
+
+struct msm_drm_private {
+	struct msm_kms *kms;
+};
+
+#endif
@@ -0,0 +1,3 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/* host stand-in, see msm_drv.h */
+#include "msm_drv.h"
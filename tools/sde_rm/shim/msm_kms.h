@@ -0,0 +1,17 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2021, The Linux Foundation. All rights reserved.
+ */
+
+/* host stand-in for msm_kms.h */
+
+#ifndef __MSM_KMS_H__
+#define __MSM_KMS_H__
+
+#include "msm_drv.h"
+
+struct msm_kms {
+	int dummy;
+};
+
+#endif
@@ -0,0 +1,71 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2021, The Linux Foundation. All rights reserved.
+ */
+
+/* host stand-in for sde_connector.h, the topology properties only */
+
+#ifndef _SDE_CONNECTOR_H_
+#define _SDE_CONNECTOR_H_
+
+#include "msm_drv.h"
+#include "sde_kms.h"
+
+enum sde_connector_display {
+	SDE_CONNECTOR_UNDEFINED,
+	SDE_CONNECTOR_PRIMARY,
+	SDE_CONNECTOR_SECONDARY,
+	SDE_CONNECTOR_MAX
+};
+
+enum msm_mdp_conn_property {
+	CONNECTOR_PROP_TOPOLOGY_NAME,
+	CONNECTOR_PROP_TOPOLOGY_CONTROL,
+	CONNECTOR_PROP_COUNT
+};
+
+struct msm_property_info;
+struct msm_property_state;
+
+struct sde_connector {
+	struct drm_connector base;
+	struct drm_encoder *encoder;
+	u32 lm_mask;
+};
+
+struct sde_connector_state {
+	struct drm_connector_state base;
+	u64 property_values[CONNECTOR_PROP_COUNT];
+	struct msm_display_topology topology;
+};
+
+#define to_sde_connector(x)	container_of((x), struct sde_connector, base)
+#define to_sde_connector_state(x) \
+	container_of((x), struct sde_connector_state, base)
+
+static inline u64 sde_connector_get_property(struct drm_connector_state *state,
+		int idx)
+{
+	return to_sde_connector_state(state)->property_values[idx];
+}
+
+static inline struct msm_property_info *sde_connector_get_propinfo(
+		struct drm_connector *connector)
+{
+	return NULL;
+}
+
+static inline struct msm_property_state *sde_connector_get_property_state(
+		struct drm_connector_state *state)
+{
+	return (struct msm_property_state *)state;
+}
+
+int msm_property_set_property(struct msm_property_info *info,
+		struct msm_property_state *property_state,
+		uint32_t property_idx, uint64_t val);
+
+int sde_connector_state_get_topology(struct drm_connector_state *conn_state,
+		struct msm_display_topology *topology);
+
+#endif
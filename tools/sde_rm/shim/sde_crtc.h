@@ -0,0 +1,28 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2021, The Linux Foundation. All rights reserved.
+ */
+
+/* host stand-in for sde_crtc.h */
+
+#ifndef _SDE_CRTC_H_
+#define _SDE_CRTC_H_
+
+#include "msm_drv.h"
+
+struct sde_crtc_state {
+	struct drm_crtc_state base;
+	int num_connectors;
+	struct drm_connector *connectors[MAX_CONNECTORS];
+};
+
+#define to_sde_crtc_state(x)	container_of(x, struct sde_crtc_state, base)
+
+bool sde_crtc_state_in_clone_mode(struct drm_encoder *encoder,
+		struct drm_crtc_state *state);
+
+int sde_crtc_get_num_datapath(struct drm_crtc *crtc,
+		struct drm_connector *connector,
+		struct drm_crtc_state *crtc_state);
+
+#endif
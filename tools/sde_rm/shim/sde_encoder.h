@@ -0,0 +1,35 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2021, The Linux Foundation. All rights reserved.
+ */
+
+/*
+ * Host stand-in for sde_encoder.h. struct sde_encoder_hw_resources keeps
+ * the layout of the driver, the test fills it in.
+ */
+
+#ifndef __SDE_ENCODER_H__
+#define __SDE_ENCODER_H__
+
+#include "msm_drv.h"
+#include "sde_hw_mdss.h"
+#include "sde_connector.h"
+
+struct sde_encoder_hw_resources {
+	enum sde_intf_mode intfs[INTF_MAX];
+	enum sde_intf_mode wbs[WB_MAX];
+	bool needs_cdm;
+	u32 display_num_of_h_tiles;
+	enum sde_connector_display display_type;
+	struct msm_display_topology topology;
+	struct msm_compression_info *comp_info;
+};
+
+void sde_encoder_get_hw_resources(struct drm_encoder *encoder,
+		struct sde_encoder_hw_resources *hw_res,
+		struct drm_connector_state *conn_state);
+
+enum sde_connector_display sde_encoder_get_display_type(
+		struct drm_encoder *enc);
+
+#endif
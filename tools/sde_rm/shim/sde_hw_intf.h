@@ -0,0 +1,34 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2021, The Linux Foundation. All rights reserved.
+ */
+
+/*
+ * Host stand-in for sde_hw_intf.h, the real one pulls in sde_kms.h from its
+ * own directory.
+ */
+
+#ifndef _SDE_HW_INTF_H
+#define _SDE_HW_INTF_H
+
+#include "sde_hw_catalog.h"
+#include "sde_hw_mdss.h"
+#include "sde_hw_blk.h"
+
+struct sde_hw_intf {
+	struct sde_hw_blk base;
+	enum sde_intf idx;
+	const struct sde_intf_cfg *cap;
+};
+
+static inline struct sde_hw_intf *to_sde_hw_intf(struct sde_hw_blk *hw)
+{
+	return container_of(hw, struct sde_hw_intf, base);
+}
+
+struct sde_hw_intf *sde_hw_intf_init(enum sde_intf idx,
+		void __iomem *addr, struct sde_mdss_cfg *m);
+
+void sde_hw_intf_destroy(struct sde_hw_intf *intf);
+
+#endif
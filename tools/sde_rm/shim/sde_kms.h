@@ -0,0 +1,50 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2021, The Linux Foundation. All rights reserved.
+ */
+
+/* host stand-in for sde_kms.h, debug logging and the event log are compiled out */
+
+#ifndef __SDE_KMS_H__
+#define __SDE_KMS_H__
+
+#include "msm_drv.h"
+#include "msm_kms.h"
+#include "sde_hw_catalog.h"
+#include "sde_hw_mdss.h"
+#include "sde_rm.h"
+
+/* set by the test to see the errors of the driver code */
+extern int sde_host_verbose;
+
+#define SDE_DEBUG(fmt, ...) \
+	do { \
+		if (0) \
+			fprintf(stderr, fmt, ##__VA_ARGS__); \
+	} while (0)
+
+#define SDE_ERROR(fmt, ...) \
+	do { \
+		if (sde_host_verbose) \
+			fprintf(stderr, "[sde error:%s] " fmt, __func__, \
+					##__VA_ARGS__); \
+	} while (0)
+
+/* the arguments are only type checked */
+#define SDE_EVT32(...) \
+	do { \
+		(void)sizeof((long long[]){ __VA_ARGS__ }); \
+	} while (0)
+
+#define SDE_EVTLOG_ERROR	0xebad
+
+struct sde_kms {
+	struct msm_kms base;
+	struct sde_mdss_cfg *catalog;
+	struct sde_splash_data splash_data;
+	struct sde_rm rm;
+};
+
+#define to_sde_kms(x)	container_of(x, struct sde_kms, base)
+
+#endif /* __SDE_KMS_H__ */
@@ -0,0 +1,644 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2021, The Linux Foundation. All rights reserved.
+ */
+
+/*
+ * Host test of the resource manager. sde_rm.c is built against the stand-ins
+ * in sde_rm/ and every topology of its table is reserved, committed and
+ * released on a model of each target with a config/<target>disp.conf, once
+ * for a primary DSI display and once for an external DP display where the
+ * target has DP.
+ *
+ * The models only carry the blocks the resource manager looks at. They are
+ * written from the target device trees, which are not part of this tree, so
+ * keep them in sync when a target changes. sdxlemur is not modelled, it
+ * builds the QPIC display driver and has no SDE.
+ *
+ * When all checks pass, the cost of a reservation with and without the
+ * cache of the last solution is printed for each target.
+ *
+ * Pass -v to see the errors the driver code logs.
+ */
+
+#include <string.h>
+
+#include "sde_kms.h"
+#include "sde_connector.h"
+#include "sde_crtc.h"
+#include "sde_rm_stubs.h"
+#include "tools_test.h"
+
+#define TEST_LM_MAX_WIDTH	2560
+#define BENCH_ROUNDS		5000
+#define BENCH_RUNS		10
+#define TEST_TOP(name)		BIT(SDE_RM_TOPOLOGY_##name)
+
+/* reservable by both a primary DSI and an external DP display */
+#define TEST_TOPS_COMMON \
+	(TEST_TOP(NONE) | TEST_TOP(SINGLEPIPE) | TEST_TOP(SINGLEPIPE_DSC) | \
+	 TEST_TOP(DUALPIPE) | TEST_TOP(DUALPIPE_DSC) | \
+	 TEST_TOP(DUALPIPE_3DMERGE) | TEST_TOP(DUALPIPE_3DMERGE_DSC) | \
+	 TEST_TOP(DUALPIPE_DSCMERGE))
+
+#define TEST_TOPS_VDC \
+	(TEST_TOP(SINGLEPIPE_VDC) | TEST_TOP(DUALPIPE_3DMERGE_VDC))
+
+#define TEST_TOPS_QUAD_DSC \
+	(TEST_TOP(QUADPIPE_3DMERGE_DSC) | TEST_TOP(QUADPIPE_DSCMERGE) | \
+	 TEST_TOP(QUADPIPE_DSC4HSMERGE))
+
+/**
+ * struct test_target - display blocks of a target
+ * @name:	Target, as in config/<name>disp.conf
+ * @num_lm:	Layer mixers, paired 0-1, 2-3 and 4-5
+ * @num_dspp:	Dspps, on the first mixers
+ * @num_ds:	Destination scalers, on the first mixers
+ * @num_pp:	Pingpongs, one per mixer
+ * @num_dsc:	DSC encoders, paired like the mixers
+ * @num_vdc:	VDC encoders
+ * @num_ctl:	Ctl paths
+ * @num_qdss:	QDSS blocks
+ * @lm_primary: Mask of the mixers preferred for the primary display
+ * @ctl_primary: Mask of the ctls preferred for the primary display
+ * @intf:	Type of each interface, starting at INTF_0
+ * @has_wb:	Writeback 2 and a cdm shared with it are present
+ * @dsi_tops:	Topologies a primary DSI display is expected to get
+ * @dp_tops:	Topologies an external DP display is expected to get
+ */
+struct test_target {
+	const char *name;
+	u32 num_lm, num_dspp, num_ds, num_pp;
+	u32 num_dsc, num_vdc, num_ctl, num_qdss;
+	u32 lm_primary, ctl_primary;
+	u32 intf[4];
+	bool has_wb;
+	u32 dsi_tops, dp_tops;
+};
+
+/*
+ * A primary DSI display needs a dspp on every mixer and a destination
+ * scaler where the target has one, which only the primary mixers provide.
+ * A DP display can use the other mixers, so only DP gets four of them.
+ */
+static const struct test_target test_targets[] = {
+	{
+		.name = "kona",
+		.num_lm = 6, .num_dspp = 4, .num_ds = 2, .num_pp = 6,
+		.num_dsc = 6, .num_ctl = 6,
+		.lm_primary = 0x3, .ctl_primary = 0x1,
+		.intf = { INTF_DP, INTF_DSI, INTF_DSI, INTF_DP },
+		.has_wb = true,
+		.dsi_tops = TEST_TOPS_COMMON,
+		.dp_tops = TEST_TOPS_COMMON | TEST_TOP(QUADPIPE_3DMERGE) |
+				TEST_TOPS_QUAD_DSC,
+	},
+	{
+		.name = "lahaina",
+		.num_lm = 6, .num_dspp = 4, .num_ds = 2, .num_pp = 6,
+		.num_dsc = 6, .num_vdc = 1, .num_ctl = 6, .num_qdss = 1,
+		.lm_primary = 0x3, .ctl_primary = 0x1,
+		.intf = { INTF_DP, INTF_DSI, INTF_DSI, INTF_DP },
+		.has_wb = true,
+		.dsi_tops = TEST_TOPS_COMMON | TEST_TOPS_VDC,
+		.dp_tops = TEST_TOPS_COMMON | TEST_TOPS_VDC |
+				TEST_TOP(QUADPIPE_3DMERGE) | TEST_TOPS_QUAD_DSC,
+	},
+	{
+		.name = "saip",
+		.num_lm = 6, .num_dspp = 2, .num_pp = 6,
+		.num_dsc = 2, .num_ctl = 6,
+		.lm_primary = 0x3, .ctl_primary = 0x1,
+		.intf = { INTF_DP, INTF_DSI, INTF_DSI, INTF_DP },
+		.has_wb = true,
+		.dsi_tops = TEST_TOPS_COMMON,
+		.dp_tops = TEST_TOPS_COMMON | TEST_TOP(QUADPIPE_3DMERGE),
+	},
+	{
+		.name = "holi",
+		.num_lm = 2, .num_dspp = 1, .num_pp = 2,
+		.num_dsc = 1, .num_ctl = 3,
+		.lm_primary = 0x3, .ctl_primary = 0x1,
+		.intf = { INTF_NONE, INTF_DSI },
+		.dsi_tops = TEST_TOP(NONE) | TEST_TOP(SINGLEPIPE) |
+				TEST_TOP(SINGLEPIPE_DSC) |
+				TEST_TOP(DUALPIPE_3DMERGE) |
+				TEST_TOP(DUALPIPE_3DMERGE_DSC),
+	},
+	{
+		.name = "bengal",
+		.num_lm = 1, .num_dspp = 1, .num_pp = 1, .num_ctl = 1,
+		.lm_primary = 0x1, .ctl_primary = 0x1,
+		.intf = { INTF_NONE, INTF_DSI },
+		.dsi_tops = TEST_TOP(NONE) | TEST_TOP(SINGLEPIPE),
+	},
+	{
+		.name = "monaco",
+		.num_lm = 1, .num_dspp = 1, .num_pp = 1, .num_dsc = 1,
+		.num_ctl = 1,
+		.lm_primary = 0x1, .ctl_primary = 0x1,
+		.intf = { INTF_NONE, INTF_DSI },
+		.dsi_tops = TEST_TOP(NONE) | TEST_TOP(SINGLEPIPE) |
+				TEST_TOP(SINGLEPIPE_DSC),
+	},
+};
+
+/**
+ * struct test_display - a display driven through one encoder
+ * @name:	For the messages
+ * @connector_type: DRM connector type
+ * @display_type: Primary or external
+ * @intf:	Interfaces of a single and of a dual interface topology
+ */
+struct test_display {
+	const char *name;
+	int connector_type;
+	enum sde_connector_display display_type;
+	enum sde_intf intf[2];
+};
+
+static const struct test_display test_dsi = {
+	"dsi", DRM_MODE_CONNECTOR_DSI, SDE_CONNECTOR_PRIMARY,
+	{ INTF_1, INTF_2 },
+};
+
+static const struct test_display test_dp = {
+	"dp", DRM_MODE_CONNECTOR_DisplayPort, SDE_CONNECTOR_UNDEFINED,
+	{ INTF_0, INTF_3 },
+};
+
+static const char * const test_top_names[SDE_RM_TOPOLOGY_MAX] = {
+	[SDE_RM_TOPOLOGY_NONE] = "none",
+	[SDE_RM_TOPOLOGY_SINGLEPIPE] = "singlepipe",
+	[SDE_RM_TOPOLOGY_SINGLEPIPE_DSC] = "singlepipe_dsc",
+	[SDE_RM_TOPOLOGY_SINGLEPIPE_VDC] = "singlepipe_vdc",
+	[SDE_RM_TOPOLOGY_DUALPIPE] = "dualpipe",
+	[SDE_RM_TOPOLOGY_DUALPIPE_DSC] = "dualpipe_dsc",
+	[SDE_RM_TOPOLOGY_DUALPIPE_3DMERGE] = "dualpipe_3dmerge",
+	[SDE_RM_TOPOLOGY_DUALPIPE_3DMERGE_DSC] = "dualpipe_3dmerge_dsc",
+	[SDE_RM_TOPOLOGY_DUALPIPE_3DMERGE_VDC] = "dualpipe_3dmerge_vdc",
+	[SDE_RM_TOPOLOGY_DUALPIPE_DSCMERGE] = "dualpipe_dscmerge",
+	[SDE_RM_TOPOLOGY_PPSPLIT] = "ppsplit",
+	[SDE_RM_TOPOLOGY_QUADPIPE_3DMERGE] = "quadpipe_3dmerge",
+	[SDE_RM_TOPOLOGY_QUADPIPE_3DMERGE_DSC] = "quadpipe_3dmerge_dsc",
+	[SDE_RM_TOPOLOGY_QUADPIPE_DSCMERGE] = "quadpipe_dscmerge",
+	[SDE_RM_TOPOLOGY_QUADPIPE_DSC4HSMERGE] = "quadpipe_dsc4hsmerge",
+};
+
+static const struct sde_lm_sub_blks test_lm_sblk = {
+	.maxwidth = TEST_LM_MAX_WIDTH,
+};
+
+/**
+ * struct test_ctx - drm objects of the encoder under test and the rm
+ * @kms:	Holds the resource manager and the catalog
+ * @avail_res:	Resources available before anything got reserved
+ */
+struct test_ctx {
+	struct sde_kms kms;
+	struct msm_drm_private priv;
+	struct drm_device dev;
+	struct drm_encoder enc;
+	struct drm_encoder *encoders[1];
+	struct sde_connector conn;
+	struct drm_connector *connectors[1];
+	struct sde_connector_state conn_state;
+	struct drm_crtc crtc;
+	struct sde_crtc_state crtc_state;
+	struct msm_resource_caps_info avail_res;
+};
+
+/* ids of the blocks of each type reserved by the encoder */
+struct test_blks {
+	u32 mask[SDE_HW_BLK_MAX];
+	u32 count[SDE_HW_BLK_MAX];
+};
+
+static u32 test_mmio;
+
+static struct sde_mdss_cfg *test_catalog(const struct test_target *tgt)
+{
+	struct sde_mdss_cfg *cat;
+	u32 i;
+
+	cat = calloc(1, sizeof(*cat));
+	if (!cat)
+		return NULL;
+
+	cat->ctl_rev = SDE_CTL_CFG_VERSION_1_0_0;
+	cat->mdp_count = 1;
+	cat->mdp[0].id = MDP_TOP;
+	cat->mdp[0].has_dest_scaler = tgt->num_ds > 0;
+
+	cat->mixer_count = tgt->num_lm;
+	for (i = 0; i < tgt->num_lm; i++) {
+		struct sde_lm_cfg *lm = &cat->mixer[i];
+
+		lm->id = LM_0 + i;
+		lm->sblk = &test_lm_sblk;
+		lm->pingpong = i < tgt->num_pp ? PINGPONG_0 + i : PINGPONG_MAX;
+		lm->dspp = i < tgt->num_dspp ? DSPP_0 + i : DSPP_MAX;
+		lm->ds = i < tgt->num_ds ? DS_0 + i : DS_MAX;
+		if ((i ^ 1) < tgt->num_lm)
+			lm->lm_pair_mask = BIT(LM_0 + (i ^ 1));
+		if (tgt->lm_primary & BIT(i))
+			set_bit(SDE_DISP_PRIMARY_PREF, &lm->features);
+	}
+
+	cat->dspp_count = tgt->num_dspp;
+	for (i = 0; i < tgt->num_dspp; i++)
+		cat->dspp[i].id = DSPP_0 + i;
+
+	cat->ds_count = tgt->num_ds;
+	for (i = 0; i < tgt->num_ds; i++)
+		cat->ds[i].id = DS_0 + i;
+
+	cat->pingpong_count = tgt->num_pp;
+	for (i = 0; i < tgt->num_pp; i++)
+		cat->pingpong[i].id = PINGPONG_0 + i;
+
+	cat->dsc_count = tgt->num_dsc;
+	for (i = 0; i < tgt->num_dsc; i++) {
+		cat->dsc[i].id = DSC_0 + i;
+		if ((i ^ 1) < tgt->num_dsc)
+			set_bit(DSC_0 + (i ^ 1), cat->dsc[i].dsc_pair_mask);
+	}
+
+	cat->vdc_count = tgt->num_vdc;
+	for (i = 0; i < tgt->num_vdc; i++)
+		cat->vdc[i].id = VDC_0 + i;
+
+	cat->ctl_count = tgt->num_ctl;
+	for (i = 0; i < tgt->num_ctl; i++) {
+		cat->ctl[i].id = CTL_0 + i;
+		if (tgt->ctl_primary & BIT(i))
+			set_bit(SDE_CTL_PRIMARY_PREF, &cat->ctl[i].features);
+	}
+
+	cat->intf_count = ARRAY_SIZE(tgt->intf);
+	for (i = 0; i < ARRAY_SIZE(tgt->intf); i++) {
+		cat->intf[i].id = INTF_0 + i;
+		cat->intf[i].type = tgt->intf[i];
+	}
+
+	if (tgt->has_wb) {
+		cat->wb_count = 1;
+		cat->wb[0].id = WB_2;
+		cat->cdm_count = 1;
+		cat->cdm[0].id = CDM_0;
+		cat->cdm[0].wb_connect = BIT(WB_2);
+	}
+
+	cat->qdss_count = tgt->num_qdss;
+	for (i = 0; i < tgt->num_qdss; i++)
+		cat->qdss[i].id = QDSS_0 + i;
+
+	return cat;
+}
+
+static struct test_ctx *test_ctx_new(const struct test_target *tgt,
+		const struct test_display *disp)
+{
+	struct test_ctx *t;
+
+	t = calloc(1, sizeof(*t));
+	if (!t)
+		return NULL;
+
+	t->kms.catalog = test_catalog(tgt);
+	if (!t->kms.catalog)
+		goto fail;
+
+	t->priv.kms = &t->kms.base;
+	t->dev.dev_private = &t->priv;
+
+	t->enc.base.id = 31;
+	t->enc.dev = &t->dev;
+	t->encoders[0] = &t->enc;
+	t->dev.encoders = t->encoders;
+	t->dev.num_encoders = 1;
+
+	t->conn.base.base.id = 32;
+	t->conn.base.dev = &t->dev;
+	t->conn.base.name = disp->name;
+	t->conn.base.connector_type = disp->connector_type;
+	t->conn.base.state = &t->conn_state.base;
+	t->conn.encoder = &t->enc;
+	t->connectors[0] = &t->conn.base;
+	t->dev.connectors = t->connectors;
+	t->dev.num_connectors = 1;
+
+	t->conn_state.base.connector = &t->conn.base;
+	t->conn_state.base.best_encoder = &t->enc;
+
+	t->crtc.base.id = 33;
+	t->crtc.dev = &t->dev;
+	t->crtc_state.base.crtc = &t->crtc;
+	t->crtc_state.base.mode_changed = true;
+	t->crtc_state.base.encoder_mask = drm_encoder_mask(&t->enc);
+
+	if (sde_rm_init(&t->kms.rm, t->kms.catalog, (void __iomem *)&test_mmio,
+			&t->dev))
+		goto fail;
+
+	sde_rm_get_resource_info(&t->kms.rm, NULL, &t->avail_res);
+	return t;
+
+fail:
+	free(t->kms.catalog);
+	free(t);
+	return NULL;
+}
+
+static void test_ctx_free(struct test_ctx *t)
+{
+	sde_rm_destroy(&t->kms.rm);
+	free(t->kms.catalog);
+	free(t);
+}
+
+static void test_set_hw_res(struct test_ctx *t,
+		const struct sde_rm_topology_def *top,
+		const struct test_display *disp)
+{
+	struct sde_encoder_hw_resources *hw_res = &sde_rm_test_hw_res;
+	int i;
+
+	memset(hw_res, 0, sizeof(*hw_res));
+	hw_res->display_type = disp->display_type;
+	hw_res->display_num_of_h_tiles = top->num_intf;
+	hw_res->topology.num_lm = top->num_lm;
+	hw_res->topology.num_enc = top->num_comp_enc;
+	hw_res->topology.num_intf = top->num_intf;
+	hw_res->topology.comp_type = top->comp_type;
+
+	for (i = 0; i < top->num_intf && i < ARRAY_SIZE(disp->intf); i++)
+		hw_res->intfs[disp->intf[i] - INTF_0] = INTF_MODE_VIDEO;
+}
+
+/* atomic check, then the commit of the reservation it made */
+static int test_reserve(struct test_ctx *t)
+{
+	int rc;
+
+	rc = sde_rm_reserve(&t->kms.rm, &t->enc, &t->crtc_state.base,
+			&t->conn_state.base, true);
+	if (rc)
+		return rc;
+
+	return sde_rm_reserve(&t->kms.rm, &t->enc, &t->crtc_state.base,
+			&t->conn_state.base, false);
+}
+
+static void test_get_blks(struct test_ctx *t, struct test_blks *blks)
+{
+	struct sde_rm_hw_iter iter;
+	struct sde_hw_blk *hw;
+	enum sde_hw_blk_type type;
+
+	memset(blks, 0, sizeof(*blks));
+	for (type = 0; type < SDE_HW_BLK_MAX; type++) {
+		sde_rm_init_hw_iter(&iter, t->enc.base.id, type);
+		while (sde_rm_get_hw(&t->kms.rm, &iter)) {
+			hw = iter.hw;
+			blks->mask[type] |= BIT(hw->id);
+			blks->count[type]++;
+		}
+	}
+}
+
+static void test_check_blks(const struct test_blks *blks,
+		const struct sde_rm_topology_def *top,
+		const struct sde_mdss_cfg *cat)
+{
+	bool dsc = top->comp_type == MSM_DISPLAY_COMPRESSION_DSC;
+	bool vdc = top->comp_type == MSM_DISPLAY_COMPRESSION_VDC;
+
+	TEST_EXPECT_EQ(blks->count[SDE_HW_BLK_LM], top->num_lm);
+	TEST_EXPECT_EQ(blks->count[SDE_HW_BLK_PINGPONG], top->num_lm);
+	TEST_EXPECT(blks->count[SDE_HW_BLK_DSPP] <= top->num_lm);
+	TEST_EXPECT(blks->count[SDE_HW_BLK_DS] <= top->num_lm);
+	TEST_EXPECT_EQ(blks->count[SDE_HW_BLK_CTL], top->num_ctl);
+	TEST_EXPECT_EQ(blks->count[SDE_HW_BLK_INTF], top->num_intf);
+	TEST_EXPECT_EQ(blks->count[SDE_HW_BLK_DSC],
+			dsc ? top->num_comp_enc : 0);
+	TEST_EXPECT_EQ(blks->count[SDE_HW_BLK_VDC],
+			vdc ? top->num_comp_enc : 0);
+	TEST_EXPECT_EQ(blks->count[SDE_HW_BLK_QDSS], !!cat->qdss_count);
+	TEST_EXPECT_EQ(blks->count[SDE_HW_BLK_WB], 0);
+	TEST_EXPECT_EQ(blks->count[SDE_HW_BLK_CDM], 0);
+}
+
+/* nothing may stay reserved, and all of it must be available again */
+static void test_check_free(struct test_ctx *t)
+{
+	struct sde_rm *rm = &t->kms.rm;
+	struct msm_resource_caps_info avail_res;
+	enum sde_hw_blk_type type;
+
+	for (type = 0; type < SDE_HW_BLK_MAX; type++) {
+		TEST_EXPECT_EQ(rm->rsvp_mask[type], 0);
+		TEST_EXPECT_EQ(rm->rsvp_nxt_mask[type], 0);
+	}
+	TEST_EXPECT(list_empty(&rm->rsvps));
+
+	sde_rm_get_resource_info(rm, NULL, &avail_res);
+	TEST_EXPECT(!memcmp(&avail_res, &t->avail_res, sizeof(avail_res)));
+}
+
+/*
+ * Reserve a topology twice in a row. The second time is served from the
+ * cache of the last solution and has to come up with the same blocks.
+ */
+static void test_topology(struct test_ctx *t, const struct test_target *tgt,
+		const struct test_display *disp, u32 expected,
+		enum sde_rm_topology_name name)
+{
+	const struct sde_rm_topology_def *top = &t->kms.rm.topology_tbl[name];
+	struct test_blks blks[2];
+	u32 hits, pass;
+	int rc;
+
+	TEST_EXPECT_EQ(top->top_name, name);
+	test_set_hw_res(t, top, disp);
+
+	for (pass = 0; pass < 2; pass++) {
+		hits = t->kms.rm.cache_hits;
+		rc = test_reserve(t);
+
+		if (!!(expected & BIT(name)) != !rc)
+			fprintf(stderr, "%s %s: %s reserve %d\n", tgt->name,
+					disp->name, test_top_names[name], rc);
+
+		if (!(expected & BIT(name))) {
+			TEST_EXPECT(rc < 0);
+			test_check_free(t);
+			return;
+		}
+
+		TEST_EXPECT_EQ(rc, 0);
+		test_get_blks(t, &blks[pass]);
+		test_check_blks(&blks[pass], top, t->kms.catalog);
+
+		if (pass && blks[0].count[SDE_HW_BLK_LM]) {
+			TEST_EXPECT_EQ(t->kms.rm.cache_hits, hits + 1);
+			TEST_EXPECT(!memcmp(&blks[0], &blks[1],
+					sizeof(blks[0])));
+		}
+
+		sde_rm_release(&t->kms.rm, &t->enc, false);
+		test_check_free(t);
+	}
+}
+
+/*
+ * The cached solution of an encoder that moved from an external to the
+ * primary display must not be reused, the primary display has mixers of
+ * its own.
+ */
+static void test_display_type(struct test_ctx *t,
+		const struct test_target *tgt)
+{
+	const struct sde_rm_topology_def *top =
+		&t->kms.rm.topology_tbl[SDE_RM_TOPOLOGY_SINGLEPIPE];
+	struct test_display disp = test_dp;
+	u32 primary_lms = tgt->lm_primary << LM_0;
+	struct test_blks blks;
+
+	test_set_hw_res(t, top, &disp);
+	TEST_EXPECT_EQ(test_reserve(t), 0);
+	test_get_blks(t, &blks);
+	TEST_EXPECT(blks.mask[SDE_HW_BLK_LM] &&
+			!(blks.mask[SDE_HW_BLK_LM] & primary_lms));
+	sde_rm_release(&t->kms.rm, &t->enc, false);
+
+	disp.display_type = SDE_CONNECTOR_PRIMARY;
+	test_set_hw_res(t, top, &disp);
+	TEST_EXPECT_EQ(test_reserve(t), 0);
+	test_get_blks(t, &blks);
+	TEST_EXPECT(blks.mask[SDE_HW_BLK_LM] &&
+			!(blks.mask[SDE_HW_BLK_LM] & ~primary_lms));
+	sde_rm_release(&t->kms.rm, &t->enc, false);
+	test_check_free(t);
+}
+
+static void test_target(const struct test_target *tgt,
+		const struct test_display *disp, u32 expected)
+{
+	struct test_ctx *t;
+	u32 name;
+
+	t = test_ctx_new(tgt, disp);
+	TEST_EXPECT(t);
+	if (!t)
+		return;
+
+	TEST_EXPECT_EQ(t->avail_res.num_lm, tgt->num_lm);
+	TEST_EXPECT_EQ(t->avail_res.num_ctl, tgt->num_ctl);
+	TEST_EXPECT_EQ(t->avail_res.num_dsc, tgt->num_dsc);
+	TEST_EXPECT_EQ(t->avail_res.num_3dmux, tgt->num_lm / 2);
+	TEST_EXPECT_EQ(t->kms.rm.lm_max_width, TEST_LM_MAX_WIDTH);
+
+	for (name = SDE_RM_TOPOLOGY_NONE; name < SDE_RM_TOPOLOGY_MAX; name++)
+		test_topology(t, tgt, disp, expected, name);
+
+	if (disp == &test_dp)
+		test_display_type(t, tgt);
+
+	test_ctx_free(t);
+}
+
+/*
+ * Time an atomic check, its commit and the release of the reservation, the
+ * best of a few runs. With @miss the interface mode flips between video and
+ * command, which changes the cache key but not the search, so every
+ * reservation does the full search. Otherwise every one is a cache hit.
+ */
+static unsigned long long bench_run(struct test_ctx *t, u32 intf, bool miss)
+{
+	struct sde_encoder_hw_resources *hw_res = &sde_rm_test_hw_res;
+	unsigned long long t0, best = ~0ull;
+	u32 run, r, hits, misses;
+
+	for (run = 0; run < BENCH_RUNS; run++) {
+		hits = t->kms.rm.cache_hits;
+		misses = t->kms.rm.cache_misses;
+
+		t0 = test_now_ns();
+		for (r = 0; r < BENCH_ROUNDS; r++) {
+			/* alternate the mode so no round matches the last key */
+			if (miss)
+				hw_res->intfs[intf] = (r & 1) ?
+					INTF_MODE_VIDEO : INTF_MODE_CMD;
+			test_reserve(t);
+			sde_rm_release(&t->kms.rm, &t->enc, false);
+		}
+		best = min(best, test_now_ns() - t0);
+
+		TEST_EXPECT_EQ(miss ? t->kms.rm.cache_misses - misses :
+				t->kms.rm.cache_hits - hits, BENCH_ROUNDS);
+	}
+
+	return best;
+}
+
+static void bench_topology(struct test_ctx *t, const struct test_target *tgt,
+		enum sde_rm_topology_name name)
+{
+	const struct sde_rm_topology_def *top = &t->kms.rm.topology_tbl[name];
+	unsigned long long t_hit, t_miss;
+	u32 intf = test_dsi.intf[0] - INTF_0;
+
+	test_set_hw_res(t, top, &test_dsi);
+
+	/* warm the cache */
+	TEST_EXPECT_EQ(test_reserve(t), 0);
+	sde_rm_release(&t->kms.rm, &t->enc, false);
+
+	t_hit = bench_run(t, intf, false);
+	t_miss = bench_run(t, intf, true);
+	test_check_free(t);
+
+	printf("%-8s %-22s hit %5.0f ns, miss %5.0f ns per reserve/release\n",
+			tgt->name, test_top_names[name],
+			(double)t_hit / BENCH_ROUNDS,
+			(double)t_miss / BENCH_ROUNDS);
+}
+
+/* the single mixer topology and the largest one of the primary display */
+static void bench(const struct test_target *tgt)
+{
+	struct test_ctx *t;
+
+	t = test_ctx_new(tgt, &test_dsi);
+	TEST_EXPECT(t);
+	if (!t)
+		return;
+
+	bench_topology(t, tgt, SDE_RM_TOPOLOGY_SINGLEPIPE);
+	if (fls(tgt->dsi_tops) - 1 != SDE_RM_TOPOLOGY_SINGLEPIPE)
+		bench_topology(t, tgt, fls(tgt->dsi_tops) - 1);
+
+	test_ctx_free(t);
+}
+
+int main(int argc, char **argv)
+{
+	const struct test_target *tgt;
+	u32 i;
+
+	sde_host_verbose = argc > 1 && !strcmp(argv[1], "-v");
+
+	for (i = 0; i < ARRAY_SIZE(test_targets); i++) {
+		tgt = &test_targets[i];
+		test_target(tgt, &test_dsi, tgt->dsi_tops);
+		if (tgt->intf[0] == INTF_DP)
+			test_target(tgt, &test_dp, tgt->dp_tops);
+	}
+
+	if (!test_failures)
+		for (i = 0; i < ARRAY_SIZE(test_targets); i++)
+			bench(&test_targets[i]);
+
+	return test_report("sde_rm_test");
+}
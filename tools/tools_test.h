@@ -0,0 +1,55 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2021, The Linux Foundation. All rights reserved.
+ */
+
+#ifndef _TOOLS_TEST_H_
+#define _TOOLS_TEST_H_
+
+#include <stdio.h>
+#include <time.h>
+
+/* minimal checks shared by the host tests, failures are counted */
+static int test_failures;
+
+#define TEST_EXPECT(cond) \
+	do { \
+		if (!(cond)) { \
+			fprintf(stderr, "%s:%d: %s: expected %s\n", \
+					__FILE__, __LINE__, __func__, #cond); \
+			test_failures++; \
+		} \
+	} while (0)
+
+#define TEST_EXPECT_EQ(a, b) \
+	do { \
+		long long _a = (long long)(a), _b = (long long)(b); \
+		if (_a != _b) { \
+			fprintf(stderr, "%s:%d: %s: %s == %lld, expected %lld\n", \
+					__FILE__, __LINE__, __func__, #a, \
+					_a, _b); \
+			test_failures++; \
+		} \
+	} while (0)
+
+static inline int test_report(const char *name)
+{
+	if (test_failures) {
+		fprintf(stderr, "%s: %d check(s) failed\n", name,
+				test_failures);
+		return 1;
+	}
+
+	printf("%s: ok\n", name);
+	return 0;
+}
+
+static inline unsigned long long test_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+#endif /* _TOOLS_TEST_H_ */